@@ -0,0 +1,26 @@
+import random
+
+num_points = 100000
+max_coord = 65535 # Morton keys hold 16 bits per axis.
+num_clusters = 5
+cluster_spread = 2000
+
+random.seed(92)
+centers = [(random.randrange(max_coord + 1), random.randrange(max_coord + 1)) for _ in range(num_clusters)]
+
+# 70% of the points are uniform over the plane, 30% are spread around a few cluster centers.
+points = []
+for i in range(num_points):
+    if i % 10 < 7:
+        x, y = random.randrange(max_coord + 1), random.randrange(max_coord + 1)
+    else:
+        cx, cy = centers[i % num_clusters]
+        x = min(max_coord, max(0, int(random.gauss(cx, cluster_spread))))
+        y = min(max_coord, max(0, int(random.gauss(cy, cluster_spread))))
+    points.append((x, y))
+
+# This tells the script to go up one directory from 'scripts/'
+# and then look for the 'data/' folder.
+with open("../data/data_points_100k.txt", "w") as f:
+    for x, y in points:
+        f.write(str(x) + " " + str(y) + "\n")
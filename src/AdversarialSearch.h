@@ -0,0 +1,308 @@
+#ifndef ADVERSARIAL_SEARCH_H
+#define ADVERSARIAL_SEARCH_H
+
+#include "CacheSimulator.h" // For TracedSearcher, which counts the array reads of one lookup.
+#include "SearchIndex.h"    // For timing any registered index under the latency objective.
+#include <vector>
+#include <string>
+#include <cmath>
+#include <climits>
+#include <random>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <memory>
+#include <utility>
+#include <cstdio> // For std::snprintf in DatasetShape::describe.
+
+/*
+Adversarial worst-case finder: looks for a dataset and query set that make one search
+algorithm as slow as possible.
+
+    - Candidate datasets come from DatasetShape, a handful of distribution parameters (growth
+      curve, clustered keys, outliers at the top, key range). A hill climber perturbs one
+      parameter at a time and keeps the change whenever the score goes up, restarting from a
+      random shape when it stalls.
+    - Targeted constructions are scored too, such as exponential key growth or a single huge
+      outlier, which are known to defeat interpolation.
+    - For each dataset the query set is the worst WORST_QUERIES of a larger random sample of
+      hits and misses.
+
+The score is either the mean number of array reads per query ("probes", exact and repeatable;
+needs an algorithm TracedSearcher instruments) or the measured ns per lookup ("latency", works
+for every registered index). The winner is saved as data/data_adversarial_<algorithm>.txt plus
+data/data_adversarial_<algorithm>_queries.txt, which the default benchmark sweep picks up.
+*/
+
+namespace ProjectUtils {
+
+    // Number of worst queries kept per dataset, out of ADVERSARIAL_QUERY_SAMPLE candidates.
+    const size_t WORST_QUERIES = 500;
+    const size_t ADVERSARIAL_QUERY_SAMPLE = 4000;
+
+    /**
+     * @brief Parameters of a generated key distribution, each kept within its documented range.
+     */
+    struct DatasetShape {
+        double growth = 1.0;           // Key i is about range * (i / n)^growth; 1 is uniform. [0.05, 24]
+        double cluster_fraction = 0.0; // Share of keys packed into one dense run. [0, 0.95]
+        double cluster_position = 0.5; // Where that run starts, as a fraction of the range. [0, 1]
+        double outlier_fraction = 0.0; // Share of keys pushed to the very top of the int range. [0, 0.5]
+        double range_bits = 30.0;      // log2 of the key range of the main body. [17, 31]
+
+        std::string describe() const {
+            char text[160];
+            std::snprintf(text, sizeof(text), "growth=%.2f cluster=%.2f@%.2f outliers=%.3f range=2^%.1f",
+                growth, cluster_fraction, cluster_position, outlier_fraction, range_bits);
+            return text;
+        }
+    };
+
+    /**
+     * @brief Generates a sorted, de-duplicated dataset of about 'n' keys with the given shape.
+     */
+    inline std::vector<int> generateShapedDataset(const DatasetShape& shape, int n, unsigned seed) {
+        std::mt19937 rng(seed);
+        std::vector<int> keys;
+        keys.reserve(n);
+        double range = std::pow(2.0, shape.range_bits) - 1.0;
+        int outliers = static_cast<int>(n * shape.outlier_fraction);
+        int clustered = static_cast<int>(n * shape.cluster_fraction);
+        int body = std::max(1, n - outliers - clustered);
+
+        for (int i = 0; i < body; ++i) {
+            double u = body > 1 ? static_cast<double>(i) / (body - 1) : 0.0;
+            keys.push_back(static_cast<int>(std::pow(u, shape.growth) * range));
+        }
+        long long cluster_start = static_cast<long long>(shape.cluster_position * range);
+        for (int i = 0; i < clustered; ++i) {
+            keys.push_back(static_cast<int>(std::min<long long>(INT_MAX, cluster_start + i)));
+        }
+        std::uniform_int_distribution<int> spread(0, 1 << 20);
+        for (int i = 0; i < outliers; ++i) {
+            keys.push_back(INT_MAX - spread(rng));
+        }
+        std::sort(keys.begin(), keys.end());
+        keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+        return keys;
+    }
+
+    /**
+     * @brief Hand-built datasets known to be hard for some algorithm, with their names.
+     */
+    inline std::vector<std::pair<std::string, std::vector<int>>> adversarialConstructions(int n) {
+        std::vector<std::pair<std::string, std::vector<int>>> cases;
+        std::vector<int> keys(n);
+
+        // Exponential growth: interpolation's straight-line guess lands far below the target.
+        double rate = std::log(static_cast<double>(INT_MAX - n)) / n;
+        for (int i = 0; i < n; ++i) keys[i] = static_cast<int>(std::exp(rate * i)) + i;
+        cases.push_back(std::make_pair("exponential-growth", keys));
+
+        // One huge outlier: every other key is squeezed into the first slot of the interpolation.
+        for (int i = 0; i < n - 1; ++i) keys[i] = i;
+        keys[n - 1] = INT_MAX;
+        cases.push_back(std::make_pair("single-outlier", keys));
+
+        // Quadratic growth: a milder skew that still bends the line.
+        double scale = static_cast<double>(INT_MAX - n) / (static_cast<double>(n) * n);
+        for (int i = 0; i < n; ++i) keys[i] = static_cast<int>(scale * i * i) + i;
+        cases.push_back(std::make_pair("quadratic-growth", keys));
+
+        // Dense then sparse: half the keys in a tight run, half spread over the rest of the range.
+        for (int i = 0; i < n / 2; ++i) keys[i] = i;
+        for (int i = n / 2; i < n; ++i) keys[i] = static_cast<int>(static_cast<double>(INT_MAX - 1) * (i - n / 2 + 1) / (n - n / 2));
+        cases.push_back(std::make_pair("dense-then-sparse", keys));
+
+        for (int i = 0; i < n; ++i) keys[i] = static_cast<int>(static_cast<long long>(i) * 20000);
+        cases.push_back(std::make_pair("uniform", keys));
+        return cases;
+    }
+
+    // A dataset, its worst queries and their score.
+    struct AdversarialCase {
+        std::string description;
+        std::vector<int> data;
+        std::vector<int> queries;
+        double score = 0.0;
+    };
+
+    /**
+     * @brief Scores datasets for one algorithm and keeps the worst queries for each.
+     */
+    class AdversarialEvaluator {
+    public:
+        /**
+         * @brief Check valid() afterwards: the algorithm may be unknown or not instrumented for probes.
+         *
+         * @param algorithm A registered SearchIndex name.
+         * @param use_latency Score by measured ns per lookup instead of array reads per query.
+         */
+        AdversarialEvaluator(const std::string& algorithm, bool use_latency) : algorithm(algorithm), use_latency(use_latency), ok(true) {
+            std::vector<std::string> names = registeredSearchIndexNames();
+            if (std::find(names.begin(), names.end(), algorithm) == names.end()) {
+                std::cerr << "Error: Unknown search algorithm '" << algorithm << "'.\n";
+                ok = false;
+            }
+            else if (!use_latency) {
+                std::vector<std::string> traced = TracedSearcher::algorithmNames();
+                if (std::find(traced.begin(), traced.end(), algorithm) == traced.end()) {
+                    std::cerr << "Error: '" << algorithm << "' is not instrumented for probe counting; use the latency objective.\n";
+                    ok = false;
+                }
+            }
+        }
+
+        bool valid() const { return ok; }
+
+        /**
+         * @brief Picks the worst queries for 'data' and scores the dataset.
+         */
+        AdversarialCase evaluate(const std::string& description, std::vector<int> data, unsigned seed) const {
+            AdversarialCase result;
+            result.description = description;
+            result.data = std::move(data);
+            if (result.data.empty()) return result;
+
+            std::mt19937 rng(seed);
+            std::uniform_int_distribution<size_t> pick(0, result.data.size() - 1);
+            std::uniform_int_distribution<int> value(result.data.front(), result.data.back());
+            std::vector<int> sample;
+            for (size_t i = 0; i < ADVERSARIAL_QUERY_SAMPLE; ++i) {
+                sample.push_back(i % 2 == 0 ? result.data[pick(rng)] : value(rng));
+            }
+
+            // Rank the sample by probes when the algorithm is traced, otherwise by time per query.
+            std::vector<std::pair<double, int>> costs;
+            TracedSearcher searcher;
+            std::unique_ptr<SearchIndex> index = createSearchIndex(algorithm);
+            index->build(result.data);
+            if (searcher.build(algorithm, result.data)) {
+                AccessTrace trace;
+                for (int target : sample) {
+                    trace.clear();
+                    searcher.search(target, trace);
+                    costs.push_back(std::make_pair(static_cast<double>(trace.addresses.size()), target));
+                }
+            }
+            else {
+                for (int target : sample) costs.push_back(std::make_pair(timeLookups(*index, std::vector<int>(8, target)), target));
+            }
+            std::sort(costs.begin(), costs.end(), [](const std::pair<double, int>& a, const std::pair<double, int>& b) { return a.first > b.first; });
+            double probe_sum = 0.0;
+            for (size_t i = 0; i < std::min(WORST_QUERIES, costs.size()); ++i) {
+                result.queries.push_back(costs[i].second);
+                probe_sum += costs[i].first;
+            }
+            result.score = use_latency ? timeLookups(*index, result.queries) : probe_sum / result.queries.size();
+            return result;
+        }
+
+    private:
+        // Best of three timed passes over 'queries', in ns per lookup.
+        static double timeLookups(const SearchIndex& index, const std::vector<int>& queries) {
+            double best = 0.0;
+            volatile int sink = 0;
+            for (int pass = 0; pass < 3; ++pass) {
+                auto start = std::chrono::high_resolution_clock::now();
+                for (int target : queries) sink = sink + index.search(target);
+                auto end = std::chrono::high_resolution_clock::now();
+                double ns = std::chrono::duration<double, std::nano>(end - start).count() / queries.size();
+                if (pass == 0 || ns < best) best = ns;
+            }
+            return best;
+        }
+
+        std::string algorithm;
+        bool use_latency;
+        bool ok;
+    };
+
+    namespace detail {
+        // Moves one randomly chosen parameter of 'shape' by a random step, staying in range.
+        inline DatasetShape perturbShape(DatasetShape shape, std::mt19937& rng) {
+            std::normal_distribution<double> step(0.0, 1.0);
+            switch (std::uniform_int_distribution<int>(0, 4)(rng)) {
+            case 0: shape.growth = std::min(24.0, std::max(0.05, shape.growth * std::exp(0.5 * step(rng)))); break;
+            case 1: shape.cluster_fraction = std::min(0.95, std::max(0.0, shape.cluster_fraction + 0.15 * step(rng))); break;
+            case 2: shape.cluster_position = std::min(1.0, std::max(0.0, shape.cluster_position + 0.2 * step(rng))); break;
+            case 3: shape.outlier_fraction = std::min(0.5, std::max(0.0, shape.outlier_fraction + 0.05 * step(rng))); break;
+            default: shape.range_bits = std::min(31.0, std::max(17.0, shape.range_bits + 2.0 * step(rng))); break;
+            }
+            return shape;
+        }
+
+        inline DatasetShape randomShape(std::mt19937& rng) {
+            DatasetShape shape;
+            shape.growth = std::exp(std::uniform_real_distribution<double>(std::log(0.05), std::log(24.0))(rng));
+            shape.cluster_fraction = std::uniform_real_distribution<double>(0.0, 0.95)(rng);
+            shape.cluster_position = std::uniform_real_distribution<double>(0.0, 1.0)(rng);
+            shape.outlier_fraction = std::uniform_real_distribution<double>(0.0, 0.5)(rng);
+            shape.range_bits = std::uniform_real_distribution<double>(17.0, 31.0)(rng);
+            return shape;
+        }
+    }
+
+    /**
+     * @brief Searches for the dataset and queries that maximize the algorithm's cost.
+     *
+     * @param evaluator Scores candidates; must be valid().
+     * @param n Keys per generated dataset.
+     * @param iterations Hill-climbing steps after the constructions have been scored.
+     * @param seed Seed for the climber, so runs are reproducible.
+     * @param out Progress is reported here whenever a new worst case is found.
+     * @return The worst case found.
+     */
+    inline AdversarialCase findAdversarialCase(const AdversarialEvaluator& evaluator, int n, int iterations, unsigned seed, std::ostream& out) {
+        std::mt19937 rng(seed);
+        AdversarialCase worst;
+        auto consider = [&](AdversarialCase candidate) {
+            if (candidate.score <= worst.score) return false;
+            out << "  new worst: " << std::fixed << std::setprecision(1) << candidate.score << "  " << candidate.description << "\n";
+            worst = std::move(candidate);
+            return true;
+        };
+
+        for (auto& construction : adversarialConstructions(n)) {
+            consider(evaluator.evaluate(construction.first, std::move(construction.second), rng()));
+        }
+
+        // Hill climbing over DatasetShape, restarting from a random shape after STALL_LIMIT failures.
+        const int STALL_LIMIT = 20;
+        DatasetShape current;
+        double current_score = evaluator.evaluate(current.describe(), generateShapedDataset(current, n, seed), rng()).score;
+        int stalled = 0;
+        for (int i = 0; i < iterations; ++i) {
+            DatasetShape next = stalled >= STALL_LIMIT ? detail::randomShape(rng) : detail::perturbShape(current, rng);
+            AdversarialCase candidate = evaluator.evaluate(next.describe(), generateShapedDataset(next, n, seed), rng());
+            if (candidate.score > current_score || stalled >= STALL_LIMIT) {
+                current = next;
+                current_score = candidate.score;
+                stalled = 0;
+            }
+            else {
+                ++stalled;
+            }
+            consider(std::move(candidate));
+        }
+        return worst;
+    }
+
+    /**
+     * @brief Writes one integer per line, the format loadAndSortDatasetFromFile reads.
+     */
+    inline bool writeDatasetFile(const std::vector<int>& values, const std::string& filename) {
+        std::ofstream file(filename);
+        if (!file.is_open()) {
+            std::cerr << "Error: Could not open file '" << filename << "' for writing.\n";
+            return false;
+        }
+        for (int value : values) file << value << "\n";
+        return static_cast<bool>(file);
+    }
+
+} // namespace ProjectUtils
+
+#endif // ADVERSARIAL_SEARCH_H
@@ -0,0 +1,251 @@
+#ifndef APPROXIMATE_SUMMARY_H
+#define APPROXIMATE_SUMMARY_H
+
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <climits>
+#include <random>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+
+/*
+Approximate query mode: an equi-depth histogram built at load time that answers rank,
+range-count and quantile queries with a guaranteed error bound.
+
+Every `depth` keys one boundary key is kept (boundaries[j] = sorted[j * depth]), so with unique
+keys the true rank of any value between two neighbouring boundaries lies in a known interval
+of width `depth`. Choosing depth = relative_error * n makes the summary as small as the error
+allows: 0.1% needs 1000 boundaries whether the dataset has a hundred thousand or a billion
+keys. A query binary searches those boundaries, so its cost depends on the error target, not
+on the dataset size.
+
+Each approximate answer comes with the interval the exact answer is guaranteed to lie in. The
+exact* functions fall back to a search over the full dataset for callers that need the real value.
+*/
+
+namespace ProjectUtils {
+
+    /**
+     * @brief An estimate together with the range the exact answer is guaranteed to be in.
+     */
+    struct ApproximateAnswer {
+        double estimate = 0.0;
+        long long lower = 0;
+        long long upper = 0;
+
+        // Largest possible distance between the estimate and the exact answer.
+        double errorBound() const { return std::max(estimate - lower, upper - estimate); }
+    };
+
+    /**
+     * @brief Equi-depth histogram over a sorted, de-duplicated dataset.
+     */
+    class ApproximateSummary {
+    public:
+        ApproximateSummary() : data(nullptr), depth(1), num_keys(0) {}
+
+        /**
+         * @brief Builds the summary.
+         *
+         * @param sorted The sorted, de-duplicated dataset; it must outlive the summary (for the exact fallback).
+         * @param relative_error Allowed rank error as a fraction of the dataset size, e.g. 0.001 for 0.1%.
+         */
+        void build(const std::vector<int>& sorted, double relative_error = 0.001) {
+            data = &sorted;
+            num_keys = static_cast<long long>(sorted.size());
+            depth = std::max(1LL, static_cast<long long>(relative_error * num_keys));
+            boundaries.clear();
+            for (long long i = 0; i < num_keys; i += depth) boundaries.push_back(sorted[static_cast<size_t>(i)]);
+        }
+
+        /**
+         * @brief Approximate number of keys smaller than 'key'.
+         */
+        ApproximateAnswer rank(int key) const {
+            ApproximateAnswer answer;
+            if (boundaries.empty() || key <= boundaries.front()) return answer; // Exact: nothing is smaller.
+            // j is the last boundary below 'key', so ranks j*depth+1 .. min(next boundary rank, n) are possible.
+            long long j = static_cast<long long>(std::lower_bound(boundaries.begin(), boundaries.end(), key) - boundaries.begin()) - 1;
+            answer.lower = j * depth + 1;
+            answer.upper = std::min((j + 1) * depth, num_keys);
+            // Interpolate between the boundary keys when there is a next one, otherwise take the middle.
+            if (j + 1 < static_cast<long long>(boundaries.size())) {
+                double fraction = (static_cast<double>(key) - boundaries[j]) / (static_cast<double>(boundaries[j + 1]) - boundaries[j]);
+                answer.estimate = answer.lower + fraction * (answer.upper - answer.lower);
+            }
+            else {
+                answer.estimate = (answer.lower + answer.upper) / 2.0;
+            }
+            return answer;
+        }
+
+        /**
+         * @brief Approximate number of keys in [lo, hi].
+         */
+        ApproximateAnswer rangeCount(int lo, int hi) const {
+            ApproximateAnswer answer;
+            if (lo > hi) return answer;
+            ApproximateAnswer below_lo = rank(lo);
+            ApproximateAnswer up_to_hi = hi == INT_MAX ? exactCountAnswer(num_keys) : rank(hi + 1);
+            answer.estimate = std::max(0.0, up_to_hi.estimate - below_lo.estimate);
+            answer.lower = std::max(0LL, up_to_hi.lower - below_lo.upper);
+            answer.upper = up_to_hi.upper - below_lo.lower;
+            return answer;
+        }
+
+        /**
+         * @brief A key whose rank is within 'rank_error' of q * n.
+         *
+         * @param q Quantile in [0, 1].
+         * @param rank_error Receives the largest possible rank difference (always less than the bucket depth).
+         * @return A key of the dataset; INT_MIN if the dataset is empty.
+         */
+        int quantile(double q, long long& rank_error) const {
+            rank_error = 0;
+            if (boundaries.empty()) return INT_MIN;
+            long long target = quantileRank(q);
+            long long j = target / depth;
+            rank_error = target - j * depth;
+            return boundaries[static_cast<size_t>(j)];
+        }
+
+        // Exact answers through a binary search of the full dataset.
+        long long exactRank(int key) const {
+            return static_cast<long long>(std::lower_bound(data->begin(), data->end(), key) - data->begin());
+        }
+
+        long long exactRangeCount(int lo, int hi) const {
+            if (lo > hi) return 0;
+            return static_cast<long long>(std::upper_bound(data->begin(), data->end(), hi) - data->begin()) - exactRank(lo);
+        }
+
+        int exactQuantile(double q) const {
+            return data->empty() ? INT_MIN : (*data)[static_cast<size_t>(quantileRank(q))];
+        }
+
+        long long bucketDepth() const { return depth; }
+        size_t bucketCount() const { return boundaries.size(); }
+
+        // Bytes held by the summary (the boundary keys).
+        size_t memoryBytes() const { return boundaries.capacity() * sizeof(int); }
+
+    private:
+        long long quantileRank(double q) const {
+            q = std::min(1.0, std::max(0.0, q));
+            return std::min(num_keys - 1, static_cast<long long>(q * num_keys));
+        }
+
+        static ApproximateAnswer exactCountAnswer(long long count) {
+            ApproximateAnswer answer;
+            answer.estimate = static_cast<double>(count);
+            answer.lower = answer.upper = count;
+            return answer;
+        }
+
+        const std::vector<int>* data;
+        long long depth;
+        long long num_keys;
+        std::vector<int> boundaries;
+    };
+
+    /**
+     * @brief Builds a summary, checks random rank, range-count and quantile queries against the
+     *        exact answers, and prints the observed error, the guaranteed bound and the timings.
+     *
+     * @param sorted The sorted, de-duplicated dataset.
+     * @param relative_error Allowed rank error as a fraction of the dataset size.
+     * @param num_queries Number of queries of each kind.
+     */
+    inline void runApproximateQueryReport(const std::vector<int>& sorted, double relative_error, size_t num_queries, std::ostream& out) {
+        if (sorted.empty()) {
+            out << "Dataset is empty; nothing to summarize.\n";
+            return;
+        }
+        typedef std::chrono::high_resolution_clock Clock;
+        ApproximateSummary summary;
+        auto start = Clock::now();
+        summary.build(sorted, relative_error);
+        auto end = Clock::now();
+        out << "Summary: " << summary.bucketCount() << " buckets of " << summary.bucketDepth() << " keys, "
+            << summary.memoryBytes() << " bytes, built in " << std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() << " us\n";
+
+        std::mt19937 rng(2025);
+        std::uniform_int_distribution<int> value(sorted.front(), sorted.back());
+        std::uniform_real_distribution<double> fraction(0.0, 1.0);
+        std::vector<int> keys(num_queries), other(num_queries);
+        std::vector<double> quantiles(num_queries);
+        for (size_t i = 0; i < num_queries; ++i) {
+            keys[i] = value(rng);
+            other[i] = value(rng);
+            if (other[i] < keys[i]) std::swap(keys[i], other[i]);
+            quantiles[i] = fraction(rng);
+        }
+
+        out << std::left << std::setw(14) << "Query" << std::right << std::setw(14) << "Approx ns" << std::setw(12) << "Exact ns"
+            << std::setw(14) << "Max error" << std::setw(14) << "Bound" << "  Within\n";
+        auto report = [&](const char* name, double approx_ns, double exact_ns, double max_error, double bound, bool within) {
+            out << std::left << std::setw(14) << name << std::right << std::fixed << std::setprecision(1) << std::setw(14) << approx_ns
+                << std::setw(12) << exact_ns << std::setw(14) << max_error << std::setw(14) << bound << "  " << (within ? "yes" : "NO") << "\n";
+        };
+        auto nsPerQuery = [&](Clock::time_point a, Clock::time_point b) {
+            return std::chrono::duration<double, std::nano>(b - a).count() / num_queries;
+        };
+
+        // Rank.
+        std::vector<ApproximateAnswer> answers(num_queries);
+        std::vector<long long> exact(num_queries);
+        auto t0 = Clock::now();
+        for (size_t i = 0; i < num_queries; ++i) answers[i] = summary.rank(keys[i]);
+        auto t1 = Clock::now();
+        for (size_t i = 0; i < num_queries; ++i) exact[i] = summary.exactRank(keys[i]);
+        auto t2 = Clock::now();
+        double max_error = 0.0, bound = 0.0;
+        bool within = true;
+        for (size_t i = 0; i < num_queries; ++i) {
+            max_error = std::max(max_error, std::abs(answers[i].estimate - exact[i]));
+            bound = std::max(bound, answers[i].errorBound());
+            within = within && exact[i] >= answers[i].lower && exact[i] <= answers[i].upper;
+        }
+        report("rank", nsPerQuery(t0, t1), nsPerQuery(t1, t2), max_error, bound, within);
+
+        // Range count.
+        t0 = Clock::now();
+        for (size_t i = 0; i < num_queries; ++i) answers[i] = summary.rangeCount(keys[i], other[i]);
+        t1 = Clock::now();
+        for (size_t i = 0; i < num_queries; ++i) exact[i] = summary.exactRangeCount(keys[i], other[i]);
+        t2 = Clock::now();
+        max_error = bound = 0.0;
+        within = true;
+        for (size_t i = 0; i < num_queries; ++i) {
+            max_error = std::max(max_error, std::abs(answers[i].estimate - exact[i]));
+            bound = std::max(bound, answers[i].errorBound());
+            within = within && exact[i] >= answers[i].lower && exact[i] <= answers[i].upper;
+        }
+        report("range count", nsPerQuery(t0, t1), nsPerQuery(t1, t2), max_error, bound, within);
+
+        // Quantile: compare ranks of the returned keys.
+        std::vector<int> approx_keys(num_queries), exact_keys(num_queries);
+        std::vector<long long> rank_errors(num_queries);
+        t0 = Clock::now();
+        for (size_t i = 0; i < num_queries; ++i) approx_keys[i] = summary.quantile(quantiles[i], rank_errors[i]);
+        t1 = Clock::now();
+        for (size_t i = 0; i < num_queries; ++i) exact_keys[i] = summary.exactQuantile(quantiles[i]);
+        t2 = Clock::now();
+        max_error = bound = 0.0;
+        within = true;
+        for (size_t i = 0; i < num_queries; ++i) {
+            double error = static_cast<double>(summary.exactRank(exact_keys[i]) - summary.exactRank(approx_keys[i]));
+            max_error = std::max(max_error, std::abs(error));
+            bound = std::max(bound, static_cast<double>(rank_errors[i]));
+            within = within && std::abs(error) <= rank_errors[i];
+        }
+        report("quantile", nsPerQuery(t0, t1), nsPerQuery(t1, t2), max_error, bound, within);
+        out << "Errors are in ranks (keys); the guaranteed bound is at most " << summary.bucketDepth() << " ("
+            << relative_error * 100.0 << "% of " << sorted.size() << " keys) per rank.\n";
+    }
+
+} // namespace ProjectUtils
+
+#endif // APPROXIMATE_SUMMARY_H
@@ -0,0 +1,526 @@
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+#include "SearchIndex.h" // For the registered search indexes.
+#include "MeteredSearchIndex.h" // For timing lookups through the same metered path serve mode uses.
+#include "SimdSearch.h"  // For the lane-per-query batch engines.
+#include "LearnedIndex.h" // For the updatable learned index in the update benchmark.
+#include "HotKeyCache.h"  // For the hot-key cache benchmark.
+#include "RangeFilter.h"  // For the range emptiness filter benchmark.
+#include "SmallSearch.h"  // For the lower bound that answers a range query without the filter.
+#include "MachineProfile.h" // For the latency and bandwidth ceilings the results are normalized by.
+#include <vector>
+#include <string>
+#include <random>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <iterator> // For std::back_inserter.
+#include <climits>
+#include <utility>
+#include <cmath> // For std::pow in the Zipf generator.
+
+/*
+Benchmark harness that runs the same query set through every search algorithm.
+
+Unlike the NUM_RUNS loop in main.cpp, which repeats one target, the suite draws a large set
+of targets (half present in the dataset, half random values in its range) so cache misses and
+branch mispredictions show up the way they do under real traffic. Every algorithm's answers
+are checked against binary search over the sorted dataset.
+
+Rows:
+    - every name in registeredSearchIndexNames(), one lookup at a time through a
+      MeteredSearchIndex, so the times include the always-on metrics serve mode pays and the
+      lookups are recorded in MetricsRegistry::global(),
+    - the batch engines from SimdSearch.h, which process the whole query set at once.
+Besides ns per lookup, the table gives each row in dependent DRAM misses and as a percentage
+of the bandwidth ceiling of this host (see MachineProfile.h), so results from different
+machines can be compared.
+
+`runUpdateBenchmark` is separate: it interleaves inserts and deletes with lookups and range
+scans, and compares the updatable learned index against the immutable sorted vector, which has
+to be fully re-sorted ("reloaded") after every round of updates before it can be queried again.
+
+`runHotCacheBenchmark` replays a Zipf-distributed query stream through every algorithm with and
+without a HotKeyCache in front of it, both metered the same way.
+
+`runRangeFilterBenchmark` times range-emptiness queries with and without the RangeFilter in
+front of the search, and reports the filter's memory and the range false-positive rate it
+achieved next to the target. Widths at which the filter followed by the search is slower than
+the search alone are flagged, and so is a memory cap too small for the target.
+*/
+
+namespace ProjectUtils {
+
+    // One row of the benchmark report.
+    struct BenchmarkResult {
+        std::string name;
+        double ns_per_lookup = 0.0;
+        size_t hits = 0;
+        bool correct = true; // All answers matched the reference binary search.
+    };
+
+    /**
+     * @brief Builds a reproducible Zipf-distributed query set over the keys of the dataset.
+     *
+     * The key of popularity rank r is requested with probability proportional to 1 / r^skew.
+     * Ranks are assigned to keys in random order, so hot keys are spread over the whole dataset.
+     */
+    inline std::vector<int> makeZipfQueries(const std::vector<int>& sorted, size_t count, double skew, unsigned seed = 2025) {
+        std::vector<int> queries;
+        if (sorted.empty()) return queries;
+        std::mt19937 rng(seed);
+        std::vector<int> by_rank = sorted;
+        std::shuffle(by_rank.begin(), by_rank.end(), rng);
+        std::vector<double> cumulative(by_rank.size());
+        double total = 0.0;
+        for (size_t r = 0; r < by_rank.size(); ++r) {
+            total += 1.0 / std::pow(static_cast<double>(r + 1), skew);
+            cumulative[r] = total;
+        }
+        std::uniform_real_distribution<double> draw(0.0, total);
+        queries.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            size_t r = std::lower_bound(cumulative.begin(), cumulative.end(), draw(rng)) - cumulative.begin();
+            queries.push_back(by_rank[std::min(r, by_rank.size() - 1)]);
+        }
+        return queries;
+    }
+
+    namespace detail {
+        inline BenchmarkResult summarizeBenchmark(const std::string& name, double total_ns, const std::vector<int>& results,
+            const std::vector<int>& reference) {
+            BenchmarkResult row;
+            row.name = name;
+            row.ns_per_lookup = results.empty() ? 0.0 : total_ns / results.size();
+            for (size_t i = 0; i < results.size(); ++i) {
+                if (results[i] != -1) ++row.hits;
+                if (results[i] != reference[i]) row.correct = false;
+            }
+            return row;
+        }
+    }
+
+    /**
+     * @brief Times one-at-a-time lookups through a SearchIndex.
+     */
+    inline BenchmarkResult benchmarkIndex(const SearchIndex& index, const std::vector<int>& queries, const std::vector<int>& reference) {
+        std::vector<int> results(queries.size());
+        auto start = std::chrono::high_resolution_clock::now();
+        for (size_t i = 0; i < queries.size(); ++i) results[i] = index.search(queries[i]);
+        auto end = std::chrono::high_resolution_clock::now();
+        return detail::summarizeBenchmark(index.name(), static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()),
+            results, reference);
+    }
+
+    /**
+     * @brief Times a batch engine such as `batchBinarySearch` over the whole query set.
+     *
+     * @tparam BatchFunc Callable as func(sorted, queries, results).
+     */
+    template<typename BatchFunc>
+    BenchmarkResult benchmarkBatch(const std::string& name, BatchFunc batch_func, const std::vector<int>& sorted,
+        const std::vector<int>& queries, const std::vector<int>& reference) {
+        std::vector<int> results;
+        auto start = std::chrono::high_resolution_clock::now();
+        batch_func(sorted, queries, results);
+        auto end = std::chrono::high_resolution_clock::now();
+        return detail::summarizeBenchmark(name, static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()),
+            results, reference);
+    }
+
+    /**
+     * @brief Prints benchmark rows as a table, normalized by the given machine profile.
+     */
+    inline void printBenchmarkTable(const std::vector<BenchmarkResult>& rows, const MachineProfile& profile, std::ostream& out) {
+        out << std::left << std::setw(26) << "Algorithm" << std::right << std::setw(12) << "ns/lookup" << std::setw(15) << "misses/lookup"
+            << std::setw(11) << "% BW ceil" << std::setw(10) << "Hits" << "  Correct\n";
+        for (const BenchmarkResult& row : rows) {
+            out << std::left << std::setw(26) << row.name << std::right << std::setw(12) << std::fixed << std::setprecision(1)
+                << row.ns_per_lookup << std::setw(15) << std::setprecision(2) << profile.missesPerLookup(row.ns_per_lookup) << std::setw(11)
+                << std::setprecision(1) << profile.percentOfBandwidthCeiling(row.ns_per_lookup) << std::setw(10) << row.hits << "  "
+                << (row.correct ? "yes" : "NO") << "\n";
+        }
+    }
+
+    /**
+     * @brief Prints benchmark rows as a table, normalized by this host's profile (measured on first use).
+     */
+    inline void printBenchmarkTable(const std::vector<BenchmarkResult>& rows, std::ostream& out) {
+        printBenchmarkTable(rows, machineProfile(), out);
+    }
+
+    /**
+     * @brief Runs every algorithm over the given query set and returns one row per algorithm.
+     *
+     * @param sorted The sorted, de-duplicated dataset.
+     * @param queries The lookups to time, e.g. from makeBenchmarkQueries or a saved adversarial query file.
+     */
+    inline std::vector<BenchmarkResult> runBenchmarkSuite(const std::vector<int>& sorted, const std::vector<int>& queries) {
+        std::vector<BenchmarkResult> rows;
+        if (sorted.empty() || queries.empty()) return rows;
+
+        SortedArrayIndex reference_index;
+        reference_index.build(sorted);
+        std::vector<int> reference(queries.size());
+        for (size_t i = 0; i < queries.size(); ++i) reference[i] = reference_index.search(queries[i]);
+
+        for (const std::string& name : registeredSearchIndexNames()) {
+            std::unique_ptr<SearchIndex> index = createMeteredSearchIndex(name);
+            index->build(sorted);
+            rows.push_back(benchmarkIndex(*index, queries, reference));
+        }
+        rows.push_back(benchmarkBatch("batch-binary (lanes)", batchBinarySearch, sorted, queries, reference));
+        rows.push_back(benchmarkBatch("batch-interpolation (lanes)", batchInterpolationSearch, sorted, queries, reference));
+        return rows;
+    }
+
+    /**
+     * @brief Runs every algorithm over 'num_queries' generated lookups (half hits, half misses).
+     */
+    inline std::vector<BenchmarkResult> runBenchmarkSuite(const std::vector<int>& sorted, size_t num_queries = 200000) {
+        return runBenchmarkSuite(sorted, makeBenchmarkQueries(sorted, num_queries));
+    }
+
+    /**
+     * @brief Data files run by "Main bench" when no files are given.
+     *
+     * The adversarial files are the worst cases saved by "Main adversarial"; each has a
+     * companion "<name>_queries.txt" with the lookups that hurt most.
+     */
+    inline std::vector<std::string> benchmarkSweepFiles() {
+        return { "data/data_100k_random.txt", "data/data_100k_sorted_asc.txt", "data/data_100k_sparse.txt",
+            "data/data_negative_numbers.txt", "data/data_adversarial_jump.txt", "data/data_adversarial_interpolation.txt",
+            "data/data_adversarial_kary-interpolation.txt", "data/data_adversarial_linear-model.txt" };
+    }
+
+    // One row of the update benchmark report.
+    struct UpdateBenchmarkResult {
+        std::string name;
+        double ns_per_update = 0.0; // Including any rebuild needed before the next lookup.
+        double ns_per_lookup = 0.0;
+        double ns_per_scan = 0.0;
+        size_t memory_bytes = 0;
+        bool correct = true; // Lookups and scans agreed with the sorted vector.
+    };
+
+    /**
+     * @brief Compares the updatable learned index with an immutable sorted vector on a changing key set.
+     *
+     * Each round applies 'updates_per_round' changes (half inserts of new random keys, half
+     * deletes of existing ones), then runs 'lookups_per_round' point lookups and a few range
+     * scans of about 100 keys. The sorted vector is re-sorted from scratch after each round,
+     * which is what reloading the file would cost; the learned index applies the changes in place.
+     *
+     * @param sorted The sorted, de-duplicated starting dataset.
+     */
+    inline std::vector<UpdateBenchmarkResult> runUpdateBenchmark(const std::vector<int>& sorted, int rounds = 200,
+        int updates_per_round = 100, int lookups_per_round = 1000) {
+        std::vector<UpdateBenchmarkResult> rows;
+        if (sorted.empty()) return rows;
+        typedef std::chrono::high_resolution_clock Clock;
+        const int scans_per_round = 10;
+        const long long scan_width = std::max(1LL, (static_cast<long long>(sorted.back()) - sorted.front()) * 100 / static_cast<long long>(sorted.size()));
+
+        // The same operations for both representations: updates, then lookups and scan starts, per round.
+        std::mt19937 rng(2025);
+        std::uniform_int_distribution<int> value(sorted.front(), sorted.back());
+        std::uniform_int_distribution<size_t> pick(0, sorted.size() - 1);
+        std::vector<std::pair<bool, int>> updates; // (is_insert, key)
+        for (int i = 0; i < rounds * updates_per_round; ++i) {
+            bool is_insert = i % 2 == 0;
+            updates.push_back(std::make_pair(is_insert, is_insert ? value(rng) : sorted[pick(rng)]));
+        }
+        std::vector<int> lookups = makeBenchmarkQueries(sorted, static_cast<size_t>(rounds) * lookups_per_round, 0.5, 2026);
+        std::vector<int> scan_starts = makeBenchmarkQueries(sorted, static_cast<size_t>(rounds) * scans_per_round, 0.0, 2027);
+
+        std::vector<char> expected_hits;
+        std::vector<size_t> expected_scans;
+        size_t expected_size = 0;
+        for (int pass = 0; pass < 2; ++pass) {
+            const bool learned = pass == 1;
+            UpdateBenchmarkResult row;
+            row.name = learned ? "updatable learned index" : "sorted vector + reload";
+            std::vector<int> keys = sorted;
+            UpdatableLearnedIndex index;
+            if (learned) index.bulkLoad(sorted);
+            double update_ns = 0.0, lookup_ns = 0.0, scan_ns = 0.0;
+            std::vector<int> scanned;
+
+            for (int round = 0; round < rounds; ++round) {
+                auto start = Clock::now();
+                if (learned) {
+                    for (int i = round * updates_per_round; i < (round + 1) * updates_per_round; ++i) {
+                        if (updates[i].first) index.insert(updates[i].second);
+                        else index.erase(updates[i].second);
+                    }
+                }
+                else {
+                    // The last change to a key in this round decides whether it is present.
+                    std::vector<std::pair<int, int>> changes; // (key, update index)
+                    for (int i = round * updates_per_round; i < (round + 1) * updates_per_round; ++i) {
+                        changes.push_back(std::make_pair(updates[i].second, i));
+                    }
+                    std::sort(changes.begin(), changes.end());
+                    std::vector<int> inserted, deleted;
+                    for (size_t c = 0; c < changes.size(); ++c) {
+                        if (c + 1 < changes.size() && changes[c + 1].first == changes[c].first) continue;
+                        (updates[changes[c].second].first ? inserted : deleted).push_back(changes[c].first);
+                    }
+                    // Full reload: the new contents are sorted and de-duplicated from scratch.
+                    std::vector<int> reloaded = keys;
+                    reloaded.insert(reloaded.end(), inserted.begin(), inserted.end());
+                    std::sort(reloaded.begin(), reloaded.end());
+                    reloaded.erase(std::unique(reloaded.begin(), reloaded.end()), reloaded.end());
+                    keys.clear();
+                    std::set_difference(reloaded.begin(), reloaded.end(), deleted.begin(), deleted.end(), std::back_inserter(keys));
+                }
+                auto middle = Clock::now();
+
+                for (int i = round * lookups_per_round; i < (round + 1) * lookups_per_round; ++i) {
+                    bool hit = learned ? index.contains(lookups[i]) : interpolationSearch(keys, lookups[i]) != -1;
+                    if (!learned) expected_hits.push_back(hit);
+                    else if (expected_hits[i] != hit) row.correct = false;
+                }
+                auto lookups_done = Clock::now();
+
+                for (int i = round * scans_per_round; i < (round + 1) * scans_per_round; ++i) {
+                    int lo = scan_starts[i];
+                    int hi = static_cast<int>(std::min<long long>(INT_MAX, lo + scan_width));
+                    scanned.clear();
+                    if (learned) {
+                        index.rangeScan(lo, hi, scanned);
+                    }
+                    else {
+                        scanned.assign(std::lower_bound(keys.begin(), keys.end(), lo), std::upper_bound(keys.begin(), keys.end(), hi));
+                    }
+                    if (!learned) expected_scans.push_back(scanned.size());
+                    else if (expected_scans[i] != scanned.size()) row.correct = false;
+                }
+                auto end = Clock::now();
+
+                update_ns += std::chrono::duration<double, std::nano>(middle - start).count();
+                lookup_ns += std::chrono::duration<double, std::nano>(lookups_done - middle).count();
+                scan_ns += std::chrono::duration<double, std::nano>(end - lookups_done).count();
+            }
+            row.ns_per_update = update_ns / (static_cast<double>(rounds) * updates_per_round);
+            row.ns_per_lookup = lookup_ns / (static_cast<double>(rounds) * lookups_per_round);
+            row.ns_per_scan = scan_ns / (static_cast<double>(rounds) * scans_per_round);
+            row.memory_bytes = learned ? index.memoryBytes() : keys.capacity() * sizeof(int);
+            if (!learned) expected_size = keys.size();
+            else if (index.size() != expected_size) row.correct = false;
+            rows.push_back(row);
+        }
+        return rows;
+    }
+
+    /**
+     * @brief Prints update benchmark rows as a table.
+     */
+    inline void printUpdateBenchmarkTable(const std::vector<UpdateBenchmarkResult>& rows, std::ostream& out) {
+        out << std::left << std::setw(26) << "Representation" << std::right << std::setw(12) << "ns/update"
+            << std::setw(12) << "ns/lookup" << std::setw(12) << "ns/scan" << std::setw(12) << "Memory KB" << "  Correct\n";
+        for (const UpdateBenchmarkResult& row : rows) {
+            out << std::left << std::setw(26) << row.name << std::right << std::fixed << std::setprecision(1)
+                << std::setw(12) << row.ns_per_update << std::setw(12) << row.ns_per_lookup << std::setw(12) << row.ns_per_scan
+                << std::setw(12) << row.memory_bytes / 1024 << "  " << (row.correct ? "yes" : "NO") << "\n";
+        }
+    }
+
+    // One row of the hot-key cache report.
+    struct HotCacheBenchmarkResult {
+        std::string name;
+        double plain_ns = 0.0;  // ns per lookup without the cache.
+        double cached_ns = 0.0; // ns per lookup with the cache in front.
+        double hit_rate = 0.0;
+        bool correct = true;    // The cached answers matched the plain ones.
+    };
+
+    /**
+     * @brief Times every registered algorithm on Zipf queries with and without a hot-key cache.
+     *
+     * @param sorted The sorted, de-duplicated dataset.
+     * @param skew Zipf exponent; about 1 is typical of production traffic.
+     * @param capacity Cache entries.
+     * @param num_queries Number of lookups per run.
+     */
+    inline std::vector<HotCacheBenchmarkResult> runHotCacheBenchmark(const std::vector<int>& sorted, double skew = 1.0,
+        size_t capacity = 4096, size_t num_queries = 200000) {
+        std::vector<HotCacheBenchmarkResult> rows;
+        if (sorted.empty()) return rows;
+        std::vector<int> queries = makeZipfQueries(sorted, num_queries, skew);
+        for (const std::string& name : registeredSearchIndexNames()) {
+            std::unique_ptr<SearchIndex> plain = createMeteredSearchIndex(name);
+            CachedSearchIndex* cache_layer = new CachedSearchIndex(createSearchIndex(name), capacity);
+            MeteredSearchIndex cached((std::unique_ptr<SearchIndex>(cache_layer)));
+            plain->build(sorted);
+            cached.build(sorted);
+
+            std::vector<int> reference(queries.size()), results(queries.size());
+            auto start = std::chrono::high_resolution_clock::now();
+            for (size_t i = 0; i < queries.size(); ++i) reference[i] = plain->search(queries[i]);
+            auto middle = std::chrono::high_resolution_clock::now();
+            for (size_t i = 0; i < queries.size(); ++i) results[i] = cached.search(queries[i]);
+            auto end = std::chrono::high_resolution_clock::now();
+
+            HotCacheBenchmarkResult row;
+            row.name = name;
+            row.plain_ns = std::chrono::duration<double, std::nano>(middle - start).count() / queries.size();
+            row.cached_ns = std::chrono::duration<double, std::nano>(end - middle).count() / queries.size();
+            row.hit_rate = cache_layer->hotKeyCache().hitRate();
+            row.correct = results == reference;
+            rows.push_back(row);
+        }
+        return rows;
+    }
+
+    /**
+     * @brief Prints hot-key cache rows as a table.
+     */
+    inline void printHotCacheBenchmarkTable(const std::vector<HotCacheBenchmarkResult>& rows, std::ostream& out) {
+        out << std::left << std::setw(22) << "Algorithm" << std::right << std::setw(12) << "Plain ns" << std::setw(12) << "Cached ns"
+            << std::setw(10) << "Hit rate" << "  Correct\n";
+        for (const HotCacheBenchmarkResult& row : rows) {
+            out << std::left << std::setw(22) << row.name << std::right << std::fixed << std::setprecision(1)
+                << std::setw(12) << row.plain_ns << std::setw(12) << row.cached_ns << std::setw(9) << row.hit_rate * 100.0 << "%"
+                << "  " << (row.correct ? "yes" : "NO") << "\n";
+        }
+    }
+
+    // One query width of the range filter benchmark.
+    struct RangeFilterBenchmarkRow {
+        long long width = 0;         // Values per range query.
+        double empty_fraction = 0.0; // Queries whose range holds no key.
+        double observed_fpr = 0.0;   // Empty ranges the filter still let through.
+        double filter_ns = 0.0;      // ns per query for the filter alone.
+        double search_ns = 0.0;      // ns per query for a lower bound over the dataset.
+        double filtered_ns = 0.0;    // ns per query for the filter, then the search only if it may match.
+        bool pays_off = true;        // The filter saved more than it cost (filtered_ns < search_ns).
+        bool correct = true;         // No non-empty range was rejected.
+    };
+
+    struct RangeFilterBenchmarkReport {
+        double target_fpr = 0.0;
+        double achieved_fpr = 0.0;          // Empty ranges let through, over all widths.
+        bool meets_target = true;           // The memory cap held every level the target needs.
+        int needed_bloom_levels = 0;
+        double required_bits_per_key = 0.0; // What an uncapped filter for the target uses.
+        size_t memory_bytes = 0;
+        double bits_per_key = 0.0;
+        bool exact = false;
+        int bloom_levels = 0;
+        double build_us = 0.0;
+        std::vector<RangeFilterBenchmarkRow> rows;
+    };
+
+    /**
+     * @brief Times range-emptiness checks with and without a RangeFilter.
+     *
+     * The query widths are multiples of the dataset's average key gap, from single values (mostly
+     * empty) to several gaps (mostly non-empty). Each range start is uniform between the smallest
+     * and largest key.
+     *
+     * @param target_fpr Range false-positive rate the filter is built for.
+     * @param max_bits_per_key Memory cap the filter is built with, or RANGE_FILTER_UNCAPPED.
+     */
+    inline RangeFilterBenchmarkReport runRangeFilterBenchmark(const std::vector<int>& sorted, double target_fpr = 0.01,
+                                                              double max_bits_per_key = RANGE_FILTER_UNCAPPED, size_t num_queries = 200000) {
+        RangeFilterBenchmarkReport report;
+        if (sorted.empty() || num_queries == 0) return report;
+        RangeFilter filter;
+        auto start = std::chrono::high_resolution_clock::now();
+        filter.build(sorted, target_fpr, max_bits_per_key);
+        auto end = std::chrono::high_resolution_clock::now();
+        report.target_fpr = filter.targetFpr();
+        report.memory_bytes = filter.memoryBytes();
+        report.bits_per_key = filter.bitsPerKey();
+        report.exact = filter.isExact();
+        report.bloom_levels = filter.bloomLevels();
+        report.meets_target = filter.meetsTarget();
+        report.needed_bloom_levels = filter.neededBloomLevels();
+        report.required_bits_per_key = filter.requiredBitsPerKey();
+        report.build_us = std::chrono::duration<double, std::micro>(end - start).count();
+
+        const int* keys = sorted.data();
+        int n = static_cast<int>(sorted.size());
+        auto nonEmpty = [&](int lo, int hi) {
+            int position = smallLowerBound(keys, n, lo);
+            return position < n && keys[position] <= hi;
+        };
+
+        long long gap = std::max(1LL, (static_cast<long long>(sorted.back()) - sorted.front()) / n);
+        std::vector<long long> widths = { 1, std::max(2LL, gap / 4), std::max(3LL, gap), std::max(4LL, 4 * gap) };
+        std::mt19937 rng(2025);
+        std::uniform_int_distribution<int> value(sorted.front(), sorted.back());
+        std::vector<int> los(num_queries), his(num_queries);
+        std::vector<char> expected(num_queries), passed(num_queries), answered(num_queries);
+        size_t total_empty = 0, total_false_positives = 0;
+        for (long long width : widths) {
+            for (size_t i = 0; i < num_queries; ++i) {
+                los[i] = value(rng);
+                his[i] = static_cast<int>(std::min<long long>(INT_MAX, los[i] + width - 1));
+            }
+            auto t0 = std::chrono::high_resolution_clock::now();
+            for (size_t i = 0; i < num_queries; ++i) passed[i] = filter.mayContain(los[i], his[i]);
+            auto t1 = std::chrono::high_resolution_clock::now();
+            for (size_t i = 0; i < num_queries; ++i) expected[i] = nonEmpty(los[i], his[i]);
+            auto t2 = std::chrono::high_resolution_clock::now();
+            for (size_t i = 0; i < num_queries; ++i) answered[i] = filter.mayContain(los[i], his[i]) && nonEmpty(los[i], his[i]);
+            auto t3 = std::chrono::high_resolution_clock::now();
+
+            RangeFilterBenchmarkRow row;
+            row.width = width;
+            size_t empty = 0, false_positives = 0;
+            for (size_t i = 0; i < num_queries; ++i) {
+                if (!expected[i]) {
+                    ++empty;
+                    false_positives += passed[i] != 0;
+                }
+                else if (!passed[i]) {
+                    row.correct = false;
+                }
+                if (answered[i] != expected[i]) row.correct = false;
+            }
+            row.empty_fraction = static_cast<double>(empty) / num_queries;
+            row.observed_fpr = empty ? static_cast<double>(false_positives) / empty : 0.0;
+            total_empty += empty;
+            total_false_positives += false_positives;
+            row.filter_ns = std::chrono::duration<double, std::nano>(t1 - t0).count() / num_queries;
+            row.search_ns = std::chrono::duration<double, std::nano>(t2 - t1).count() / num_queries;
+            row.filtered_ns = std::chrono::duration<double, std::nano>(t3 - t2).count() / num_queries;
+            row.pays_off = row.filtered_ns < row.search_ns;
+            report.rows.push_back(row);
+        }
+        report.achieved_fpr = total_empty ? static_cast<double>(total_false_positives) / total_empty : 0.0;
+        return report;
+    }
+
+    /**
+     * @brief Prints the range filter's memory and achieved FPR, then one row per query width, flagging widths where it does not pay off.
+     */
+    inline void printRangeFilterReport(const RangeFilterBenchmarkReport& report, std::ostream& out) {
+        out << std::fixed << std::setprecision(2) << "Range filter: target FPR " << report.target_fpr * 100.0 << "%, achieved "
+            << report.achieved_fpr * 100.0 << "%, " << report.memory_bytes << " bytes (" << report.bits_per_key << " bits/key"
+            << (report.exact ? ", exact bitmap" : ", " + std::to_string(report.bloom_levels) + " Bloom levels") << "), built in " << std::setprecision(0) << report.build_us << " us\n";
+        if (!report.meets_target) {
+            out << "Warning: the memory cap holds " << report.bloom_levels << " of the " << report.needed_bloom_levels
+                << " Bloom levels the target needs, so ranges pass more often than the target; it needs "
+                << std::setprecision(1) << report.required_bits_per_key << " bits/key.\n";
+        }
+        out << std::left << std::setw(10) << "Width" << std::right << std::setw(8) << "Empty" << std::setw(10) << "FPR"
+            << std::setw(11) << "Filter ns" << std::setw(11) << "Search ns" << std::setw(13) << "Filtered ns" << "  Pays off  Correct\n";
+        bool any_loss = false;
+        for (const RangeFilterBenchmarkRow& row : report.rows) {
+            any_loss = any_loss || !row.pays_off;
+            out << std::left << std::setw(10) << row.width << std::right << std::setprecision(1) << std::setw(7) << row.empty_fraction * 100.0 << "%"
+                << std::setprecision(2) << std::setw(9) << row.observed_fpr * 100.0 << "%" << std::setprecision(1) << std::setw(11) << row.filter_ns
+                << std::setw(11) << row.search_ns << std::setw(13) << row.filtered_ns << std::setw(10) << (row.pays_off ? "yes" : "no")
+                << "  " << (row.correct ? "yes" : "NO") << "\n";
+        }
+        if (any_loss) out << "At widths marked 'no' the filter costs more than it saves; search those ranges directly.\n";
+    }
+
+} // namespace ProjectUtils
+
+#endif // BENCHMARK_H
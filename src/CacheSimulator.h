@@ -0,0 +1,387 @@
+#ifndef CACHE_SIMULATOR_H
+#define CACHE_SIMULATOR_H
+
+#include "ProjectUtils.h"   // For jumpSearchOver and interpolationSearchOver.
+#include "SearchLayouts.h"  // For the Eytzinger and B-tree layouts and their lower-bound functions.
+#include "SimdSearch.h"     // For kAryInterpolationSearchOver.
+#include "SearchIndex.h"    // For the SearchIndex classes whose searchOver the traced run calls.
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <algorithm>
+#include <cctype> // For std::isdigit in parseOverride.
+#include <iostream>
+#include <iomanip>
+
+/*
+Instrumented execution mode: a software cache model for deterministic memory-access analysis.
+
+Hardware counters are noisy and often unavailable in containers, so instead of measuring the
+machine we simulate one:
+
+    1. Each algorithm runs unchanged over a TracedArray, which records every element it reads.
+       The search functions are templates over the array type (`jumpSearchOver`,
+       `interpolationSearchOver`, `eytzingerLowerBoundSlot`, ...), so the traced run makes
+       exactly the probes the real one does. A read is recorded as its offset in the array,
+       rebased onto a fixed synthetic address for that structure (TRACE_KEYS_BASE,
+       TRACE_TABLE_BASE), so where the allocator or ASLR put the real array never changes
+       which cache set or page a read falls on.
+    2. The address trace is replayed through set-associative LRU caches (L1, L2, LLC) and a
+       set-associative TLB. Cache state carries over from one query to the next, like it would
+       in a lookup loop.
+    3. The report gives simulated misses per query at each level, and a heatmap of how often
+       each part of the searched array was touched.
+
+The results depend only on the dataset, the queries and the CacheModelConfig, never on the
+machine the program runs on.
+*/
+
+namespace ProjectUtils {
+
+    // Synthetic, page-aligned base addresses of the traced structures: the searched array and an
+    // index's own table (such as radix buckets). They are 4 GiB apart, so the structures never overlap.
+    const uintptr_t TRACE_KEYS_BASE = uintptr_t(1) << 32;
+    const uintptr_t TRACE_TABLE_BASE = uintptr_t(2) << 32;
+
+    /**
+     * @brief Synthetic addresses read by an instrumented run, in order.
+     */
+    struct AccessTrace {
+        std::vector<uintptr_t> addresses;
+        size_t queries = 0;
+
+        void clear() {
+            addresses.clear();
+            queries = 0;
+        }
+    };
+
+    /**
+     * @brief Read-only array view that appends 'base' plus the byte offset of every element read to a trace.
+     */
+    template<typename T>
+    class TracedArray {
+    public:
+        TracedArray(const T* data, size_t count, AccessTrace& trace, uintptr_t base = TRACE_KEYS_BASE)
+            : data(data), count(count), trace(&trace), base(base) {}
+
+        size_t size() const { return count; }
+
+        T operator[](size_t i) const {
+            trace->addresses.push_back(base + i * sizeof(T));
+            return data[i];
+        }
+
+    private:
+        const T* data;
+        size_t count;
+        AccessTrace* trace;
+        uintptr_t base;
+    };
+
+    // Geometry of one simulated cache (or TLB, where 'line_bytes' is the page size).
+    struct CacheLevelConfig {
+        std::string name;
+        size_t size_bytes;
+        size_t line_bytes;
+        size_t ways;
+    };
+
+    /**
+     * @brief The simulated memory hierarchy. Defaults describe a typical x86 server core.
+     */
+    struct CacheModelConfig {
+        CacheLevelConfig l1 = { "L1", 32 * 1024, 64, 8 };
+        CacheLevelConfig l2 = { "L2", 1024 * 1024, 64, 16 };
+        CacheLevelConfig llc = { "LLC", 32 * 1024 * 1024, 64, 16 };
+        size_t tlb_entries = 64;
+        size_t tlb_ways = 4;
+        size_t page_bytes = 4096;
+
+        /**
+         * @brief Applies one "key=value" override: l1_kb, l2_kb, llc_kb, line, tlb, page.
+         *
+         * @return false (with an error message) if the key is unknown or the value is not a positive number.
+         */
+        bool parseOverride(const std::string& assignment) {
+            size_t equals = assignment.find('=');
+            if (equals == std::string::npos) {
+                std::cerr << "Error: Expected key=value, got '" << assignment << "'.\n";
+                return false;
+            }
+            std::string key = assignment.substr(0, equals);
+            std::string text = assignment.substr(equals + 1);
+            unsigned long long value = 0;
+            try {
+                size_t parsed = 0;
+                // stoull accepts a sign and stops at the first non-digit, so require digits only.
+                if (!text.empty() && std::isdigit(static_cast<unsigned char>(text[0]))) value = std::stoull(text, &parsed);
+                if (parsed != text.size()) value = 0;
+            }
+            catch (const std::exception&) {
+                value = 0;
+            }
+            if (value == 0) {
+                std::cerr << "Error: '" << assignment << "' needs a positive number.\n";
+                return false;
+            }
+            if (key == "l1_kb") l1.size_bytes = value * 1024;
+            else if (key == "l2_kb") l2.size_bytes = value * 1024;
+            else if (key == "llc_kb") llc.size_bytes = value * 1024;
+            else if (key == "line") l1.line_bytes = l2.line_bytes = llc.line_bytes = value;
+            else if (key == "tlb") tlb_entries = value;
+            else if (key == "page") page_bytes = value;
+            else {
+                std::cerr << "Error: Unknown cache model setting '" << key << "'.\n";
+                return false;
+            }
+            return true;
+        }
+    };
+
+    /**
+     * @brief One set-associative cache with LRU replacement, tracking tags only.
+     */
+    class SetAssociativeCache {
+    public:
+        explicit SetAssociativeCache(const CacheLevelConfig& config) : line_bytes(std::max<size_t>(1, config.line_bytes)),
+            ways(std::max<size_t>(1, config.ways)), accesses(0), misses(0) {
+            num_sets = std::max<size_t>(1, config.size_bytes / line_bytes / ways);
+            tags.assign(num_sets * ways, ~uint64_t(0)); // No line number is all ones.
+        }
+
+        /**
+         * @brief Looks up the line holding 'address' and makes it most recently used.
+         *
+         * @return true on a hit; on a miss the line is brought in, evicting the LRU line of its set.
+         */
+        bool access(uintptr_t address) {
+            uint64_t line = address / line_bytes;
+            uint64_t* set = &tags[(line % num_sets) * ways];
+            ++accesses;
+            // Each set is kept in recency order, most recent first.
+            size_t way = 0;
+            while (way < ways && set[way] != line) ++way;
+            bool hit = way < ways;
+            if (!hit) {
+                ++misses;
+                way = ways - 1;
+            }
+            for (; way > 0; --way) set[way] = set[way - 1];
+            set[0] = line;
+            return hit;
+        }
+
+        unsigned long long accessCount() const { return accesses; }
+        unsigned long long missCount() const { return misses; }
+
+    private:
+        size_t line_bytes;
+        size_t ways;
+        size_t num_sets;
+        std::vector<uint64_t> tags;
+        unsigned long long accesses;
+        unsigned long long misses;
+    };
+
+    // Simulated misses of one replayed trace.
+    struct CacheSimulationResult {
+        std::string name;
+        size_t queries = 0;
+        unsigned long long accesses = 0;
+        unsigned long long l1_misses = 0;
+        unsigned long long l2_misses = 0;
+        unsigned long long llc_misses = 0;
+        unsigned long long tlb_misses = 0;
+        std::vector<unsigned long long> heatmap; // Touches per equal-sized region of the searched array.
+
+        double perQuery(unsigned long long count) const { return queries ? static_cast<double>(count) / queries : 0.0; }
+    };
+
+    /**
+     * @brief Replays a trace through L1 -> L2 -> LLC and the TLB.
+     *
+     * A level is consulted only when the level above it missed, and the line is filled into
+     * every level that missed (a non-inclusive, fill-on-miss hierarchy).
+     */
+    inline CacheSimulationResult simulateCacheHierarchy(const AccessTrace& trace, const CacheModelConfig& config) {
+        SetAssociativeCache l1(config.l1), l2(config.l2), llc(config.llc);
+        CacheLevelConfig tlb_config = { "TLB", config.tlb_entries * config.page_bytes, config.page_bytes, config.tlb_ways };
+        SetAssociativeCache tlb(tlb_config);
+        for (uintptr_t address : trace.addresses) {
+            tlb.access(address);
+            if (!l1.access(address) && !l2.access(address)) llc.access(address);
+        }
+        CacheSimulationResult result;
+        result.queries = trace.queries;
+        result.accesses = l1.accessCount();
+        result.l1_misses = l1.missCount();
+        result.l2_misses = l2.missCount();
+        result.llc_misses = llc.missCount();
+        result.tlb_misses = tlb.missCount();
+        return result;
+    }
+
+    /**
+     * @brief Counts the trace's touches of [base, base + bytes) in 'buckets' equal regions.
+     */
+    inline std::vector<unsigned long long> buildAccessHeatmap(const AccessTrace& trace, uintptr_t base, size_t bytes, size_t buckets) {
+        std::vector<unsigned long long> heatmap(buckets, 0);
+        if (bytes == 0 || buckets == 0) return heatmap;
+        for (uintptr_t address : trace.addresses) {
+            if (address < base || address >= base + bytes) continue;
+            heatmap[static_cast<size_t>((static_cast<unsigned long long>(address - base) * buckets) / bytes)]++;
+        }
+        return heatmap;
+    }
+
+    /**
+     * @brief Runs one instrumented algorithm over a traced copy of its array.
+     *
+     * Names match the SearchIndex registry, and every registered index is covered: sorted, jump,
+     * interpolation, kary-interpolation, eytzinger, btree, radix and linear-model. Sorted, radix and
+     * linear-model run the index class's own searchOver, so they trace the body search() runs.
+     * For the layouts only key reads are traced, not the rank lookup on a hit. Radix traces its
+     * bucket-table reads as well, but the heatmap covers the key array only. The traced
+     * kary-interpolation reads its probes one by one, so it touches the same lines as the SIMD
+     * gather but does not model the gather itself.
+     */
+    class TracedSearcher {
+    public:
+        TracedSearcher() : kind(-1), sorted(nullptr), num_keys(0) {}
+
+        static std::vector<std::string> algorithmNames() {
+            return { "sorted", "jump", "interpolation", "kary-interpolation", "eytzinger", "btree", "radix", "linear-model" };
+        }
+
+        /**
+         * @brief Prepares 'algorithm' over 'sorted' (which must outlive the searcher).
+         *
+         * @return false if the algorithm is not instrumented.
+         */
+        bool build(const std::string& algorithm, const std::vector<int>& sorted_keys) {
+            std::vector<std::string> names = algorithmNames();
+            kind = static_cast<int>(std::find(names.begin(), names.end(), algorithm) - names.begin());
+            if (kind == static_cast<int>(names.size())) {
+                kind = -1;
+                return false;
+            }
+            sorted = &sorted_keys;
+            num_keys = static_cast<int>(sorted_keys.size());
+            if (kind == EYTZINGER) buildEytzingerLayout(sorted_keys, layout, ranks);
+            else if (kind == BTREE) buildBTreeLayout(sorted_keys, layout, ranks);
+            else if (kind == SORTED) sorted_index.build(sorted_keys);
+            else if (kind == RADIX) radix.build(sorted_keys);
+            else if (kind == LINEAR_MODEL) linear_model.build(sorted_keys);
+            return true;
+        }
+
+        // The array the algorithm reads: the dataset itself or the layout built from it.
+        const std::vector<int>& array() const { return kind == EYTZINGER || kind == BTREE ? layout : *sorted; }
+
+        /**
+         * @brief Searches for 'target', appending every (synthetic) address read to 'trace'.
+         *
+         * @return Whether 'target' was found.
+         */
+        bool search(int target, AccessTrace& trace) const {
+            if (num_keys == 0) return false;
+            const std::vector<int>& keys = array();
+            TracedArray<int> traced(keys.data(), keys.size(), trace);
+            if (kind == SORTED) return sorted_index.searchOver(traced, target) != -1;
+            if (kind == JUMP) return jumpSearchOver(traced, target) != -1;
+            if (kind == INTERPOLATION) return interpolationSearchOver(traced, target) != -1;
+            if (kind == KARY) return kAryInterpolationSearchOver(traced, num_keys, target) != -1;
+            if (kind == RADIX) {
+                const std::vector<int>& table = radix.bucketTable();
+                return radix.searchOver(traced, TracedArray<int>(table.data(), table.size(), trace, TRACE_TABLE_BASE), target) != -1;
+            }
+            if (kind == LINEAR_MODEL) return linear_model.searchOver(traced, target) != -1;
+            if (kind == EYTZINGER) {
+                int slot = eytzingerLowerBoundSlot(traced, num_keys, target);
+                return slot != 0 && traced[slot] == target;
+            }
+            int slot = bTreeLowerBoundSlot(traced, static_cast<int>(keys.size()) / BTREE_NODE_KEYS, target);
+            return slot != -1 && traced[slot] == target;
+        }
+
+    private:
+        enum { SORTED, JUMP, INTERPOLATION, KARY, EYTZINGER, BTREE, RADIX, LINEAR_MODEL };
+        int kind;
+        const std::vector<int>* sorted;
+        int num_keys;
+        std::vector<int> layout;
+        std::vector<int> ranks;
+        SortedArrayIndex sorted_index;
+        RadixTableIndex radix;
+        LinearModelIndex linear_model;
+    };
+
+    /**
+     * @brief Traces and simulates every instrumented algorithm over one query set.
+     *
+     * @param sorted The sorted, de-duplicated dataset.
+     * @param num_queries Number of lookups traced per algorithm (half hits, half misses).
+     * @param config The simulated hierarchy.
+     * @param heatmap_buckets Number of regions each array is divided into for the heatmap.
+     */
+    inline std::vector<CacheSimulationResult> runCacheSimulation(const std::vector<int>& sorted, size_t num_queries,
+        const CacheModelConfig& config, size_t heatmap_buckets = 64) {
+        std::vector<CacheSimulationResult> rows;
+        if (sorted.empty()) return rows;
+        std::vector<int> queries = makeBenchmarkQueries(sorted, num_queries);
+
+        for (const std::string& name : TracedSearcher::algorithmNames()) {
+            TracedSearcher searcher;
+            searcher.build(name, sorted);
+            AccessTrace trace;
+            for (int target : queries) {
+                searcher.search(target, trace);
+                ++trace.queries;
+            }
+            CacheSimulationResult result = simulateCacheHierarchy(trace, config);
+            result.name = name;
+            const std::vector<int>& array = searcher.array();
+            result.heatmap = buildAccessHeatmap(trace, TRACE_KEYS_BASE, array.size() * sizeof(int), heatmap_buckets);
+            rows.push_back(result);
+        }
+        return rows;
+    }
+
+    /**
+     * @brief Prints misses per query for each algorithm, then one heatmap row per algorithm.
+     *
+     * Heatmap cells run from the start of the searched array (left) to its end (right); the
+     * darker the character, the more touches that region received relative to the busiest one.
+     */
+    inline void printCacheSimulationReport(const std::vector<CacheSimulationResult>& rows, const CacheModelConfig& config, std::ostream& out) {
+        out << "Simulated hierarchy: " << config.l1.name << " " << config.l1.size_bytes / 1024 << " KB/" << config.l1.ways << "-way, "
+            << config.l2.name << " " << config.l2.size_bytes / 1024 << " KB/" << config.l2.ways << "-way, "
+            << config.llc.name << " " << config.llc.size_bytes / 1024 << " KB/" << config.llc.ways << "-way, "
+            << config.l1.line_bytes << " B lines, TLB " << config.tlb_entries << " x " << config.page_bytes << " B pages\n";
+        out << std::left << std::setw(20) << "Algorithm" << std::right << std::setw(12) << "Reads/q" << std::setw(12) << "L1 miss/q"
+            << std::setw(12) << "L2 miss/q" << std::setw(12) << "LLC miss/q" << std::setw(12) << "TLB miss/q" << "\n";
+        for (const CacheSimulationResult& row : rows) {
+            out << std::left << std::setw(20) << row.name << std::right << std::fixed << std::setprecision(2)
+                << std::setw(12) << row.perQuery(row.accesses) << std::setw(12) << row.perQuery(row.l1_misses)
+                << std::setw(12) << row.perQuery(row.l2_misses) << std::setw(12) << row.perQuery(row.llc_misses)
+                << std::setw(12) << row.perQuery(row.tlb_misses) << "\n";
+        }
+
+        static const char shades[] = " .:-=+*#%@";
+        out << "\nTouches across each searched array (start -> end):\n";
+        for (const CacheSimulationResult& row : rows) {
+            unsigned long long busiest = row.heatmap.empty() ? 0 : *std::max_element(row.heatmap.begin(), row.heatmap.end());
+            out << std::left << std::setw(20) << row.name << "|";
+            for (unsigned long long touches : row.heatmap) {
+                size_t shade = busiest ? static_cast<size_t>((touches * 9 + busiest - 1) / busiest) : 0;
+                out << shades[shade];
+            }
+            out << "|\n";
+        }
+        out << std::right;
+    }
+
+} // namespace ProjectUtils
+
+#endif // CACHE_SIMULATOR_H
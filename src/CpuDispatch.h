@@ -0,0 +1,132 @@
+#ifndef CPU_DISPATCH_H
+#define CPU_DISPATCH_H
+
+#include <string>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h> // GCC and Clang declare every intrinsic here, whatever -m flags are in effect.
+#define PROJECT_HAS_CPU_DISPATCH 1
+#define PROJECT_TARGET(features) __attribute__((target(features)))
+#else
+#define PROJECT_HAS_CPU_DISPATCH 0
+#define PROJECT_TARGET(features)
+#endif
+
+// Whether the kernels for each instruction set are compiled: always with run-time dispatch,
+// otherwise only when the compiler already targets that instruction set.
+#if PROJECT_HAS_CPU_DISPATCH || defined(__SSSE3__)
+#define PROJECT_HAS_SSSE3_KERNELS 1
+#else
+#define PROJECT_HAS_SSSE3_KERNELS 0
+#endif
+#if PROJECT_HAS_CPU_DISPATCH || defined(__AVX2__)
+#define PROJECT_HAS_AVX2_KERNELS 1
+#else
+#define PROJECT_HAS_AVX2_KERNELS 0
+#endif
+#if PROJECT_HAS_CPU_DISPATCH || defined(__AVX512F__)
+#define PROJECT_HAS_AVX512_KERNELS 1
+#else
+#define PROJECT_HAS_AVX512_KERNELS 0
+#endif
+#if PROJECT_HAS_CPU_DISPATCH || defined(__BMI2__)
+#define PROJECT_HAS_BMI2_KERNELS 1
+#else
+#define PROJECT_HAS_BMI2_KERNELS 0
+#endif
+
+/*
+Run-time selection of the SIMD kernels.
+
+Default builds target the baseline of the architecture (ENABLE_NATIVE_ARCH is OFF in
+CMakeLists.txt), so the compiler may not use SSSE3, AVX2, AVX-512 or BMI2 on its own. With GCC
+or Clang on x86 each SIMD kernel is therefore compiled for its instruction set with
+PROJECT_TARGET("avx2") and friends, and the module calls it only if `cpuHasAvx2()` (etc.)
+says this CPU runs it. The CPU is queried once, on first use.
+
+When the compiler already targets an instruction set (-march=native), its `cpuHas...()` is a
+compile-time true: the check folds away and the kernel is called directly and can be inlined.
+On other compilers and architectures only the instruction sets enabled at compile time are used.
+*/
+
+namespace ProjectUtils {
+
+    // Instruction sets this CPU (and OS) can run.
+    struct CpuFeatures {
+        bool ssse3 = false;
+        bool avx2 = false;
+        bool avx512f = false;
+        bool bmi2 = false;
+    };
+
+    /**
+     * @brief The features of this CPU, queried on the first call.
+     */
+    inline const CpuFeatures& cpuFeatures() {
+        static const CpuFeatures features = []() {
+            CpuFeatures detected;
+#if PROJECT_HAS_CPU_DISPATCH
+            __builtin_cpu_init();
+            detected.ssse3 = __builtin_cpu_supports("ssse3") != 0;
+            detected.avx2 = __builtin_cpu_supports("avx2") != 0;
+            detected.avx512f = __builtin_cpu_supports("avx512f") != 0;
+            detected.bmi2 = __builtin_cpu_supports("bmi2") != 0;
+#endif
+            return detected;
+        }();
+        return features;
+    }
+
+    inline bool cpuHasSsse3() {
+#if defined(__SSSE3__)
+        return true;
+#else
+        return cpuFeatures().ssse3;
+#endif
+    }
+
+    inline bool cpuHasAvx2() {
+#if defined(__AVX2__)
+        return true;
+#else
+        return cpuFeatures().avx2;
+#endif
+    }
+
+    inline bool cpuHasAvx512() {
+#if defined(__AVX512F__)
+        return true;
+#else
+        return cpuFeatures().avx512f;
+#endif
+    }
+
+    inline bool cpuHasBmi2() {
+#if defined(__BMI2__)
+        return true;
+#else
+        return cpuFeatures().bmi2;
+#endif
+    }
+
+    /**
+     * @brief One line naming the SIMD instruction sets the kernels use on this machine, and how they were picked.
+     */
+    inline std::string simdKernelSummary() {
+        std::string sets;
+        if (PROJECT_HAS_AVX512_KERNELS && cpuHasAvx512()) sets += "AVX-512F ";
+        if (PROJECT_HAS_AVX2_KERNELS && cpuHasAvx2()) sets += "AVX2 ";
+        if (PROJECT_HAS_SSSE3_KERNELS && cpuHasSsse3()) sets += "SSSE3 ";
+        if (PROJECT_HAS_BMI2_KERNELS && cpuHasBmi2()) sets += "BMI2 ";
+        if (sets.empty()) return "SIMD kernels: none available, scalar fallbacks in use";
+        sets.pop_back();
+#if defined(__SSSE3__) || defined(__AVX2__) || defined(__AVX512F__) || defined(__BMI2__) || !PROJECT_HAS_CPU_DISPATCH
+        return "SIMD kernels: " + sets + " (targeted at compile time)";
+#else
+        return "SIMD kernels: " + sets + " (selected at run time)";
+#endif
+    }
+
+} // namespace ProjectUtils
+
+#endif // CPU_DISPATCH_H
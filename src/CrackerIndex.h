@@ -0,0 +1,172 @@
+#ifndef CRACKER_INDEX_H
+#define CRACKER_INDEX_H
+
+#include <vector>
+#include <map>
+#include <climits>
+#include <algorithm>
+#include <utility>
+
+/*
+Adaptive indexing ("database cracking") for datasets that are queried too few times to be
+worth sorting up front.
+
+The column is loaded in file order (see `loadDatasetFromFile`). Each query only partitions,
+quicksort-style, the one piece of the column that can hold its target, and the cracker index
+remembers where the new piece boundaries are. Repeated and nearby queries therefore touch
+ever smaller pieces, and the column converges towards sorted order as queries arrive:
+
+    boundaries[v] = p   means   column[0, p) < v   and   column[p, n) >= v
+
+The first query costs one linear pass instead of a full sort; a repeated query is a lookup
+in the cracker index.
+
+Updates follow "Updating a Cracked Database" (Idreos et al.): an insert or delete ripples
+through the pieces above the value, moving one value per piece, so the cracks survive.
+*/
+
+namespace ProjectUtils {
+
+    /**
+     * @brief An unsorted column that is incrementally partitioned by the queries run on it.
+     */
+    class CrackerIndex {
+    public:
+        /**
+         * @brief Takes ownership of an unsorted column (duplicates allowed) and forgets all cracks.
+         */
+        void load(std::vector<int> data) {
+            column = std::move(data);
+            boundaries.clear();
+        }
+
+        /**
+         * @brief Searches for a value, cracking the piece that can contain it.
+         *
+         * @param target The value to search for.
+         * @return A position in the (cracked) column holding 'target', or -1 if it is not present.
+         */
+        int search(int target) {
+            size_t first = crackAt(target);
+            size_t last = target == INT_MAX ? column.size() : crackAt(target + 1);
+            return first < last ? static_cast<int>(first) : -1;
+        }
+
+        /**
+         * @brief Counts the values in [lo, hi], cracking at both ends of the range.
+         */
+        size_t rangeCount(int lo, int hi) {
+            if (lo > hi) return 0;
+            size_t first = crackAt(lo);
+            size_t last = hi == INT_MAX ? column.size() : crackAt(hi + 1);
+            return last - first;
+        }
+
+        /**
+         * @brief Counts the values in [lo, hi] without cracking, if both ends are already piece boundaries.
+         *
+         * This only reads the column and the cracker index, so concurrent callers need no exclusive lock.
+         *
+         * @return False if answering would need a new crack; 'count' is then left unchanged.
+         */
+        bool countIfCracked(int lo, int hi, size_t& count) const {
+            if (lo > hi) {
+                count = 0;
+                return true;
+            }
+            auto first = boundaries.find(lo);
+            if (first == boundaries.end()) return false;
+            size_t last = column.size();
+            if (hi != INT_MAX) {
+                auto end = boundaries.find(hi + 1);
+                if (end == boundaries.end()) return false;
+                last = end->second;
+            }
+            count = last - first->second;
+            return true;
+        }
+
+        /**
+         * @brief Adds a value without re-cracking: a ripple moves one value per piece above it.
+         *
+         * The new slot opens at the end of the column. The first value of each piece above the
+         * value's piece moves into the hole at that piece's end, and the piece's boundary moves
+         * up by one, until the hole reaches the end of the value's own piece.
+         */
+        void insert(int value) {
+            size_t hole = column.size();
+            column.push_back(value);
+            for (auto piece = boundaries.rbegin(); piece != boundaries.rend() && piece->first > value; ++piece) {
+                column[hole] = column[piece->second];
+                hole = piece->second++;
+            }
+            column[hole] = value;
+        }
+
+        /**
+         * @brief Removes one occurrence of a value, rippling the hole up to the end of the column.
+         *
+         * @return False if the value is not present.
+         */
+        bool erase(int value) {
+            size_t first = crackAt(value);
+            size_t last = value == INT_MAX ? column.size() : crackAt(value + 1);
+            if (first == last) return false;
+            size_t hole = last - 1;
+            for (auto piece = boundaries.upper_bound(value); piece != boundaries.end(); ++piece) {
+                auto next = std::next(piece);
+                size_t end = next == boundaries.end() ? column.size() : next->second;
+                hole = --piece->second; // The hole becomes the first slot of this piece...
+                column[hole] = column[end - 1];
+                hole = end - 1;         // ...and is refilled from its last slot.
+            }
+            column.pop_back();
+            return true;
+        }
+
+        // Number of pieces the column is currently split into.
+        size_t pieceCount() const { return column.empty() ? 0 : boundaries.size() + 1; }
+
+        size_t size() const { return column.size(); }
+        const std::vector<int>& data() const { return column; }
+
+        // Bytes held by the cracker index (the map nodes), not counting the column itself.
+        size_t memoryBytes() const {
+            return boundaries.size() * (sizeof(std::pair<const int, size_t>) + 4 * sizeof(void*));
+        }
+
+    private:
+        /**
+         * @brief Returns the first position whose value is >= 'value', partitioning its piece if needed.
+         */
+        size_t crackAt(int value) {
+            auto known = boundaries.find(value);
+            if (known != boundaries.end()) return known->second;
+
+            // The piece holding 'value' lies between the nearest known boundaries around it.
+            auto next = boundaries.upper_bound(value);
+            size_t hi = next == boundaries.end() ? column.size() : next->second;
+            size_t lo = next == boundaries.begin() ? 0 : std::prev(next)->second;
+
+            // Partition only [lo, hi): values < 'value' to the front, the rest to the back.
+            size_t i = lo, j = hi;
+            while (i < j) {
+                if (column[i] < value) {
+                    ++i;
+                }
+                else {
+                    --j;
+                    std::swap(column[i], column[j]);
+                }
+            }
+            boundaries.emplace_hint(next, value, i);
+            return i;
+        }
+
+        std::vector<int> column;
+        std::map<int, size_t> boundaries; // The cracker index: value -> first position >= value.
+    };
+
+} // namespace ProjectUtils
+
+#endif // CRACKER_INDEX_H
@@ -0,0 +1,454 @@
+#ifndef DATASET_DELTA_H
+#define DATASET_DELTA_H
+
+#include <vector>
+#include <string>
+#include <thread>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <cstddef>
+
+/*
+Version diffs between two sorted, de-duplicated datasets, so a new version can be published as
+the keys that changed instead of the whole file.
+
+A delta lists the changed keys in merge order, grouped into runs: a run is a maximal sequence
+of keys that were all inserted (or all deleted) with no other base key in between. The diff is
+a single merge of the two versions. Like computeSetOperation, it can be split at common key
+boundaries and run on several threads; runs that meet at a boundary are joined afterwards.
+
+Binary format (all integers little-endian):
+    "EDRDELT1"                                      8-byte magic
+    base_count, base_checksum, target_count,        u64 each
+    target_checksum, num_runs, num_keys
+    per run: varint (length << 1 | inserted), then its keys: the first as a zigzag varint of the
+             difference to the previous key written (0 before the first run), the rest as
+             varints of (gap - 1), since keys within a run are strictly ascending.
+Runs of nearby keys cost one or two bytes per key.
+
+The checksum of a dataset is the sum of a 64-bit mix of every key. It does not depend on the
+order, so it can be updated from the delta alone:
+target = base - sum(deleted) + sum(inserted). decode checks this consistency.
+
+Applying needs no re-sort and no rebuild of the file. Every changed key is first located in the
+dataset with a galloping search from the previous one, and checked: deleted keys must be
+present and inserted keys absent. The delta is rejected before anything is written if it does
+not match. Then the keys are moved in two block-copy passes, deletions front to back and
+insertions back to front. applyDatasetDelta works on any buffer with spare capacity, for
+example a dataset in a shared-memory segment that other processes map. Readers must not run
+during the apply; derived indexes are rebuilt by their owners afterwards, as after any load.
+*/
+
+namespace ProjectUtils {
+
+    // First 8 bytes of every encoded delta.
+    const char DATASET_DELTA_MAGIC[] = "EDRDELT1";
+
+    /**
+     * @brief A run of consecutive changed keys, all inserted or all deleted.
+     */
+    struct DeltaRun {
+        bool inserted = false;
+        uint32_t length = 0;
+    };
+
+    /**
+     * @brief The change from a base dataset to a target dataset.
+     */
+    struct DatasetDelta {
+        uint64_t base_count = 0;
+        uint64_t base_checksum = 0;
+        uint64_t target_count = 0;
+        uint64_t target_checksum = 0;
+        std::vector<DeltaRun> runs;
+        std::vector<int> keys; // The changed keys in merge order; runs[i] covers the next runs[i].length of them.
+
+        size_t insertedCount() const { return static_cast<size_t>(target_count + keys.size() - base_count) / 2; }
+        size_t deletedCount() const { return keys.size() - insertedCount(); }
+    };
+
+    namespace detail {
+        inline uint64_t mixKey(int key) {
+            uint64_t x = static_cast<uint32_t>(key) + 0x9E3779B97F4A7C15ull;
+            x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+            x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+            return x ^ (x >> 31);
+        }
+
+        inline void putU64(std::vector<uint8_t>& out, uint64_t value) {
+            for (int i = 0; i < 8; ++i) out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+        }
+
+        inline void putVarint(std::vector<uint8_t>& out, uint64_t value) {
+            while (value >= 0x80) {
+                out.push_back(static_cast<uint8_t>(value | 0x80));
+                value >>= 7;
+            }
+            out.push_back(static_cast<uint8_t>(value));
+        }
+
+        inline bool getU64(const uint8_t*& in, const uint8_t* end, uint64_t& value) {
+            if (end - in < 8) return false;
+            value = 0;
+            for (int i = 0; i < 8; ++i) value |= static_cast<uint64_t>(in[i]) << (8 * i);
+            in += 8;
+            return true;
+        }
+
+        inline bool getVarint(const uint8_t*& in, const uint8_t* end, uint64_t& value) {
+            value = 0;
+            for (int shift = 0; shift < 64 && in < end; shift += 7) {
+                uint8_t byte = *in++;
+                value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+                if (!(byte & 0x80)) return true;
+            }
+            return false;
+        }
+
+        // The runs of one key range, and whether its first and last keys are changes (so they may join a neighbour's run).
+        struct DeltaPart {
+            std::vector<DeltaRun> runs;
+            std::vector<int> keys;
+            bool starts_with_change = false;
+            bool ends_with_change = false;
+        };
+
+        inline void appendChange(DeltaPart& part, bool inserted, int key, bool& in_run) {
+            if (!in_run || part.runs.back().inserted != inserted) {
+                DeltaRun run;
+                run.inserted = inserted;
+                part.runs.push_back(run);
+            }
+            ++part.runs.back().length;
+            part.keys.push_back(key);
+            in_run = true;
+        }
+
+        // Merges base[0, nb) with target[0, nt) and records the changes.
+        inline void diffRange(const int* base, size_t nb, const int* target, size_t nt, DeltaPart& part) {
+            size_t i = 0, j = 0;
+            bool in_run = false;
+            part.starts_with_change = nb > 0 && nt > 0 ? base[0] != target[0] : nb + nt > 0;
+            while (i < nb || j < nt) {
+                if (j == nt || (i < nb && base[i] < target[j])) {
+                    appendChange(part, false, base[i++], in_run);
+                }
+                else if (i == nb || target[j] < base[i]) {
+                    appendChange(part, true, target[j++], in_run);
+                }
+                else {
+                    in_run = false; // An unchanged key ends the current run.
+                    ++i;
+                    ++j;
+                }
+            }
+            part.ends_with_change = in_run;
+        }
+    }
+
+    /**
+     * @brief Order-independent checksum of a dataset: the sum of a 64-bit mix of every key.
+     */
+    inline uint64_t datasetChecksum(const int* keys, size_t count) {
+        uint64_t sum = 0;
+        for (size_t i = 0; i < count; ++i) sum += detail::mixKey(keys[i]);
+        return sum;
+    }
+
+    inline uint64_t datasetChecksum(const std::vector<int>& keys) { return datasetChecksum(keys.data(), keys.size()); }
+
+    /**
+     * @brief Computes the delta that turns 'base' into 'target'.
+     *
+     * @param base The current sorted, de-duplicated dataset.
+     * @param target The new sorted, de-duplicated version.
+     * @param threads Number of worker threads (1 = run on the calling thread).
+     */
+    inline DatasetDelta diffDatasets(const std::vector<int>& base, const std::vector<int>& target, int threads = 1) {
+        DatasetDelta delta;
+        delta.base_count = base.size();
+        delta.target_count = target.size();
+
+        const std::vector<int>& larger = base.size() >= target.size() ? base : target;
+        size_t parts = static_cast<size_t>(std::max(1, threads));
+        if (larger.size() < parts * 1024) parts = 1; // Not worth the threads.
+
+        // Part p covers keys in [splits[p], splits[p + 1]); the first and last parts are open-ended.
+        std::vector<size_t> base_bounds(parts + 1), target_bounds(parts + 1);
+        base_bounds[0] = target_bounds[0] = 0;
+        base_bounds[parts] = base.size();
+        target_bounds[parts] = target.size();
+        for (size_t p = 1; p < parts; ++p) {
+            int split = larger[larger.size() * p / parts];
+            base_bounds[p] = static_cast<size_t>(std::lower_bound(base.begin(), base.end(), split) - base.begin());
+            target_bounds[p] = static_cast<size_t>(std::lower_bound(target.begin(), target.end(), split) - target.begin());
+        }
+
+        std::vector<detail::DeltaPart> outputs(parts);
+        std::vector<uint64_t> base_sums(parts, 0), target_sums(parts, 0);
+        auto run_part = [&](size_t p) {
+            const int* b = base.data() + base_bounds[p];
+            const int* t = target.data() + target_bounds[p];
+            size_t nb = base_bounds[p + 1] - base_bounds[p], nt = target_bounds[p + 1] - target_bounds[p];
+            detail::diffRange(b, nb, t, nt, outputs[p]);
+            base_sums[p] = datasetChecksum(b, nb);
+            target_sums[p] = datasetChecksum(t, nt);
+        };
+        if (parts == 1) {
+            run_part(0);
+        }
+        else {
+            std::vector<std::thread> workers;
+            for (size_t p = 0; p < parts; ++p) workers.emplace_back(run_part, p);
+            for (std::thread& worker : workers) worker.join();
+        }
+
+        bool previous_ends_with_change = false;
+        for (size_t p = 0; p < parts; ++p) {
+            detail::DeltaPart& part = outputs[p];
+            delta.base_checksum += base_sums[p];
+            delta.target_checksum += target_sums[p];
+            if (part.runs.empty()) {
+                // A part with no change still separates its neighbours' runs if it has unchanged keys.
+                if (base_bounds[p + 1] > base_bounds[p]) previous_ends_with_change = false;
+                continue;
+            }
+            size_t first_run = 0;
+            if (previous_ends_with_change && part.starts_with_change && delta.runs.back().inserted == part.runs[0].inserted) {
+                delta.runs.back().length += part.runs[0].length;
+                first_run = 1;
+            }
+            delta.runs.insert(delta.runs.end(), part.runs.begin() + first_run, part.runs.end());
+            delta.keys.insert(delta.keys.end(), part.keys.begin(), part.keys.end());
+            previous_ends_with_change = part.ends_with_change;
+        }
+        return delta;
+    }
+
+    /**
+     * @brief Serializes a delta into the binary format described above.
+     */
+    inline std::vector<uint8_t> encodeDatasetDelta(const DatasetDelta& delta) {
+        std::vector<uint8_t> out;
+        out.reserve(56 + delta.runs.size() * 2 + delta.keys.size() * 2);
+        for (int i = 0; i < 8; ++i) out.push_back(static_cast<uint8_t>(DATASET_DELTA_MAGIC[i]));
+        detail::putU64(out, delta.base_count);
+        detail::putU64(out, delta.base_checksum);
+        detail::putU64(out, delta.target_count);
+        detail::putU64(out, delta.target_checksum);
+        detail::putU64(out, delta.runs.size());
+        detail::putU64(out, delta.keys.size());
+        long long previous = 0;
+        size_t k = 0;
+        for (const DeltaRun& run : delta.runs) {
+            detail::putVarint(out, (static_cast<uint64_t>(run.length) << 1) | (run.inserted ? 1 : 0));
+            for (uint32_t i = 0; i < run.length; ++i, ++k) {
+                long long key = delta.keys[k];
+                if (i == 0) {
+                    long long difference = key - previous;
+                    detail::putVarint(out, difference >= 0 ? static_cast<uint64_t>(difference) << 1 : (static_cast<uint64_t>(-difference) << 1) - 1);
+                }
+                else {
+                    detail::putVarint(out, static_cast<uint64_t>(key - previous - 1));
+                }
+                previous = key;
+            }
+        }
+        return out;
+    }
+
+    /**
+     * @brief Parses a delta written by encodeDatasetDelta and checks that it is consistent.
+     *
+     * @return True on success; false (with a message on std::cerr) if the bytes are not a valid delta.
+     */
+    inline bool decodeDatasetDelta(const uint8_t* data, size_t size, DatasetDelta& delta) {
+        delta = DatasetDelta();
+        const uint8_t* in = data;
+        const uint8_t* end = data + size;
+        uint64_t num_runs = 0, num_keys = 0;
+        if (size < 8 || std::memcmp(in, DATASET_DELTA_MAGIC, 8) != 0) {
+            std::cerr << "Error: Not a dataset delta (bad magic).\n";
+            return false;
+        }
+        in += 8;
+        if (!detail::getU64(in, end, delta.base_count) || !detail::getU64(in, end, delta.base_checksum)
+            || !detail::getU64(in, end, delta.target_count) || !detail::getU64(in, end, delta.target_checksum)
+            || !detail::getU64(in, end, num_runs) || !detail::getU64(in, end, num_keys)
+            || num_runs > num_keys || num_keys > static_cast<uint64_t>(end - in)) { // Every key takes at least one byte.
+            std::cerr << "Error: Truncated or corrupt dataset delta header.\n";
+            return false;
+        }
+        delta.runs.reserve(static_cast<size_t>(num_runs));
+        delta.keys.reserve(static_cast<size_t>(num_keys));
+        long long previous = 0;
+        uint64_t inserted = 0;
+        uint64_t checksum = delta.base_checksum;
+        for (uint64_t r = 0; r < num_runs; ++r) {
+            uint64_t header = 0;
+            if (!detail::getVarint(in, end, header) || (header >> 1) == 0 || (header >> 1) > num_keys - delta.keys.size()) {
+                std::cerr << "Error: Corrupt run header in dataset delta.\n";
+                return false;
+            }
+            DeltaRun run;
+            run.inserted = (header & 1) != 0;
+            run.length = static_cast<uint32_t>(header >> 1);
+            for (uint32_t i = 0; i < run.length; ++i) {
+                uint64_t value = 0;
+                if (!detail::getVarint(in, end, value)) {
+                    std::cerr << "Error: Truncated dataset delta.\n";
+                    return false;
+                }
+                long long key = i == 0 ? previous + ((value & 1) ? -static_cast<long long>((value + 1) >> 1) : static_cast<long long>(value >> 1))
+                                       : previous + 1 + static_cast<long long>(value);
+                if (key < INT32_MIN || key > INT32_MAX || (!delta.keys.empty() && key <= previous)) {
+                    std::cerr << "Error: Dataset delta keys are out of range or not ascending.\n";
+                    return false;
+                }
+                delta.keys.push_back(static_cast<int>(key));
+                previous = key;
+                if (run.inserted) checksum += detail::mixKey(static_cast<int>(key));
+                else checksum -= detail::mixKey(static_cast<int>(key));
+            }
+            inserted += run.inserted ? run.length : 0;
+            delta.runs.push_back(run);
+        }
+        uint64_t deleted = num_keys - inserted;
+        if (delta.keys.size() != num_keys || in != end || deleted > delta.base_count
+            || delta.base_count - deleted + inserted != delta.target_count || checksum != delta.target_checksum) {
+            std::cerr << "Error: Dataset delta is inconsistent (counts or checksums do not add up).\n";
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Writes the encoded delta to a binary file.
+     */
+    inline bool writeDatasetDeltaFile(const DatasetDelta& delta, const std::string& filename) {
+        std::ofstream file(filename, std::ios::binary);
+        if (!file.is_open()) {
+            std::cerr << "Error: Could not open file '" << filename << "' for writing.\n";
+            return false;
+        }
+        std::vector<uint8_t> bytes = encodeDatasetDelta(delta);
+        file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+        return static_cast<bool>(file);
+    }
+
+    /**
+     * @brief Reads and decodes a delta file written by writeDatasetDeltaFile.
+     */
+    inline bool readDatasetDeltaFile(DatasetDelta& delta, const std::string& filename) {
+        std::ifstream file(filename, std::ios::binary);
+        if (!file.is_open()) {
+            std::cerr << "Error: Could not open file '" << filename << "'. Please check the path and verify it is valid.\n";
+            return false;
+        }
+        std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+        return decodeDatasetDelta(bytes.data(), bytes.size(), delta);
+    }
+
+    /**
+     * @brief Applies a delta in place to a sorted dataset held in a caller-owned buffer.
+     *
+     * The buffer can be any memory, such as a shared-memory segment; nothing is allocated in it.
+     * Nothing is written unless the whole delta matches the dataset.
+     *
+     * @param keys The dataset's sorted keys; the buffer has room for 'capacity' keys.
+     * @param count The number of keys in the dataset; must equal the delta's base count.
+     * @param new_count Receives the number of keys after the apply.
+     * @return True on success; false (with a message on std::cerr) if the delta does not match or does not fit.
+     */
+    inline bool applyDatasetDelta(const DatasetDelta& delta, int* keys, size_t count, size_t capacity, size_t& new_count) {
+        if (count != delta.base_count) {
+            std::cerr << "Error: The delta was made for " << delta.base_count << " keys, but the dataset has " << count << ".\n";
+            return false;
+        }
+        if (delta.target_count > capacity) {
+            std::cerr << "Error: The patched dataset needs room for " << delta.target_count << " keys, but the buffer holds " << capacity << ".\n";
+            return false;
+        }
+
+        // Locate and check every change before moving anything.
+        std::vector<size_t> deleted_at, inserted_at;
+        std::vector<int> inserted_keys;
+        size_t position = 0;
+        size_t k = 0;
+        for (const DeltaRun& run : delta.runs) {
+            for (uint32_t i = 0; i < run.length; ++i, ++k) {
+                int key = delta.keys[k];
+                size_t step = 1, hi = position; // Gallop from the previous change, which is smaller.
+                while (hi < count && keys[hi] < key) {
+                    position = hi + 1;
+                    hi += step;
+                    step *= 2;
+                }
+                position = static_cast<size_t>(std::lower_bound(keys + position, keys + std::min(hi, count), key) - keys);
+                bool present = position < count && keys[position] == key;
+                if (present == run.inserted) {
+                    std::cerr << "Error: The delta does not match the dataset: key " << key << " is "
+                        << (present ? "already present" : "missing") << ".\n";
+                    return false;
+                }
+                if (run.inserted) {
+                    inserted_at.push_back(position);
+                    inserted_keys.push_back(key);
+                }
+                else {
+                    deleted_at.push_back(position);
+                }
+            }
+        }
+
+        // Pass 1: close the gaps left by deleted keys, front to back.
+        size_t write = deleted_at.empty() ? count : deleted_at[0];
+        for (size_t d = 0; d < deleted_at.size(); ++d) {
+            size_t from = deleted_at[d] + 1;
+            size_t to = d + 1 < deleted_at.size() ? deleted_at[d + 1] : count;
+            std::memmove(keys + write, keys + from, (to - from) * sizeof(int));
+            write += to - from;
+        }
+        size_t middle = write;
+
+        // Pass 2: open gaps for inserted keys, back to front. A base position p is now p minus the deletions before it.
+        size_t read_end = middle, write_end = middle + inserted_at.size();
+        size_t d = deleted_at.size();
+        for (size_t j = inserted_at.size(); j-- > 0;) {
+            while (d > 0 && deleted_at[d - 1] >= inserted_at[j]) --d;
+            size_t at = inserted_at[j] - d;
+            write_end -= read_end - at;
+            std::memmove(keys + write_end, keys + at, (read_end - at) * sizeof(int));
+            keys[--write_end] = inserted_keys[j];
+            read_end = at;
+        }
+        new_count = middle + inserted_at.size();
+        return true;
+    }
+
+    /**
+     * @brief Applies a delta to a dataset vector in place (resizing it, never re-sorting it).
+     */
+    inline bool applyDatasetDelta(const DatasetDelta& delta, std::vector<int>& dataset) {
+        size_t count = dataset.size();
+        if (count != delta.base_count) {
+            std::cerr << "Error: The delta was made for " << delta.base_count << " keys, but the dataset has " << count << ".\n";
+            return false;
+        }
+        if (delta.target_count > count) dataset.resize(static_cast<size_t>(delta.target_count));
+        size_t new_count = 0;
+        if (!applyDatasetDelta(delta, dataset.data(), count, dataset.size(), new_count)) {
+            dataset.resize(count);
+            return false;
+        }
+        dataset.resize(new_count);
+        return true;
+    }
+
+} // namespace ProjectUtils
+
+#endif // DATASET_DELTA_H
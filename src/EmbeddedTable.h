@@ -0,0 +1,101 @@
+#ifndef EMBEDDED_TABLE_H
+#define EMBEDDED_TABLE_H
+
+#include "SearchLayouts.h" // For SearchLayout and the layout search routines.
+
+/*
+Support code for datasets that are embedded into the executable at build time.
+
+The `embed_dataset_table` CMake function runs the GenerateEmbeddedTable tool on a data file.
+The tool sorts and de-duplicates the file exactly like `loadAndSortDatasetFromFile`, lays the
+keys out in the requested SearchLayout and writes a header declaring:
+
+    namespace ProjectUtils { namespace EmbeddedTables {
+        struct <Name> {
+            static constexpr SearchLayout layout = ...;
+            static constexpr int size = ...;       // Number of unique keys.
+            static constexpr int slots = ...;      // Number of entries in keys().
+            static constexpr int min_key = ...;
+            static constexpr int max_key = ...;
+            static constexpr double slope = ...;   // (size - 1) / (max_key - min_key).
+            static constexpr const int* keys();
+            static constexpr const int* ranks();   // Slot -> sorted index (nullptr for Sorted).
+        };
+    } }
+
+The arrays live in read-only data, so there is nothing to load or sort at startup, and
+`embeddedSearch<Table>` is specialized at compile time on the table's metadata.
+*/
+
+namespace ProjectUtils {
+
+    namespace detail {
+        // Exponential search outwards from an interpolated guess, then a binary search of the bracket.
+        template<typename Table>
+        int embeddedSortedSearch(int target) {
+            const int* keys = Table::keys();
+            const int n = Table::size;
+            int guess = static_cast<int>((static_cast<double>(target) - Table::min_key) * Table::slope);
+            guess = guess < 0 ? 0 : (guess >= n ? n - 1 : guess);
+
+            int lo, hi; // The target lies in keys[lo, hi).
+            if (keys[guess] < target) {
+                int step = 1;
+                lo = guess + 1;
+                hi = lo + step;
+                while (hi < n && keys[hi - 1] < target) {
+                    lo = hi;
+                    step *= 2;
+                    hi = lo + step;
+                }
+                hi = hi < n ? hi : n;
+            }
+            else {
+                int step = 1;
+                hi = guess + 1;
+                lo = hi - step;
+                while (lo > 0 && keys[lo] > target) {
+                    hi = lo;
+                    step *= 2;
+                    lo = hi - step;
+                }
+                lo = lo > 0 ? lo : 0;
+            }
+            while (lo < hi) {
+                int mid = lo + (hi - lo) / 2;
+                if (keys[mid] < target) lo = mid + 1;
+                else hi = mid;
+            }
+            return (lo < n && keys[lo] == target) ? lo : -1;
+        }
+    }
+
+    /**
+     * @brief Searches a build-time embedded table.
+     *
+     * The layout branch and the min/max bounds are compile-time constants, so the compiler
+     * keeps only the code for the table's own layout.
+     *
+     * @tparam Table A table type generated by GenerateEmbeddedTable.
+     * @param target The value to search for.
+     * @return The index of the target in sorted order if found, otherwise -1.
+     */
+    template<typename Table>
+    int embeddedSearch(int target) {
+        if (Table::size == 0 || target < Table::min_key || target > Table::max_key) {
+            return -1; // Outside the table's key range.
+        }
+        if (Table::layout == SearchLayout::Eytzinger) {
+            int slot = eytzingerLowerBoundSlot(Table::keys(), Table::size, target);
+            return (slot != 0 && Table::keys()[slot] == target) ? Table::ranks()[slot] : -1;
+        }
+        if (Table::layout == SearchLayout::BTree) {
+            int slot = bTreeLowerBoundSlot(Table::keys(), Table::slots / BTREE_NODE_KEYS, target);
+            return (slot != -1 && Table::keys()[slot] == target) ? Table::ranks()[slot] : -1;
+        }
+        return detail::embeddedSortedSearch<Table>(target);
+    }
+
+} // namespace ProjectUtils
+
+#endif // EMBEDDED_TABLE_H
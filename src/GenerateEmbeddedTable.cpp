@@ -0,0 +1,106 @@
+#include "ProjectUtils.h"
+#include "SearchLayouts.h"
+#include <climits>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+/*
+Build-time tool that converts a data file into a C++ header holding a constexpr search table.
+It is run by the `embed_dataset_table` CMake function; see EmbeddedTable.h for the generated API.
+
+Usage: GenerateEmbeddedTable <input file> <output header> <TableName> <sorted|eytzinger|btree>
+*/
+
+// Formats an int as a C++ literal. INT_MIN has no literal of type int, so it is spelled as an expression.
+static std::string intLiteral(int value) {
+    return value == INT_MIN ? "(-2147483647 - 1)" : std::to_string(value);
+}
+
+// Writes 'values' as the body of a constexpr int array, 16 values per line.
+static void writeIntArray(std::ofstream& out, const std::string& name, const std::vector<int>& values) {
+    out << "        constexpr int " << name << "[] = {";
+    for (size_t i = 0; i < values.size(); ++i) {
+        if (i % 16 == 0) out << "\n            ";
+        out << intLiteral(values[i]) << (i + 1 < values.size() ? "," : "");
+    }
+    out << "\n        };\n";
+}
+
+int main(int argc, char* argv[]) {
+    if (argc != 5) {
+        std::cerr << "Usage: GenerateEmbeddedTable <input file> <output header> <TableName> <sorted|eytzinger|btree>\n";
+        return 1;
+    }
+    const std::string input = argv[1];
+    const std::string output = argv[2];
+    const std::string name = argv[3];
+    ProjectUtils::SearchLayout layout;
+    if (!ProjectUtils::parseSearchLayout(argv[4], layout)) {
+        std::cerr << "Error: Unknown layout '" << argv[4] << "'. Expected sorted, eytzinger or btree.\n";
+        return 1;
+    }
+
+    // Presort and dedupe with the same loader the application uses at runtime.
+    std::vector<int> sorted;
+    if (!ProjectUtils::loadAndSortDatasetFromFile(sorted, input)) {
+        std::cerr << "Error: Cannot embed '" << input << "' because it holds no valid data.\n";
+        return 1;
+    }
+
+    std::vector<int> keys;
+    std::vector<int> ranks;
+    if (layout == ProjectUtils::SearchLayout::Eytzinger) {
+        ProjectUtils::buildEytzingerLayout(sorted, keys, ranks);
+    }
+    else if (layout == ProjectUtils::SearchLayout::BTree) {
+        ProjectUtils::buildBTreeLayout(sorted, keys, ranks);
+    }
+    else {
+        keys = sorted;
+    }
+
+    const int min_key = sorted.front();
+    const int max_key = sorted.back();
+    const double slope = (max_key == min_key) ? 0.0
+        : static_cast<double>(sorted.size() - 1) / (static_cast<double>(max_key) - min_key);
+
+    std::ofstream out(output);
+    if (!out.is_open()) {
+        std::cerr << "Error: Could not open output file '" << output << "'.\n";
+        return 1;
+    }
+    out.precision(17); // Round-trip the slope exactly.
+
+    const std::string guard = "EMBEDDED_TABLE_" + name + "_H";
+    const std::string layout_enum = layout == ProjectUtils::SearchLayout::Eytzinger ? "Eytzinger"
+        : (layout == ProjectUtils::SearchLayout::BTree ? "BTree" : "Sorted");
+
+    out << "// Generated by GenerateEmbeddedTable from '" << input << "'. Do not edit.\n"
+        << "#ifndef " << guard << "\n#define " << guard << "\n\n"
+        << "#include \"EmbeddedTable.h\"\n\n"
+        << "namespace ProjectUtils {\n    namespace EmbeddedTables {\n\n";
+    writeIntArray(out, name + "Keys", keys);
+    if (!ranks.empty()) {
+        out << "\n";
+        writeIntArray(out, name + "Ranks", ranks);
+    }
+    out << "\n        struct " << name << " {\n"
+        << "            static constexpr SearchLayout layout = SearchLayout::" << layout_enum << ";\n"
+        << "            static constexpr int size = " << sorted.size() << ";\n"
+        << "            static constexpr int slots = " << keys.size() << ";\n"
+        << "            static constexpr int min_key = " << intLiteral(min_key) << ";\n"
+        << "            static constexpr int max_key = " << intLiteral(max_key) << ";\n"
+        << "            static constexpr double slope = " << slope << ";\n"
+        << "            static constexpr const int* keys() { return " << name << "Keys; }\n"
+        << "            static constexpr const int* ranks() { return "
+        << (ranks.empty() ? std::string("nullptr") : name + "Ranks") << "; }\n"
+        << "        };\n\n"
+        << "    } // namespace EmbeddedTables\n} // namespace ProjectUtils\n\n"
+        << "#endif // " << guard << "\n";
+
+    std::cout << "Embedded table '" << name << "' written to '" << output << "' (" << ProjectUtils::searchLayoutName(layout)
+        << " layout, " << sorted.size() << " keys).\n";
+    return 0;
+}
@@ -0,0 +1,318 @@
+#ifndef HOT_KEY_CACHE_H
+#define HOT_KEY_CACHE_H
+
+#include "SearchIndex.h" // For wrapping any registered index.
+#include <vector>
+#include <string>
+#include <atomic>
+#include <memory>
+#include <cstdint>
+#include <climits>
+#include <algorithm>
+#include <new> // For placement new of the aligned sets.
+
+/*
+Hot-key front cache for skewed (e.g. Zipf-distributed) query streams.
+
+A small set-associative table sits in front of a search index and remembers the answer for
+recently requested hot keys:
+
+    - Each set is one 64-byte cache line holding HOT_CACHE_WAYS entries. An entry packs the key
+      and its answer into one 64-bit word, so a hot key costs one hash and one L1 line.
+    - Readers never lock. They load each entry atomically, so they always see a whole
+      (key, answer) pair, never half of one.
+    - Admission is frequency based (TinyLFU-style). A count-min sketch of small saturating
+      counters (capped at 15) records a sample of every lookup, hits and misses alike, so
+      resident hot keys keep their counts. When its set is full, a key replaces one
+      pseudo-randomly chosen way only if it has been seen more often than that way's key, so
+      one-off keys do not evict hot keys. The sketch is halved periodically so old popularity
+      fades. Admission swaps the entry in with a compare-exchange; nothing on the lookup path
+      takes a lock.
+    - Hit and miss counts live in per-thread stripes (one cache line each) and are summed when
+      read, so readers do not bounce a shared line between cores.
+    - The answer is an opaque int; CachedSearchIndex stores the index or -1.
+    - clear() invalidates everything; CachedSearchIndex calls it whenever it is rebuilt over a
+      new dataset.
+*/
+
+namespace ProjectUtils {
+
+    // Entries per set: 8 x 8 bytes fill one 64-byte cache line.
+    const int HOT_CACHE_WAYS = 8;
+    // One lookup in this many (hits and misses alike, per thread) is recorded in the admission sketch.
+    const unsigned HOT_CACHE_SKETCH_SAMPLE = 8;
+    // Threads beyond this many share statistics stripes, and their hit/miss counts become approximate.
+    const size_t HOT_CACHE_STAT_STRIPES = 16;
+
+    /**
+     * @brief Set-associative, frequency-admitted cache from key to search result.
+     */
+    class HotKeyCache {
+    public:
+        /**
+         * @param capacity Number of entries, rounded up to a power-of-two number of sets.
+         */
+        explicit HotKeyCache(size_t capacity = 4096) : admissions(0), samples(0) {
+            size_t sets = 1;
+            while (sets * HOT_CACHE_WAYS < capacity) sets *= 2;
+            set_bits = 0;
+            while ((size_t(1) << set_bits) < sets) ++set_bits;
+            // C++14 operator new does not honour alignas(64), so align the sets and stripes by hand.
+            storage.reset(new unsigned char[sets * sizeof(CacheSet) + HOT_CACHE_STAT_STRIPES * sizeof(StatStripe) + 64]);
+            uintptr_t address = (reinterpret_cast<uintptr_t>(storage.get()) + 63) & ~uintptr_t(63);
+            table = new (reinterpret_cast<void*>(address)) CacheSet[sets];
+            stripes = new (reinterpret_cast<void*>(address + sets * sizeof(CacheSet))) StatStripe[HOT_CACHE_STAT_STRIPES];
+            num_sets = sets;
+            sketch_size = 64;
+            while (sketch_size < sets * HOT_CACHE_WAYS * 4) sketch_size *= 2;
+            sketch.reset(new std::atomic<uint8_t>[sketch_size]);
+            clear();
+        }
+        HotKeyCache(const HotKeyCache&) = delete;
+        HotKeyCache& operator=(const HotKeyCache&) = delete;
+
+        /**
+         * @brief Looks 'key' up without taking any lock.
+         *
+         * Hits and misses are counted in the calling thread's statistics stripe, and every
+         * HOT_CACHE_SKETCH_SAMPLE-th lookup of the thread is recorded in the admission sketch,
+         * so a hot resident key keeps its frequency.
+         *
+         * @param result Receives the cached answer on a hit.
+         * @return true on a hit.
+         */
+        bool lookup(int key, int& result) const {
+            StatStripe& stripe = stripes[threadStripe()];
+            unsigned tick = stripe.ticks.load(std::memory_order_relaxed) + 1;
+            stripe.ticks.store(tick, std::memory_order_relaxed);
+            if (tick % HOT_CACHE_SKETCH_SAMPLE == 0) recordInSketch(key);
+
+            // Compare all ways without branching. At most one way holds the key, and an empty way
+            // contributes nothing (entry ^ EMPTY_ENTRY is 0), so 'found' is 0 on a miss.
+            const CacheSet& set = table[setOf(key)];
+            uint64_t found = 0;
+            for (int way = 0; way < HOT_CACHE_WAYS; ++way) {
+                uint64_t entry = set.entries[way].load(std::memory_order_relaxed);
+                found |= (entry ^ EMPTY_ENTRY) & (uint64_t(0) - static_cast<uint64_t>(keyOf(entry) == key));
+            }
+            if (found != 0) {
+                result = resultOf(found ^ EMPTY_ENTRY);
+                stripe.hits.store(stripe.hits.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                return true;
+            }
+            stripe.misses.store(stripe.misses.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            return false;
+        }
+
+        /**
+         * @brief Offers the answer for a key that just missed. It is stored only if the key is
+         *        more frequent than the entry it would replace.
+         *
+         * Lock-free: the entry is swapped in with a compare-exchange, and the offer is dropped
+         * if another thread changed that way first.
+         */
+        void admit(int key, int result) {
+            // Take an empty way if there is one, otherwise challenge one way picked by the key's hash.
+            CacheSet& set = table[setOf(key)];
+            int victim = -1;
+            uint64_t current = EMPTY_ENTRY;
+            for (int way = 0; way < HOT_CACHE_WAYS; ++way) {
+                uint64_t entry = set.entries[way].load(std::memory_order_relaxed);
+                if (entry == EMPTY_ENTRY) {
+                    if (victim < 0) victim = way;
+                }
+                else if (keyOf(entry) == key) {
+                    return; // Admitted by another thread meanwhile.
+                }
+            }
+            if (victim < 0) {
+                StatStripe& stripe = stripes[threadStripe()];
+                victim = static_cast<int>(mix(key, stripe.ticks.load(std::memory_order_relaxed)) % HOT_CACHE_WAYS);
+                current = set.entries[victim].load(std::memory_order_relaxed);
+                if (estimate(key) <= estimate(keyOf(current))) return;
+            }
+            if (set.entries[victim].compare_exchange_strong(current, pack(key, result), std::memory_order_relaxed)) {
+                admissions.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+
+        /**
+         * @brief Drops every entry and the frequency history, e.g. after a dataset swap.
+         *
+         * Not safe against concurrent lookups; call it while the cache is not in use.
+         */
+        void clear() {
+            for (size_t s = 0; s < num_sets; ++s) {
+                for (int way = 0; way < HOT_CACHE_WAYS; ++way) table[s].entries[way].store(EMPTY_ENTRY, std::memory_order_relaxed);
+            }
+            for (size_t i = 0; i < sketch_size; ++i) sketch[i].store(0, std::memory_order_relaxed);
+            samples.store(0, std::memory_order_relaxed);
+            resetStats();
+        }
+
+        void resetStats() {
+            for (size_t i = 0; i < HOT_CACHE_STAT_STRIPES; ++i) {
+                stripes[i].hits.store(0, std::memory_order_relaxed);
+                stripes[i].misses.store(0, std::memory_order_relaxed);
+            }
+            admissions.store(0, std::memory_order_relaxed);
+        }
+
+        unsigned long long hitCount() const {
+            unsigned long long total = 0;
+            for (size_t i = 0; i < HOT_CACHE_STAT_STRIPES; ++i) total += stripes[i].hits.load(std::memory_order_relaxed);
+            return total;
+        }
+
+        unsigned long long missCount() const {
+            unsigned long long total = 0;
+            for (size_t i = 0; i < HOT_CACHE_STAT_STRIPES; ++i) total += stripes[i].misses.load(std::memory_order_relaxed);
+            return total;
+        }
+
+        unsigned long long admissionCount() const { return admissions.load(std::memory_order_relaxed); }
+
+        double hitRate() const {
+            unsigned long long hit = hitCount(), total = hit + missCount();
+            return total ? static_cast<double>(hit) / total : 0.0;
+        }
+
+        size_t capacity() const { return num_sets * HOT_CACHE_WAYS; }
+
+        // Bytes held by the table, the statistics stripes and the admission sketch.
+        size_t memoryBytes() const { return num_sets * sizeof(CacheSet) + HOT_CACHE_STAT_STRIPES * sizeof(StatStripe) + sketch_size; }
+
+    private:
+        struct alignas(64) CacheSet {
+            std::atomic<uint64_t> entries[HOT_CACHE_WAYS];
+        };
+
+        // Per-thread counters, one cache line each, so lookups never share a written line.
+        struct alignas(64) StatStripe {
+            std::atomic<unsigned long long> hits;
+            std::atomic<unsigned long long> misses;
+            std::atomic<unsigned> ticks; // Lookups of this thread, for sketch sampling.
+        };
+
+        // Answers are never INT_MIN, so (key 0, answer INT_MIN) can mark an empty slot.
+        static constexpr uint64_t EMPTY_ENTRY = static_cast<uint64_t>(static_cast<uint32_t>(INT_MIN));
+
+        static uint64_t pack(int key, int result) {
+            return (static_cast<uint64_t>(static_cast<uint32_t>(key)) << 32) | static_cast<uint32_t>(result);
+        }
+        static int keyOf(uint64_t entry) { return static_cast<int>(static_cast<uint32_t>(entry >> 32)); }
+        static int resultOf(uint64_t entry) { return static_cast<int>(static_cast<uint32_t>(entry)); }
+
+        static uint32_t mix(int key, uint32_t salt) {
+            uint32_t h = static_cast<uint32_t>(key) * 0x9E3779B1u + salt;
+            h ^= h >> 15;
+            h *= 0x85EBCA77u;
+            h ^= h >> 13;
+            return h;
+        }
+
+        // Stripe of the calling thread: threads are numbered in order of their first lookup.
+        static size_t threadStripe() {
+            static std::atomic<size_t> next_thread(0);
+            static thread_local size_t stripe_plus_one = 0; // Constant-initialized, so no guard on each call.
+            if (stripe_plus_one == 0) stripe_plus_one = next_thread.fetch_add(1, std::memory_order_relaxed) % HOT_CACHE_STAT_STRIPES + 1;
+            return stripe_plus_one - 1;
+        }
+
+        size_t setOf(int key) const {
+            return set_bits == 0 ? 0 : static_cast<size_t>(mix(key, 0) >> (32 - set_bits));
+        }
+
+        // The four sketch counters of 'key', by double hashing.
+        void sketchSlots(int key, size_t slots[4]) const {
+            uint32_t h1 = mix(key, 0x7F4A7C15u), h2 = mix(key, 0x2545F491u) | 1u;
+            size_t mask = sketch_size - 1;
+            for (uint32_t i = 0; i < 4; ++i) slots[i] = (h1 + i * h2) & mask;
+        }
+
+        // Count-min estimate: the smallest of the key's counters.
+        unsigned estimate(int key) const {
+            size_t slots[4];
+            sketchSlots(key, slots);
+            unsigned lowest = sketch[slots[0]].load(std::memory_order_relaxed);
+            for (int i = 1; i < 4; ++i) lowest = std::min<unsigned>(lowest, sketch[slots[i]].load(std::memory_order_relaxed));
+            return lowest;
+        }
+
+        // Counts one sampled occurrence of 'key'; halves all counters once enough samples were taken.
+        // Concurrent increments of one counter may be lost, which only makes the estimate a little low.
+        void recordInSketch(int key) const {
+            size_t slots[4];
+            sketchSlots(key, slots);
+            for (int i = 0; i < 4; ++i) {
+                uint8_t counter = sketch[slots[i]].load(std::memory_order_relaxed);
+                if (counter < 15) sketch[slots[i]].store(static_cast<uint8_t>(counter + 1), std::memory_order_relaxed);
+            }
+            size_t period = sketch_size * 4;
+            if (samples.fetch_add(1, std::memory_order_relaxed) + 1 == period) {
+                for (size_t i = 0; i < sketch_size; ++i) {
+                    sketch[i].store(static_cast<uint8_t>(sketch[i].load(std::memory_order_relaxed) >> 1), std::memory_order_relaxed);
+                }
+                samples.fetch_sub(period, std::memory_order_relaxed);
+            }
+        }
+
+        std::unique_ptr<unsigned char[]> storage;
+        CacheSet* table;     // Points into 'storage', aligned to a cache line.
+        StatStripe* stripes; // HOT_CACHE_STAT_STRIPES entries after the table.
+        size_t num_sets;
+        int set_bits;
+        std::unique_ptr<std::atomic<uint8_t>[]> sketch;
+        size_t sketch_size;
+        std::atomic<unsigned long long> admissions;
+        mutable std::atomic<size_t> samples; // Sketch samples since the last halving.
+    };
+
+    /**
+     * @brief Puts a HotKeyCache in front of any SearchIndex.
+     *
+     * Rebuilding over a new dataset clears the cache, so answers from the old dataset are never returned.
+     */
+    class CachedSearchIndex : public SearchIndex {
+    public:
+        CachedSearchIndex(std::unique_ptr<SearchIndex> inner, size_t capacity) : inner(std::move(inner)), cache(capacity) {}
+
+        std::string name() const override { return "cached-" + inner->name(); }
+
+        void build(const std::vector<int>& sorted) override {
+            inner->build(sorted);
+            cache.clear();
+        }
+
+        int search(int target) const override {
+            int result;
+            if (cache.lookup(target, result)) return result;
+            result = inner->search(target);
+            cache.admit(target, result);
+            return result;
+        }
+
+        size_t memoryBytes() const override { return inner->memoryBytes() + cache.memoryBytes(); }
+
+        const HotKeyCache& hotKeyCache() const { return cache; }
+        HotKeyCache& hotKeyCache() { return cache; }
+
+    private:
+        std::unique_ptr<SearchIndex> inner;
+        mutable HotKeyCache cache; // Admission updates the cache from the const search path.
+    };
+
+    /**
+     * @brief Creates a registered index wrapped in a hot-key cache.
+     *
+     * @return The new index, or nullptr if the name is unknown.
+     */
+    inline std::unique_ptr<CachedSearchIndex> createCachedSearchIndex(const std::string& name, size_t capacity = 4096) {
+        std::unique_ptr<SearchIndex> inner = createSearchIndex(name);
+        if (!inner) return nullptr;
+        return std::unique_ptr<CachedSearchIndex>(new CachedSearchIndex(std::move(inner), capacity));
+    }
+
+} // namespace ProjectUtils
+
+#endif // HOT_KEY_CACHE_H
@@ -0,0 +1,565 @@
+#ifndef LEARNED_INDEX_H
+#define LEARNED_INDEX_H
+
+#include <vector>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <algorithm>
+
+/*
+An updatable learned index in the style of ALEX.
+
+    - Data nodes (leaves) are gapped arrays. A linear model maps a key to its slot, and keys are
+      placed at (or as close as possible to) their predicted slot at build time, so a lookup is
+      a model prediction followed by a short exponential search. Gaps hold a copy of the next
+      key to their right, which keeps the whole array sorted and searchable; a bitmap tells
+      real keys from gap fillers.
+    - Inserts go into the gap run at the key's position, or shift keys towards the nearest gap.
+    - Internal nodes route a key with their own linear model: child = model(key). Several
+      consecutive child slots may point at the same data node.
+    - When a data node reaches MAX_DENSITY it is either expanded (bigger gapped array, model
+      retrained) or split. The choice follows ALEX's cost model: each node records the
+      exponential-search steps and shifts its inserts actually needed; if that cost has drifted well
+      above what its model predicted when it was built (or the node has grown too large), the
+      node is split, otherwise it is expanded. Splits go sideways into the parent when the node
+      owns several parent slots, double the parent's fanout when it owns one, and go downwards
+      (a new internal node) once the parent has reached MAX_FANOUT.
+
+Leaves are linked in key order for range scans. Lookups (contains, rangeScan) do not write
+anything, not even the cost statistics, so they may run concurrently with each other; inserts
+and erases need exclusive access.
+*/
+
+namespace ProjectUtils {
+
+    /**
+     * @brief ALEX-style updatable learned index over unique int keys.
+     */
+    class UpdatableLearnedIndex {
+    public:
+        // Fill factor a data node is built at, and the fill factor that triggers expand/split.
+        static constexpr double INITIAL_DENSITY = 0.7;
+        static constexpr double MAX_DENSITY = 0.8;
+        static constexpr double MIN_DENSITY = 0.2;
+        // Keys per data node at bulk load, and the size above which nodes split instead of expanding.
+        static constexpr int TARGET_LEAF_KEYS = 1024;
+        static constexpr int MAX_LEAF_KEYS = 1 << 15;
+        static constexpr int MAX_FANOUT = 1 << 16;
+
+        UpdatableLearnedIndex() : root(nullptr), num_keys(0) { bulkLoad(std::vector<int>()); }
+        ~UpdatableLearnedIndex() { destroy(root); }
+        UpdatableLearnedIndex(const UpdatableLearnedIndex&) = delete;
+        UpdatableLearnedIndex& operator=(const UpdatableLearnedIndex&) = delete;
+
+        /**
+         * @brief Replaces the contents with a sorted, de-duplicated dataset.
+         */
+        void bulkLoad(const std::vector<int>& sorted) {
+            loadWithDomain(sorted, sorted.empty() ? 0 : sorted.front(), sorted.empty() ? 0 : sorted.back());
+        }
+
+        /**
+         * @brief Returns true if 'key' is present.
+         */
+        bool contains(int key) const {
+            DataNode* leaf = findLeaf(key, nullptr, nullptr);
+            int slot = leaf->findSlot(key);
+            return slot >= 0;
+        }
+
+        /**
+         * @brief Inserts 'key'. Returns false if it was already present.
+         */
+        bool insert(int key) {
+            InternalNode* parent = nullptr;
+            int parent_slot = 0;
+            expandRootFor(key);
+            DataNode* leaf = findLeaf(key, &parent, &parent_slot);
+            if (!leaf->insert(key)) return false;
+            ++num_keys;
+            if (leaf->num_keys >= MAX_DENSITY * leaf->capacity()) {
+                handleFullNode(leaf, parent, parent_slot);
+            }
+            return true;
+        }
+
+        /**
+         * @brief Removes 'key'. Returns false if it was not present.
+         */
+        bool erase(int key) {
+            DataNode* leaf = findLeaf(key, nullptr, nullptr);
+            if (!leaf->erase(key)) return false;
+            --num_keys;
+            if (leaf->capacity() > 64 && leaf->num_keys < MIN_DENSITY * leaf->capacity()) {
+                leaf->rebuild(leaf->collectKeys()); // Contract to the initial density.
+            }
+            return true;
+        }
+
+        /**
+         * @brief Appends every key in [lo, hi] to 'out' in ascending order.
+         *
+         * @return The number of keys appended.
+         */
+        size_t rangeScan(int lo, int hi, std::vector<int>& out) const {
+            if (lo > hi) return 0;
+            size_t before = out.size();
+            DataNode* leaf = findLeaf(lo, nullptr, nullptr);
+            int slot = leaf->lowerBound(lo);
+            while (leaf) {
+                for (slot = leaf->nextOccupied(slot); slot >= 0; slot = leaf->nextOccupied(slot + 1)) {
+                    if (leaf->keys[slot] > hi) return out.size() - before;
+                    out.push_back(leaf->keys[slot]);
+                }
+                leaf = leaf->next;
+                slot = 0;
+            }
+            return out.size() - before;
+        }
+
+        size_t size() const { return num_keys; }
+
+        // Bytes held by all nodes (gapped arrays, bitmaps and child pointers).
+        size_t memoryBytes() const { return memoryOf(root); }
+
+        // Number of data nodes and the depth of the deepest one, for reports.
+        void shape(size_t& data_nodes, int& depth) const {
+            data_nodes = 0;
+            depth = 0;
+            for (DataNode* leaf = firstLeaf(); leaf; leaf = leaf->next) ++data_nodes;
+            depth = depthOf(root);
+        }
+
+    private:
+        struct Node {
+            explicit Node(bool is_leaf) : is_leaf(is_leaf) {}
+            virtual ~Node() {}
+            bool is_leaf;
+        };
+
+        struct InternalNode : Node {
+            InternalNode() : Node(false), slope(0.0), intercept(0.0) {}
+            double slope;
+            double intercept;
+            std::vector<Node*> children;
+        };
+
+        struct DataNode : Node {
+            DataNode() : Node(true), slope(0.0), intercept(0.0), num_keys(0), prev(nullptr), next(nullptr),
+                expected_cost(0.0), search_steps(0), searches(0), shifts(0), inserts(0) {}
+
+            double slope;
+            double intercept;
+            std::vector<int> keys;           // Gapped array; gaps repeat the next key to their right.
+            std::vector<uint64_t> occupied;  // Bit i set when keys[i] is a real key.
+            size_t num_keys;
+            DataNode* prev;
+            DataNode* next;
+            // Cost model: predicted cost at build time and what inserts actually needed since (their searches and shifts).
+            double expected_cost;
+            long long search_steps;
+            long long searches;
+            long long shifts;
+            long long inserts;
+
+            int capacity() const { return static_cast<int>(keys.size()); }
+            bool isOccupied(int i) const { return (occupied[i >> 6] >> (i & 63)) & 1; }
+            void setOccupied(int i) { occupied[i >> 6] |= (uint64_t(1) << (i & 63)); }
+            void clearOccupied(int i) { occupied[i >> 6] &= ~(uint64_t(1) << (i & 63)); }
+
+            int predict(int key) const {
+                double slot = slope * key + intercept;
+                if (!(slot > 0.0)) return 0; // Also catches NaN.
+                if (slot >= capacity() - 1) return capacity() - 1;
+                return static_cast<int>(slot);
+            }
+
+            // First occupied slot at or after 'i', or -1.
+            int nextOccupied(int i) const {
+                if (i < 0) i = 0;
+                if (i >= capacity()) return -1;
+                size_t word = static_cast<size_t>(i) >> 6;
+                uint64_t bits = occupied[word] & (~uint64_t(0) << (i & 63));
+                while (true) {
+                    if (bits) return static_cast<int>(word * 64 + __builtin_ctzll(bits));
+                    if (++word >= occupied.size()) return -1;
+                    bits = occupied[word];
+                }
+            }
+
+            // First slot whose value is >= key (capacity() if none), by exponential search from the prediction.
+            // The exponential-search steps taken are added to '*steps_taken' if it is given.
+            int lowerBound(int key, long long* steps_taken = nullptr) const {
+                int n = capacity();
+                if (n == 0) return 0;
+                int p = predict(key);
+                int lo, hi; // Answer lies in [lo, hi].
+                long long steps = 0;
+                if (keys[p] < key) {
+                    int bound = 1;
+                    while (p + bound < n && keys[p + bound] < key) { bound *= 2; ++steps; }
+                    lo = p + bound / 2 + 1;
+                    hi = std::min(p + bound, n);
+                }
+                else {
+                    int bound = 1;
+                    while (p - bound >= 0 && keys[p - bound] >= key) { bound *= 2; ++steps; }
+                    lo = std::max(p - bound + 1, 0);
+                    hi = p - bound / 2;
+                }
+                if (steps_taken) *steps_taken += steps;
+                return static_cast<int>(std::lower_bound(keys.begin() + lo, keys.begin() + hi, key) - keys.begin());
+            }
+
+            // Slot holding 'key', or -1.
+            int findSlot(int key) const {
+                int slot = nextOccupied(lowerBound(key));
+                return (slot >= 0 && keys[slot] == key) ? slot : -1;
+            }
+
+            // Gives every gap directly left of 'slot' the value now stored at 'slot'.
+            void refillGapsLeftOf(int slot) {
+                for (int i = slot - 1; i >= 0 && !isOccupied(i); --i) keys[i] = keys[slot];
+            }
+
+            bool insert(int key) {
+                long long steps = 0;
+                int pos = lowerBound(key, &steps);
+                search_steps += steps;
+                ++searches;
+                int next_key_slot = nextOccupied(pos);
+                if (next_key_slot >= 0 && keys[next_key_slot] == key) return false;
+                ++inserts;
+                if (pos < capacity() && !isOccupied(pos)) {
+                    // [pos, next_key_slot) is a gap run; put the key as close to its prediction as possible.
+                    int run_end = next_key_slot >= 0 ? next_key_slot : capacity();
+                    int slot = std::max(pos, std::min(run_end - 1, predict(key)));
+                    keys[slot] = key;
+                    setOccupied(slot);
+                    refillGapsLeftOf(slot);
+                }
+                else {
+                    int gap = pos;
+                    while (gap < capacity() && isOccupied(gap)) ++gap;
+                    if (gap < capacity()) { // Shift [pos, gap) one slot right.
+                        for (int i = gap; i > pos; --i) keys[i] = keys[i - 1];
+                        keys[pos] = key;
+                        setOccupied(gap);
+                        shifts += gap - pos;
+                    }
+                    else { // No gap on the right: shift [gap, pos) one slot left.
+                        gap = pos - 1;
+                        while (gap >= 0 && isOccupied(gap)) --gap;
+                        for (int i = gap; i < pos - 1; ++i) keys[i] = keys[i + 1];
+                        keys[pos - 1] = key;
+                        setOccupied(gap);
+                        refillGapsLeftOf(gap);
+                        shifts += pos - 1 - gap;
+                    }
+                }
+                ++num_keys;
+                return true;
+            }
+
+            bool erase(int key) {
+                int slot = findSlot(key);
+                if (slot < 0) return false;
+                clearOccupied(slot);
+                keys[slot] = slot + 1 < capacity() ? keys[slot + 1] : INT_MAX;
+                refillGapsLeftOf(slot);
+                --num_keys;
+                return true;
+            }
+
+            std::vector<int> collectKeys() const {
+                std::vector<int> result;
+                result.reserve(num_keys);
+                for (int slot = nextOccupied(0); slot >= 0; slot = nextOccupied(slot + 1)) result.push_back(keys[slot]);
+                return result;
+            }
+
+            // Rebuilds the gapped array at INITIAL_DENSITY with a freshly fitted model.
+            void rebuild(const std::vector<int>& sorted) {
+                int n = static_cast<int>(sorted.size());
+                int cap = std::max(16, static_cast<int>(std::ceil(n / INITIAL_DENSITY)));
+                keys.assign(cap, INT_MAX);
+                occupied.assign((cap + 63) / 64, 0);
+                num_keys = sorted.size();
+                search_steps = searches = shifts = inserts = 0;
+
+                // Least-squares fit of rank against key, scaled from [0, n) to [0, cap).
+                slope = 0.0;
+                intercept = 0.0;
+                if (n >= 2) {
+                    double mean_x = 0.0, mean_y = (n - 1) / 2.0;
+                    for (int key : sorted) mean_x += key;
+                    mean_x /= n;
+                    double cov = 0.0, var = 0.0;
+                    for (int i = 0; i < n; ++i) {
+                        double dx = sorted[i] - mean_x;
+                        cov += dx * (i - mean_y);
+                        var += dx * dx;
+                    }
+                    double scale = static_cast<double>(cap) / n;
+                    slope = var > 0.0 ? cov / var * scale : 0.0;
+                    intercept = (mean_y - (var > 0.0 ? cov / var : 0.0) * mean_x) * scale;
+                }
+
+                // Model-based placement: each key goes to its predicted slot unless that would
+                // overlap the previous key or leave too little room for the keys after it.
+                double error_log_sum = 0.0;
+                int last = -1;
+                for (int i = 0; i < n; ++i) {
+                    int slot = std::max(last + 1, std::min(predict(sorted[i]), cap - (n - i)));
+                    keys[slot] = sorted[i];
+                    setOccupied(slot);
+                    error_log_sum += std::log2(std::abs(slot - predict(sorted[i])) + 1.0);
+                    last = slot;
+                }
+                for (int i = cap - 2; i >= 0; --i) {
+                    if (!isOccupied(i)) keys[i] = keys[i + 1];
+                }
+                expected_cost = n > 0 ? error_log_sum / n : 0.0;
+            }
+
+            // Average exponential-search steps plus shifts per insert since the last rebuild.
+            double empiricalCost() const {
+                double search_cost = searches > 0 ? static_cast<double>(search_steps) / searches : 0.0;
+                double shift_cost = inserts > 0 ? static_cast<double>(shifts) / inserts : 0.0;
+                return search_cost + 0.5 * shift_cost;
+            }
+        };
+
+        // Bulk loads 'sorted' under a root whose routing model covers [min_key, max_key].
+        void loadWithDomain(const std::vector<int>& sorted, int min_key, int max_key) {
+            destroy(root);
+            num_keys = sorted.size();
+            size_t leaves = std::max<size_t>(1, sorted.size() / TARGET_LEAF_KEYS);
+            int fanout = 1;
+            while (static_cast<size_t>(fanout) < leaves && fanout < MAX_FANOUT) fanout *= 2;
+
+            InternalNode* node = new InternalNode();
+            fitRouting(*node, min_key, max_key, fanout);
+            node->children.assign(fanout, nullptr);
+
+            // One data node per child slot; the model spreads keys roughly evenly across slots.
+            DataNode* previous = nullptr;
+            size_t begin = 0;
+            for (int slot = 0; slot < fanout; ++slot) {
+                size_t end = begin;
+                while (end < sorted.size() && routeSlot(*node, sorted[end]) == slot) ++end;
+                DataNode* leaf = buildDataNode(sorted.begin() + begin, sorted.begin() + end);
+                linkAfter(previous, leaf);
+                previous = leaf;
+                node->children[slot] = leaf;
+                begin = end;
+            }
+            root = node;
+        }
+
+        // Fits an internal node's model so keys in [min_key, max_key] spread over [0, fanout).
+        static void fitRouting(InternalNode& node, int min_key, int max_key, int fanout) {
+            double range = static_cast<double>(max_key) - min_key + 1.0;
+            node.slope = fanout / range;
+            node.intercept = -node.slope * min_key;
+        }
+
+        static int routeSlot(const InternalNode& node, int key) {
+            double slot = node.slope * key + node.intercept;
+            int fanout = static_cast<int>(node.children.size());
+            if (!(slot > 0.0)) return 0;
+            if (slot >= fanout - 1) return fanout - 1;
+            return static_cast<int>(slot);
+        }
+
+        static DataNode* buildDataNode(std::vector<int>::const_iterator first, std::vector<int>::const_iterator last) {
+            DataNode* leaf = new DataNode();
+            leaf->rebuild(std::vector<int>(first, last));
+            return leaf;
+        }
+
+        // Inserts 'leaf' into the leaf list right after 'previous' (or at the front if null).
+        void linkAfter(DataNode* previous, DataNode* leaf) {
+            leaf->prev = previous;
+            leaf->next = previous ? previous->next : nullptr;
+            if (previous) previous->next = leaf;
+            if (leaf->next) leaf->next->prev = leaf;
+        }
+
+        DataNode* findLeaf(int key, InternalNode** parent, int* parent_slot) const {
+            Node* node = root;
+            while (!node->is_leaf) {
+                InternalNode* internal = static_cast<InternalNode*>(node);
+                int slot = routeSlot(*internal, key);
+                if (parent) *parent = internal;
+                if (parent_slot) *parent_slot = slot;
+                node = internal->children[slot];
+            }
+            return static_cast<DataNode*>(node);
+        }
+
+        DataNode* firstLeaf() const {
+            Node* node = root;
+            while (!node->is_leaf) node = static_cast<InternalNode*>(node)->children.front();
+            return static_cast<DataNode*>(node);
+        }
+
+        DataNode* lastLeaf() const {
+            Node* node = root;
+            while (!node->is_leaf) node = static_cast<InternalNode*>(node)->children.back();
+            return static_cast<DataNode*>(node);
+        }
+
+        /**
+         * @brief Grows the root's key domain so 'key' does not fall off either end of it.
+         *
+         * Keys beyond the domain would all be clamped into the first or last data node, so
+         * append-heavy workloads would keep splitting that one node. Instead the root's fanout is
+         * multiplied by a power of two and the new child slots share one new, empty data node.
+         * If that would exceed MAX_FANOUT the whole index is bulk loaded again around the key.
+         */
+        void expandRootFor(int key) {
+            InternalNode* node = static_cast<InternalNode*>(root);
+            double fanout = static_cast<double>(node->children.size());
+            double slot = node->slope * key + node->intercept;
+            if (slot >= 0.0 && slot < fanout) return;
+
+            double factor = 2.0;
+            while ((slot >= 0.0 ? slot >= fanout * factor : -slot > fanout * (factor - 1.0)) && fanout * factor <= MAX_FANOUT) factor *= 2.0;
+            if (fanout * factor > MAX_FANOUT || num_keys == 0) {
+                std::vector<int> all;
+                rangeScan(INT_MIN, INT_MAX, all);
+                loadWithDomain(all, std::min(key, all.empty() ? key : all.front()), std::max(key, all.empty() ? key : all.back()));
+                return;
+            }
+
+            size_t old_fanout = node->children.size();
+            size_t added = old_fanout * (static_cast<size_t>(factor) - 1);
+            DataNode* leaf = new DataNode();
+            leaf->rebuild(std::vector<int>());
+            if (slot >= 0.0) {
+                linkAfter(lastLeaf(), leaf);
+                node->children.insert(node->children.end(), added, leaf);
+            }
+            else {
+                DataNode* first = firstLeaf();
+                leaf->next = first;
+                first->prev = leaf;
+                node->children.insert(node->children.begin(), added, leaf);
+                node->intercept += static_cast<double>(added);
+            }
+        }
+
+        // Expands or splits a data node that reached MAX_DENSITY, following the cost model.
+        void handleFullNode(DataNode* leaf, InternalNode* parent, int parent_slot) {
+            bool cost_drifted = leaf->empiricalCost() > 1.5 * leaf->expected_cost + 1.0;
+            bool too_large = leaf->num_keys >= static_cast<size_t>(MAX_LEAF_KEYS);
+            if (!too_large && (!cost_drifted || leaf->num_keys < TARGET_LEAF_KEYS / 4)) {
+                leaf->rebuild(leaf->collectKeys()); // Expand: larger array, retrained model.
+                return;
+            }
+            splitDataNode(leaf, parent, parent_slot);
+        }
+
+        void splitDataNode(DataNode* leaf, InternalNode* parent, int parent_slot) {
+            // The run of parent slots that point at this leaf.
+            int first = parent_slot, last = parent_slot + 1;
+            while (first > 0 && parent->children[first - 1] == leaf) --first;
+            while (last < static_cast<int>(parent->children.size()) && parent->children[last] == leaf) ++last;
+
+            if (last - first == 1 && static_cast<int>(parent->children.size()) < MAX_FANOUT) {
+                // Double the parent's fanout so the leaf owns two slots, then split sideways.
+                std::vector<Node*> doubled;
+                doubled.reserve(parent->children.size() * 2);
+                for (Node* child : parent->children) {
+                    doubled.push_back(child);
+                    doubled.push_back(child);
+                }
+                parent->children.swap(doubled);
+                parent->slope *= 2.0;
+                parent->intercept *= 2.0;
+                first *= 2;
+                last = first + 2;
+            }
+
+            std::vector<int> all = leaf->collectKeys();
+            if (last - first >= 2) {
+                // Sideways split: keys routed to the left half of the slots form the left leaf.
+                int middle = (first + last) / 2;
+                auto split = std::partition_point(all.begin(), all.end(), [&](int key) { return routeSlot(*parent, key) < middle; });
+                DataNode* left = buildDataNode(all.begin(), split);
+                DataNode* right = buildDataNode(split, all.end());
+                replaceLeaf(leaf, left, right);
+                for (int s = first; s < middle; ++s) parent->children[s] = left;
+                for (int s = middle; s < last; ++s) parent->children[s] = right;
+            }
+            else {
+                // Downward split: a new two-way internal node over this leaf's key range.
+                InternalNode* node = new InternalNode();
+                fitRouting(*node, all.front(), all.back(), 2);
+                node->children.assign(2, nullptr);
+                auto split = std::partition_point(all.begin(), all.end(), [&](int key) { return routeSlot(*node, key) < 1; });
+                DataNode* left = buildDataNode(all.begin(), split);
+                DataNode* right = buildDataNode(split, all.end());
+                replaceLeaf(leaf, left, right);
+                node->children[0] = left;
+                node->children[1] = right;
+                parent->children[first] = node;
+            }
+            delete leaf;
+        }
+
+        // Puts 'left' and 'right' in place of 'leaf' in the leaf list.
+        void replaceLeaf(DataNode* leaf, DataNode* left, DataNode* right) {
+            left->prev = leaf->prev;
+            left->next = right;
+            right->prev = left;
+            right->next = leaf->next;
+            if (left->prev) left->prev->next = left;
+            if (right->next) right->next->prev = right;
+        }
+
+        // Deletes every node once, even when several child slots share it.
+        static void destroy(Node* node) {
+            if (!node) return;
+            if (!node->is_leaf) {
+                InternalNode* internal = static_cast<InternalNode*>(node);
+                Node* previous = nullptr;
+                for (Node* child : internal->children) {
+                    if (child != previous) destroy(child);
+                    previous = child;
+                }
+            }
+            delete node;
+        }
+
+        static size_t memoryOf(const Node* node) {
+            if (node->is_leaf) {
+                const DataNode* leaf = static_cast<const DataNode*>(node);
+                return sizeof(DataNode) + leaf->keys.capacity() * sizeof(int) + leaf->occupied.capacity() * sizeof(uint64_t);
+            }
+            const InternalNode* internal = static_cast<const InternalNode*>(node);
+            size_t bytes = sizeof(InternalNode) + internal->children.capacity() * sizeof(Node*);
+            const Node* previous = nullptr;
+            for (const Node* child : internal->children) {
+                if (child != previous) bytes += memoryOf(child);
+                previous = child;
+            }
+            return bytes;
+        }
+
+        static int depthOf(const Node* node) {
+            if (node->is_leaf) return 1;
+            int deepest = 0;
+            for (const Node* child : static_cast<const InternalNode*>(node)->children) deepest = std::max(deepest, depthOf(child));
+            return deepest + 1;
+        }
+
+        Node* root;
+        size_t num_keys;
+    };
+
+} // namespace ProjectUtils
+
+#endif // LEARNED_INDEX_H
@@ -0,0 +1,556 @@
+#ifndef LOAD_GENERATOR_H
+#define LOAD_GENERATOR_H
+
+#include "SearchIndex.h" // For the in-process engines under load.
+#include <vector>
+#include <string>
+#include <random>
+#include <chrono>
+#include <thread>
+#include <atomic>
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <functional>
+#include <cmath>
+#include <cstdint>
+#if defined(__SSE2__)
+#include <emmintrin.h> // For _mm_pause while spinning towards a send time.
+#endif
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <unistd.h>   // For fork, exec, pipe, read, write and close.
+#include <sys/wait.h> // For reaping the server process.
+#define PROJECT_HAS_LOAD_SERVER_TARGET 1
+#else
+#define PROJECT_HAS_LOAD_SERVER_TARGET 0
+#endif
+
+/*
+Open-loop load generation with latency measured from the intended send time.
+
+A closed loop, such as the NUM_RUNS loop in main.cpp, sends the next query only after the
+previous one returned. When the engine stalls, the loop stalls with it, and the queries that
+would have arrived during the stall are never timed ("coordinated omission"). Here the send
+times are fixed in advance from the target rate, with constant spacing or Poisson (exponential
+inter-arrival) gaps. A query's latency runs from its intended send time to its completion, so
+time spent waiting behind slower queries is counted, as it would be for a real client.
+
+Targets:
+    - In process: N worker threads call SearchIndex::search. Arrivals are dealt out round-robin,
+      and each worker owns every N-th send time, so workers share no counter (N M/G/1
+      queues). A worker that falls behind starts its next query late, and that delay is part
+      of the query's latency.
+    - The local server mode (POSIX): the generator starts "Main serve <file> <algorithm>" as a
+      child process. A sender thread writes each target to its stdin at the intended time
+      without waiting for replies, and the calling thread matches the replies in order.
+
+Latencies go into LatencyHistogram, a log-linear histogram in the HdrHistogram layout with 3
+significant digits. It prints the standard .hgrm percentile distribution that HdrHistogram's
+plotting tools read. A sweep runs a series of rates (by default fractions of a capacity
+estimate). The knee is the highest rate that was still sustained (at least 95% of the target
+throughput) with p99 at most LOAD_KNEE_P99_FACTOR times the p99 of the lowest rate.
+
+The generator's own lateness (for example, a sleep that overshoots) is also counted against the
+target. That errs on the side of reporting too much latency, never too little. Each query also
+costs the generator two clock reads and two histogram records, so the in-process capacity is
+measured through that same loop with the real worker count, every query due at once. The loop
+is also run over an index that does no work; at rates above LOAD_GENERATOR_HEADROOM of that
+ceiling the generator takes most of each worker's time, so such runs are flagged and left out
+of the knee.
+*/
+
+namespace ProjectUtils {
+
+    // A rate counts as sustained while p99 stays within this factor of the lowest rate's p99.
+    const double LOAD_KNEE_P99_FACTOR = 10.0;
+
+    // Rates above this fraction of the generator's own ceiling measure the generator rather than the engine.
+    const double LOAD_GENERATOR_HEADROOM = 0.5;
+
+    /**
+     * @brief Log-linear latency histogram (HdrHistogram layout, 3 significant digits) over nanoseconds.
+     *
+     * Values below 2048 have their own counter. Above that, every power of two is split into 1024
+     * sub-buckets, so a recorded value is off by at most 0.1%.
+     */
+    class LatencyHistogram {
+    public:
+        LatencyHistogram() : counts(NUM_COUNTS, 0), total(0), max_value(0), sum(0.0), sum_squares(0.0) {}
+
+        void record(uint64_t ns) {
+            ++counts[indexOf(ns)];
+            ++total;
+            max_value = std::max(max_value, ns);
+            sum += static_cast<double>(ns);
+            sum_squares += static_cast<double>(ns) * static_cast<double>(ns);
+        }
+
+        void add(const LatencyHistogram& other) {
+            for (size_t i = 0; i < counts.size(); ++i) counts[i] += other.counts[i];
+            total += other.total;
+            max_value = std::max(max_value, other.max_value);
+            sum += other.sum;
+            sum_squares += other.sum_squares;
+        }
+
+        uint64_t count() const { return total; }
+        uint64_t max() const { return max_value; }
+        double mean() const { return total ? sum / total : 0.0; }
+
+        double stddev() const {
+            if (total == 0) return 0.0;
+            double m = mean();
+            return std::sqrt(std::max(0.0, sum_squares / total - m * m));
+        }
+
+        /**
+         * @brief Smallest recorded value (to histogram precision) with at least 'percentile'% of the values at or below it.
+         */
+        uint64_t valueAtPercentile(double percentile) const {
+            if (total == 0) return 0;
+            uint64_t wanted = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(std::min(100.0, percentile) / 100.0 * total)));
+            uint64_t seen = 0;
+            for (size_t i = 0; i < counts.size(); ++i) {
+                seen += counts[i];
+                if (seen >= wanted) return std::min(highestEquivalentValue(i), max_value);
+            }
+            return max_value;
+        }
+
+        /**
+         * @brief Writes the percentile distribution in HdrHistogram's .hgrm format.
+         *
+         * @param unit_ns Nanoseconds per output unit (1000 prints microseconds).
+         */
+        void writePercentileDistribution(std::ostream& out, double unit_ns = 1000.0) const {
+            out << "       Value     Percentile TotalCount 1/(1-Percentile)\n\n";
+            if (total > 0) {
+                // Like HdrHistogram, 5 reporting ticks per halving of the distance to 100%.
+                double percentile = 0.0;
+                while (true) {
+                    uint64_t value = valueAtPercentile(percentile);
+                    uint64_t at_or_below = countAtOrBelow(value);
+                    out << std::fixed << std::setprecision(3) << std::setw(12) << value / unit_ns << " " << std::setprecision(12) << std::setw(14);
+                    if (at_or_below >= total) {
+                        out << 1.0 << " " << std::setw(10) << total << "\n";
+                        break;
+                    }
+                    out << percentile / 100.0 << " " << std::setw(10) << at_or_below << " " << std::setprecision(2) << std::setw(14)
+                        << 100.0 / (100.0 - percentile) << "\n";
+                    percentile += 10.0 / std::pow(2.0, std::floor(std::log2(100.0 / (100.0 - percentile))));
+                }
+            }
+            out << std::fixed << std::setprecision(3) << "#[Mean    = " << std::setw(12) << mean() / unit_ns << ", StdDeviation   = " << std::setw(12)
+                << stddev() / unit_ns << "]\n";
+            out << "#[Max     = " << std::setw(12) << max_value / unit_ns << ", Total count    = " << std::setw(12) << total << "]\n";
+            out << "#[Buckets = " << std::setw(12) << (NUM_COUNTS - 2048) / 1024 + 1 << ", SubBuckets     = " << std::setw(12) << 2048 << "]\n";
+        }
+
+    private:
+        // Values up to 2^40 ns (about 18 minutes) are tracked; larger ones count in the last bucket.
+        static const size_t NUM_COUNTS = 2048 + (40 - 11) * 1024;
+
+        static size_t indexOf(uint64_t ns) {
+            if (ns < 2048) return static_cast<size_t>(ns);
+            int magnitude = 63 - __builtin_clzll(ns);
+            if (magnitude >= 40) return NUM_COUNTS - 1;
+            int shift = magnitude - 10;
+            return 2048 + static_cast<size_t>(magnitude - 11) * 1024 + static_cast<size_t>((ns >> shift) - 1024);
+        }
+
+        static uint64_t highestEquivalentValue(size_t index) {
+            if (index < 2048) return index;
+            size_t magnitude = (index - 2048) / 1024 + 11;
+            size_t shift = magnitude - 10;
+            uint64_t sub = (index - 2048) % 1024 + 1024;
+            return ((sub + 1) << shift) - 1;
+        }
+
+        uint64_t countAtOrBelow(uint64_t value) const {
+            uint64_t seen = 0;
+            size_t last = indexOf(value);
+            for (size_t i = 0; i <= last; ++i) seen += counts[i];
+            return seen;
+        }
+
+        std::vector<uint64_t> counts;
+        uint64_t total;
+        uint64_t max_value;
+        double sum;
+        double sum_squares;
+    };
+
+    // How the send times of a run are spaced.
+    enum class ArrivalPattern { Constant, Poisson };
+
+    /**
+     * @brief Intended send times, in ns from the start of the run, for 'count' queries at 'rate' per second.
+     */
+    inline std::vector<uint64_t> makeArrivalSchedule(double rate, size_t count, ArrivalPattern pattern, unsigned seed = 2025) {
+        std::vector<uint64_t> schedule(count);
+        std::mt19937_64 rng(seed);
+        std::exponential_distribution<double> gap(rate);
+        double t = 0.0;
+        for (size_t i = 0; i < count; ++i) {
+            schedule[i] = static_cast<uint64_t>(t * 1e9);
+            t += pattern == ArrivalPattern::Poisson ? gap(rng) : 1.0 / rate;
+        }
+        return schedule;
+    }
+
+    // The outcome of one run at a fixed target rate.
+    struct LoadRunResult {
+        double target_qps = 0.0;
+        double achieved_qps = 0.0;  // Completed queries over the time from the first intended send to the last completion.
+        LatencyHistogram latency;   // From the intended send time to completion.
+        LatencyHistogram service;   // From the actual send time to completion.
+        bool generator_bound = false; // The generator alone uses most of the workers' time at this rate (see LOAD_GENERATOR_HEADROOM).
+    };
+
+    namespace detail {
+        typedef std::chrono::steady_clock LoadClock;
+
+        // Waits until 'deadline': sleeps while it is far away, then spins (yielding the CPU if 'yield') for microsecond accuracy.
+        inline void waitUntil(LoadClock::time_point deadline, bool yield) {
+            while (true) {
+                LoadClock::time_point now = LoadClock::now();
+                if (now >= deadline) return;
+                if (deadline - now > std::chrono::microseconds(200)) {
+                    std::this_thread::sleep_until(deadline - std::chrono::microseconds(100));
+                }
+                else if (yield) {
+                    std::this_thread::yield();
+                }
+                else {
+#if defined(__SSE2__)
+                    _mm_pause();
+#endif
+                }
+            }
+        }
+
+        inline uint64_t nanosBetween(LoadClock::time_point from, LoadClock::time_point to) {
+            return to > from ? static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(to - from).count()) : 0;
+        }
+
+        // An index that does no work, to measure what the generator loop alone can sustain.
+        class IdleSearchIndex : public SearchIndex {
+        public:
+            std::string name() const override { return "idle"; }
+            void build(const std::vector<int>&) override {}
+            int search(int target) const override { return target & 1; }
+            size_t memoryBytes() const override { return 0; }
+        };
+    }
+
+    /**
+     * @brief Runs one open-loop run against an in-process index.
+     *
+     * @param queries Targets, used in order and repeated if there are fewer than arrivals.
+     * @param schedule Intended send times from makeArrivalSchedule.
+     * @param workers Threads; worker w serves arrivals w, w + workers, w + 2 * workers, ...
+     */
+    inline LoadRunResult runInProcessLoad(const SearchIndex& index, const std::vector<int>& queries, const std::vector<uint64_t>& schedule,
+        double target_qps, int workers = 1) {
+        typedef detail::LoadClock Clock;
+        LoadRunResult result;
+        result.target_qps = target_qps;
+        if (queries.empty() || schedule.empty()) return result;
+        workers = std::max(1, workers);
+        std::vector<LatencyHistogram> latencies(workers), services(workers);
+        std::vector<Clock::time_point> finished(workers);
+        std::atomic<int> sink(0); // Keeps the searches from being optimized away.
+        Clock::time_point start = Clock::now() + std::chrono::milliseconds(1);
+        auto work = [&](int w) {
+            int local = 0;
+            Clock::time_point last = start;
+            for (size_t i = static_cast<size_t>(w); i < schedule.size(); i += static_cast<size_t>(workers)) {
+                Clock::time_point intended = start + std::chrono::nanoseconds(schedule[i]);
+                detail::waitUntil(intended, false);
+                Clock::time_point sent = Clock::now();
+                local += index.search(queries[i % queries.size()]);
+                last = Clock::now();
+                latencies[w].record(detail::nanosBetween(intended, last));
+                services[w].record(detail::nanosBetween(sent, last));
+            }
+            finished[w] = last;
+            sink += local;
+        };
+        if (workers == 1) {
+            work(0);
+        }
+        else {
+            std::vector<std::thread> threads;
+            for (int w = 0; w < workers; ++w) threads.emplace_back(work, w);
+            for (std::thread& thread : threads) thread.join();
+        }
+        Clock::time_point end = *std::max_element(finished.begin(), finished.end());
+        for (int w = 0; w < workers; ++w) {
+            result.latency.add(latencies[w]);
+            result.service.add(services[w]);
+        }
+        double seconds = std::chrono::duration<double>(end - start).count();
+        result.achieved_qps = seconds > 0.0 ? schedule.size() / seconds : 0.0;
+        return result;
+    }
+
+    /**
+     * @brief Throughput of an in-process index through the instrumented load loop, used to place the sweep's rates.
+     *
+     * Every query is due at once, so 'workers' threads run back to back and pay the same clock reads
+     * and histogram records as in a timed run.
+     */
+    inline double measureInProcessCapacity(const SearchIndex& index, const std::vector<int>& queries, int workers = 1) {
+        if (queries.empty()) return 0.0;
+        std::vector<uint64_t> schedule(queries.size(), 0);
+        return runInProcessLoad(index, queries, schedule, 0.0, workers).achieved_qps;
+    }
+
+    /**
+     * @brief Throughput of the load loop alone (an index that does no work) with 'workers' threads.
+     */
+    inline double measureLoadGeneratorCeiling(const std::vector<int>& queries, int workers = 1) {
+        detail::IdleSearchIndex idle;
+        return measureInProcessCapacity(idle, queries, workers);
+    }
+
+    /**
+     * @brief Flags the runs whose target rate is above LOAD_GENERATOR_HEADROOM of the generator's ceiling.
+     */
+    inline void markGeneratorBoundRuns(std::vector<LoadRunResult>& runs, double generator_qps) {
+        for (LoadRunResult& run : runs) run.generator_bound = run.target_qps > LOAD_GENERATOR_HEADROOM * generator_qps;
+    }
+
+#if PROJECT_HAS_LOAD_SERVER_TARGET
+    /**
+     * @brief A "Main serve" child process connected through pipes.
+     */
+    class ServeProcess {
+    public:
+        ServeProcess() : pid(-1), to_server(-1), from_server(-1), buffered(0), consumed(0) {}
+        ~ServeProcess() { stop(); }
+
+        /**
+         * @brief Starts "<executable> serve <file> <algorithm>" and waits until it answers.
+         *
+         * The writes go to a pipe, so the caller should ignore SIGPIPE if a server that exits early
+         * must show up as a failed write rather than end the program.
+         *
+         * @param executable argv[0] of this program; /proc/self/exe is tried first where it exists.
+         */
+        bool start(const std::string& executable, const std::string& file, const std::string& algorithm) {
+            stop();
+            int in_pipe[2], out_pipe[2];
+            if (::pipe(in_pipe) != 0 || ::pipe(out_pipe) != 0) {
+                std::cerr << "Error: Could not create pipes for the server process.\n";
+                return false;
+            }
+            std::cout.flush();
+            pid = ::fork();
+            if (pid < 0) {
+                std::cerr << "Error: Could not start the server process.\n";
+                return false;
+            }
+            if (pid == 0) {
+                ::dup2(in_pipe[0], 0);
+                ::dup2(out_pipe[1], 1);
+                ::close(in_pipe[0]);
+                ::close(in_pipe[1]);
+                ::close(out_pipe[0]);
+                ::close(out_pipe[1]);
+                std::vector<char*> args;
+                std::string mode = "serve";
+                args.push_back(const_cast<char*>(executable.c_str()));
+                args.push_back(const_cast<char*>(mode.c_str()));
+                args.push_back(const_cast<char*>(file.c_str()));
+                args.push_back(const_cast<char*>(algorithm.c_str()));
+                args.push_back(nullptr);
+                ::execv("/proc/self/exe", args.data());
+                ::execvp(executable.c_str(), args.data());
+                ::_exit(127);
+            }
+            ::close(in_pipe[0]);
+            ::close(out_pipe[1]);
+            to_server = in_pipe[1];
+            from_server = out_pipe[0];
+            // The first reply means the dataset is loaded and the index built.
+            std::string reply;
+            if (!sendLine("0") || !readLine(reply)) {
+                std::cerr << "Error: The server process did not answer.\n";
+                stop();
+                return false;
+            }
+            return true;
+        }
+
+        void stop() {
+            if (to_server >= 0) ::close(to_server);
+            if (from_server >= 0) ::close(from_server);
+            to_server = from_server = -1;
+            if (pid > 0) {
+                int status = 0;
+                ::waitpid(pid, &status, 0);
+            }
+            pid = -1;
+            buffered = consumed = 0;
+        }
+
+        bool sendLine(const std::string& line) {
+            std::string data = line + "\n";
+            const char* p = data.data();
+            size_t left = data.size();
+            while (left > 0) {
+                ssize_t n = ::write(to_server, p, left);
+                if (n < 0 && errno == EINTR) continue;
+                if (n <= 0) return false;
+                p += n;
+                left -= static_cast<size_t>(n);
+            }
+            return true;
+        }
+
+        bool readLine(std::string& line) {
+            line.clear();
+            while (true) {
+                while (consumed < buffered) {
+                    char c = buffer[consumed++];
+                    if (c == '\n') return true;
+                    line.push_back(c);
+                }
+                ssize_t n = ::read(from_server, buffer, sizeof(buffer));
+                if (n < 0 && errno == EINTR) continue;
+                if (n <= 0) return false;
+                buffered = static_cast<size_t>(n);
+                consumed = 0;
+            }
+        }
+
+    private:
+        pid_t pid;
+        int to_server;
+        int from_server;
+        char buffer[4096];
+        size_t buffered;
+        size_t consumed;
+    };
+
+    /**
+     * @brief Runs one open-loop run against a server process; sends never wait for replies.
+     */
+    inline LoadRunResult runServerLoad(ServeProcess& server, const std::vector<int>& queries, const std::vector<uint64_t>& schedule, double target_qps) {
+        typedef detail::LoadClock Clock;
+        LoadRunResult result;
+        result.target_qps = target_qps;
+        if (queries.empty() || schedule.empty()) return result;
+        std::vector<Clock::time_point> sent(schedule.size());
+        std::atomic<size_t> sent_count(0);
+        std::atomic<bool> send_failed(false);
+        Clock::time_point start = Clock::now() + std::chrono::milliseconds(1);
+        std::thread sender([&]() {
+            for (size_t i = 0; i < schedule.size(); ++i) {
+                detail::waitUntil(start + std::chrono::nanoseconds(schedule[i]), true); // Yields so the server can run meanwhile.
+                sent[i] = Clock::now();
+                sent_count.store(i + 1, std::memory_order_release);
+                if (!server.sendLine(std::to_string(queries[i % queries.size()]))) {
+                    send_failed = true;
+                    return;
+                }
+            }
+        });
+        std::string reply;
+        Clock::time_point last = start;
+        size_t received = 0;
+        for (; received < schedule.size(); ++received) {
+            if (!server.readLine(reply)) break;
+            last = Clock::now();
+            result.latency.record(detail::nanosBetween(start + std::chrono::nanoseconds(schedule[received]), last));
+            while (sent_count.load(std::memory_order_acquire) <= received) std::this_thread::yield(); // The stamp is written just before the line.
+            result.service.record(detail::nanosBetween(sent[received], last));
+        }
+        sender.join();
+        if (send_failed || received < schedule.size()) std::cerr << "Warning: The server stopped answering after " << received << " replies.\n";
+        double seconds = std::chrono::duration<double>(last - start).count();
+        result.achieved_qps = seconds > 0.0 ? received / seconds : 0.0;
+        return result;
+    }
+
+    /**
+     * @brief Pipelined throughput of a server process (a window of requests in flight), used to place the sweep's rates.
+     */
+    inline double measureServerCapacity(ServeProcess& server, const std::vector<int>& queries, size_t window = 64) {
+        if (queries.empty()) return 0.0;
+        std::string reply;
+        auto start = std::chrono::steady_clock::now();
+        size_t sent = 0, received = 0;
+        while (received < queries.size()) {
+            while (sent < queries.size() && sent - received < window) {
+                if (!server.sendLine(std::to_string(queries[sent++]))) return 0.0;
+            }
+            if (!server.readLine(reply)) return 0.0;
+            ++received;
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return seconds > 0.0 ? queries.size() / seconds : 0.0;
+    }
+#endif // PROJECT_HAS_LOAD_SERVER_TARGET
+
+    /**
+     * @brief Default sweep: fractions of the closed-loop capacity, from light load to just past saturation.
+     */
+    inline std::vector<double> defaultLoadSweepRates(double capacity_qps) {
+        std::vector<double> rates;
+        const double fractions[] = { 0.1, 0.25, 0.5, 0.7, 0.8, 0.9, 0.95, 1.0, 1.1 };
+        for (double fraction : fractions) rates.push_back(std::max(1.0, fraction * capacity_qps));
+        return rates;
+    }
+
+    /**
+     * @brief Index of the highest sustained rate (see LOAD_KNEE_P99_FACTOR), or -1 if none was sustained.
+     *
+     * Generator-bound runs are skipped.
+     */
+    inline int findSaturationKnee(const std::vector<LoadRunResult>& runs) {
+        if (runs.empty()) return -1;
+        uint64_t base_p99 = std::max<uint64_t>(1, runs.front().latency.valueAtPercentile(99.0));
+        for (const LoadRunResult& run : runs) base_p99 = std::min(base_p99, std::max<uint64_t>(1, run.latency.valueAtPercentile(99.0)));
+        int knee = -1;
+        for (size_t i = 0; i < runs.size(); ++i) {
+            if (runs[i].generator_bound) continue;
+            bool sustained = runs[i].achieved_qps >= 0.95 * runs[i].target_qps;
+            bool within = runs[i].latency.valueAtPercentile(99.0) <= LOAD_KNEE_P99_FACTOR * base_p99;
+            if (sustained && within && (knee < 0 || runs[i].target_qps > runs[knee].target_qps)) knee = static_cast<int>(i);
+        }
+        return knee;
+    }
+
+    /**
+     * @brief Prints one row per rate (latency from the intended send time) and the knee; generator-bound rates are starred.
+     */
+    inline void printLoadSweepTable(const std::vector<LoadRunResult>& runs, std::ostream& out) {
+        out << std::right << std::setw(12) << "Target qps" << std::setw(13) << "Achieved qps" << std::setw(10) << "p50 us" << std::setw(10) << "p90 us"
+            << std::setw(10) << "p99 us" << std::setw(11) << "p99.9 us" << std::setw(11) << "max us" << std::setw(15) << "svc p99 us" << "\n";
+        bool any_generator_bound = false;
+        for (const LoadRunResult& run : runs) {
+            any_generator_bound = any_generator_bound || run.generator_bound;
+            out << std::fixed << std::setprecision(0) << std::setw(11) << run.target_qps << (run.generator_bound ? "*" : " ") << std::setw(13) << run.achieved_qps << std::setprecision(2)
+                << std::setw(10) << run.latency.valueAtPercentile(50.0) / 1000.0 << std::setw(10) << run.latency.valueAtPercentile(90.0) / 1000.0
+                << std::setw(10) << run.latency.valueAtPercentile(99.0) / 1000.0 << std::setw(11) << run.latency.valueAtPercentile(99.9) / 1000.0
+                << std::setw(11) << run.latency.max() / 1000.0 << std::setw(15) << run.service.valueAtPercentile(99.0) / 1000.0 << "\n";
+        }
+        if (any_generator_bound) out << "* The load generator alone uses most of the workers' time at this rate; the row measures the generator, not the engine.\n";
+        int knee = findSaturationKnee(runs);
+        if (knee < 0) {
+            out << "Saturation knee: no rate was sustained.\n";
+        }
+        else {
+            out << std::setprecision(0) << "Saturation knee: about " << runs[knee].target_qps << " qps (p99 " << std::setprecision(2)
+                << runs[knee].latency.valueAtPercentile(99.0) / 1000.0 << " us)"
+                << (knee + 1 == static_cast<int>(runs.size()) ? "; the highest rate tried, so the real knee may lie above it.\n" : ".\n");
+        }
+    }
+
+} // namespace ProjectUtils
+
+#endif // LOAD_GENERATOR_H
@@ -0,0 +1,149 @@
+#ifndef MACHINE_PROFILE_H
+#define MACHINE_PROFILE_H
+
+#include <vector>
+#include <random>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <utility>
+#include <cstdint>
+#include <cstddef>
+#if defined(__unix__) || defined(__APPLE__)
+#include <unistd.h> // For sysconf(_SC_LEVEL3_CACHE_SIZE).
+#endif
+
+/*
+The memory latency and bandwidth of this host, used to normalize benchmark results.
+
+Raw ns per lookup depends on the machine. Dividing by what the memory system can do gives
+numbers that carry over between machines:
+    - Latency: a pointer chase through a random cycle over a buffer much larger than the
+      last-level cache. Every load depends on the previous one, so the time per step is one
+      dependent DRAM miss (TLB misses included, as a random lookup would pay them).
+      A lookup taking k times that long costs "k dependent misses".
+    - Bandwidth: the STREAM triad a[i] = b[i] + s * c[i] over three large arrays, counted as
+      24 bytes per element like STREAM does (best of several passes). If every lookup needed
+      only one fresh 64-byte line and the lines were fetched independently, bandwidth / 64
+      lookups per second would be the ceiling; a lookup's "% of bandwidth ceiling" compares
+      its throughput with that.
+A batch engine that overlaps its misses can go below one dependent miss per lookup, but it
+can never exceed the bandwidth ceiling. A single-lookup search close to its number of cache
+levels in dependent misses is latency-bound, and only fewer dependent loads will help it.
+
+The measurement runs once per process, on first use, and takes about a second.
+*/
+
+namespace ProjectUtils {
+
+    // Bytes per cache line assumed by the bandwidth ceiling.
+    const size_t MACHINE_CACHE_LINE = 64;
+
+    struct MachineProfile {
+        double latency_ns = 0.0;     // One dependent miss to DRAM.
+        double bandwidth_gbps = 0.0; // STREAM triad, in GB/s (10^9 bytes).
+        size_t buffer_bytes = 0;     // Size of the pointer-chase buffer; each triad array is half of it.
+
+        /**
+         * @brief Time of one lookup in dependent DRAM misses.
+         */
+        double missesPerLookup(double ns_per_lookup) const { return latency_ns > 0.0 ? ns_per_lookup / latency_ns : 0.0; }
+
+        /**
+         * @brief Lookup throughput as a percentage of the one-line-per-lookup bandwidth ceiling.
+         */
+        double percentOfBandwidthCeiling(double ns_per_lookup) const {
+            // Lines the memory system can stream during one lookup; one line per lookup is the ceiling.
+            double lines = ns_per_lookup * bandwidth_gbps / MACHINE_CACHE_LINE;
+            return lines > 0.0 ? 100.0 / lines : 0.0;
+        }
+    };
+
+    namespace detail {
+        // The chase buffer is twice the last-level cache, between 64 MB and 128 MB; the triad arrays are half that each.
+        inline size_t machineProfileBufferBytes() {
+            size_t llc = 0;
+#if defined(_SC_LEVEL3_CACHE_SIZE)
+            long reported = sysconf(_SC_LEVEL3_CACHE_SIZE);
+            if (reported > 0) llc = static_cast<size_t>(reported);
+#endif
+            return std::min<size_t>(size_t(128) << 20, std::max<size_t>(size_t(64) << 20, 2 * llc));
+        }
+    }
+
+    /**
+     * @brief Nanoseconds per step of a pointer chase through a random cycle of cache lines in 'bytes'.
+     */
+    inline double measureMemoryLatency(size_t bytes, size_t steps = 1000000) {
+        const size_t stride = MACHINE_CACHE_LINE / sizeof(size_t);
+        size_t lines = std::max<size_t>(2, bytes / MACHINE_CACHE_LINE);
+        std::vector<size_t> order(lines);
+        for (size_t i = 0; i < lines; ++i) order[i] = i;
+        // Sattolo's shuffle gives one cycle through every line, so the chase never short-circuits.
+        std::mt19937_64 rng(2025);
+        for (size_t i = lines - 1; i > 0; --i) {
+            std::swap(order[i], order[std::uniform_int_distribution<size_t>(0, i - 1)(rng)]);
+        }
+        std::vector<size_t> next(lines * stride);
+        for (size_t i = 0; i < lines; ++i) next[order[i] * stride] = order[(i + 1) % lines] * stride;
+
+        size_t position = 0;
+        for (size_t i = 0; i < steps / 10; ++i) position = next[position]; // Warm up.
+        auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < steps; ++i) position = next[position];
+        auto end = std::chrono::steady_clock::now();
+        volatile size_t sink = position; // The chase must not be optimized away.
+        (void)sink;
+        return std::chrono::duration<double, std::nano>(end - start).count() / steps;
+    }
+
+    /**
+     * @brief STREAM triad bandwidth in GB/s over three arrays of 'bytes' each (best of 'passes').
+     */
+    inline double measureMemoryBandwidth(size_t bytes, int passes = 4) {
+        size_t n = std::max<size_t>(1, bytes / sizeof(double));
+        std::vector<double> a(n, 0.0), b(n, 1.0), c(n, 2.0);
+        const double scale = 3.0;
+        double best = 0.0;
+        for (int pass = 0; pass < passes; ++pass) {
+            auto start = std::chrono::steady_clock::now();
+            double* __restrict pa = a.data();
+            const double* __restrict pb = b.data();
+            const double* __restrict pc = c.data();
+            for (size_t i = 0; i < n; ++i) pa[i] = pb[i] + scale * pc[i];
+            auto end = std::chrono::steady_clock::now();
+            double seconds = std::chrono::duration<double>(end - start).count();
+            if (seconds > 0.0) best = std::max(best, 3.0 * sizeof(double) * n / seconds / 1e9);
+        }
+        volatile double sink = a[n / 2]; // Keeps the stores.
+        (void)sink;
+        return best;
+    }
+
+    /**
+     * @brief This host's profile, measured on the first call.
+     */
+    inline const MachineProfile& machineProfile() {
+        static const MachineProfile profile = []() {
+            MachineProfile measured;
+            measured.buffer_bytes = detail::machineProfileBufferBytes();
+            measured.latency_ns = measureMemoryLatency(measured.buffer_bytes);
+            measured.bandwidth_gbps = measureMemoryBandwidth(measured.buffer_bytes / 2);
+            return measured;
+        }();
+        return profile;
+    }
+
+    /**
+     * @brief Prints a one-line summary of the profile.
+     */
+    inline void printMachineProfile(const MachineProfile& profile, std::ostream& out) {
+        out << std::fixed << std::setprecision(1) << "Machine: " << profile.latency_ns << " ns per dependent miss, " << profile.bandwidth_gbps
+            << " GB/s STREAM triad (" << profile.buffer_bytes / (1024 * 1024) << " MB chase); bandwidth ceiling "
+            << profile.bandwidth_gbps * 1e3 / MACHINE_CACHE_LINE << " M lookups/s at one line each.\n";
+    }
+
+} // namespace ProjectUtils
+
+#endif // MACHINE_PROFILE_H
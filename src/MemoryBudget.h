@@ -0,0 +1,341 @@
+#ifndef MEMORY_BUDGET_H
+#define MEMORY_BUDGET_H
+
+#include "SearchIndex.h" // For SearchIndex, createSearchIndex and registeredSearchIndexNames.
+#include <vector>
+#include <string>
+#include <memory>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h> // For getrusage when /proc is not available.
+#endif
+
+/*
+Memory accounting for datasets and their search indexes.
+
+    - `currentRssBytes` / `peakRssBytes` / `trackLoadPeakRss`: process memory, so the peak
+      reached while a file is loaded and sorted can be reported.
+    - `MemoryBudgetManager`: measures bytes/key and ns/lookup of every registered index on
+      each dataset, then picks the indexes that give the largest expected speedup per byte
+      within a per-dataset or global byte budget. Indexes that do not fit are dropped.
+
+The budget covers the datasets themselves plus every selected index, because that is what
+has to fit into a host's memory limit.
+*/
+
+namespace ProjectUtils {
+
+    namespace detail {
+        // Reads a "<field>: <n> kB" line from /proc/self/status. Returns -1 when unavailable.
+        inline long long readProcStatusKb(const std::string& field) {
+            std::ifstream status("/proc/self/status");
+            std::string line;
+            while (std::getline(status, line)) {
+                if (line.compare(0, field.size() + 1, field + ":") == 0) {
+                    std::istringstream fields(line.substr(field.size() + 1));
+                    long long kb = -1;
+                    fields >> kb;
+                    return kb;
+                }
+            }
+            return -1;
+        }
+    }
+
+    /**
+     * @brief Returns the resident set size of this process in bytes, or 0 if unknown.
+     */
+    inline size_t currentRssBytes() {
+        long long kb = detail::readProcStatusKb("VmRSS");
+        return kb > 0 ? static_cast<size_t>(kb) * 1024 : 0;
+    }
+
+    /**
+     * @brief Returns the peak resident set size of this process in bytes, or 0 if unknown.
+     */
+    inline size_t peakRssBytes() {
+        long long kb = detail::readProcStatusKb("VmHWM");
+        if (kb > 0) return static_cast<size_t>(kb) * 1024;
+#if defined(__APPLE__)
+        struct rusage usage;
+        if (getrusage(RUSAGE_SELF, &usage) == 0) return static_cast<size_t>(usage.ru_maxrss); // Bytes on macOS.
+#elif defined(__unix__)
+        struct rusage usage;
+        if (getrusage(RUSAGE_SELF, &usage) == 0) return static_cast<size_t>(usage.ru_maxrss) * 1024;
+#endif
+        return 0;
+    }
+
+    /**
+     * @brief Resets the kernel's peak RSS counter so the next peak belongs to one phase.
+     *
+     * @return True if the counter was reset (Linux 4.0+), false otherwise.
+     */
+    inline bool resetPeakRss() {
+        std::ofstream clear_refs("/proc/self/clear_refs");
+        if (!clear_refs.is_open()) return false;
+        clear_refs << "5"; // "5" resets VmHWM to the current RSS.
+        clear_refs.flush();
+        return static_cast<bool>(clear_refs);
+    }
+
+    // Memory observed while one dataset was loaded.
+    struct LoadMemoryReport {
+        size_t rss_before = 0;
+        size_t peak_rss = 0;
+        size_t rss_after = 0;
+        bool peak_is_for_load = false; // False if the peak could not be reset and may predate the load.
+    };
+
+    /**
+     * @brief Runs a loader (e.g. a call to `loadAndSortDatasetFromFile`) and records peak RSS.
+     *
+     * @tparam Loader A callable returning bool.
+     * @param load The loader to run.
+     * @param report Receives RSS before, during and after the load.
+     * @return The loader's result.
+     */
+    template<typename Loader>
+    bool trackLoadPeakRss(Loader load, LoadMemoryReport& report) {
+        report.rss_before = currentRssBytes();
+        report.peak_is_for_load = resetPeakRss();
+        bool result = load();
+        report.peak_rss = peakRssBytes();
+        report.rss_after = currentRssBytes();
+        return result;
+    }
+
+    /**
+     * @brief Formats a byte count as B, KB, MB or GB for reports.
+     */
+    inline std::string formatBytes(double bytes) {
+        const char* units[] = { "B", "KB", "MB", "GB" };
+        int unit = 0;
+        while (bytes >= 1024.0 && unit < 3) {
+            bytes /= 1024.0;
+            ++unit;
+        }
+        std::ostringstream out;
+        out << std::fixed << std::setprecision(unit == 0 ? 0 : 1) << bytes << " " << units[unit];
+        return out.str();
+    }
+
+    // Measured cost and benefit of one index on one dataset.
+    struct IndexCost {
+        std::string name;
+        size_t bytes = 0;          // Bytes on top of the dataset.
+        double bytes_per_key = 0.0;
+        double ns_per_lookup = 0.0;
+        double speedup = 1.0;      // Relative to binary search over the sorted dataset.
+    };
+
+    // A dataset registered with the manager plus its measured index costs and current choice.
+    struct BudgetedDataset {
+        std::string name;
+        const std::vector<int>* data = nullptr;
+        double query_weight = 1.0; // Relative share of lookups this dataset receives.
+        LoadMemoryReport load_memory;
+        std::vector<IndexCost> costs;
+        int selected = -1;         // Index into 'costs' of the chosen index.
+    };
+
+    /**
+     * @brief Chooses search indexes for one or more datasets within a byte budget.
+     *
+     * Usage: `addDataset` for each dataset, `profile` once, then `planPerDataset` or
+     * `planGlobal`, then `printReport` and/or `buildSelected`.
+     */
+    class MemoryBudgetManager {
+    public:
+        /**
+         * @brief Registers a sorted dataset. The vector must outlive the manager.
+         */
+        void addDataset(const std::string& name, const std::vector<int>& data, double query_weight = 1.0,
+            const LoadMemoryReport& load_memory = LoadMemoryReport()) {
+            BudgetedDataset entry;
+            entry.name = name;
+            entry.data = &data;
+            entry.query_weight = query_weight;
+            entry.load_memory = load_memory;
+            datasets.push_back(entry);
+        }
+
+        /**
+         * @brief Builds every registered index on every dataset and measures bytes and lookup time.
+         *
+         * Each index is freed again after it has been measured, so profiling only needs
+         * room for one index at a time.
+         *
+         * @param num_queries Lookups per measurement (half hits, half random values in range).
+         */
+        void profile(int num_queries = 20000) {
+            for (BudgetedDataset& entry : datasets) {
+                entry.costs.clear();
+                entry.selected = -1;
+                std::vector<int> queries = makeBenchmarkQueries(*entry.data, static_cast<size_t>(std::max(0, num_queries)), 0.5, 42);
+                double baseline_ns = 0.0;
+                for (const std::string& index_name : registeredSearchIndexNames()) {
+                    std::unique_ptr<SearchIndex> index = createSearchIndex(index_name);
+                    index->build(*entry.data);
+
+                    IndexCost cost;
+                    cost.name = index_name;
+                    cost.bytes = index->memoryBytes();
+                    cost.bytes_per_key = entry.data->empty() ? 0.0 : static_cast<double>(cost.bytes) / entry.data->size();
+                    cost.ns_per_lookup = timeLookups(*index, queries);
+                    if (index_name == "sorted") baseline_ns = cost.ns_per_lookup;
+                    cost.speedup = cost.ns_per_lookup > 0.0 ? baseline_ns / cost.ns_per_lookup : 1.0;
+                    entry.costs.push_back(cost);
+                }
+            }
+        }
+
+        /**
+         * @brief Chooses one index per dataset so that each dataset plus its index fits 'budget_bytes'.
+         *
+         * @return The total bytes (datasets plus selected indexes) of the plan.
+         */
+        size_t planPerDataset(size_t budget_bytes) {
+            size_t total = 0;
+            for (BudgetedDataset& entry : datasets) {
+                size_t base = datasetBytes(entry);
+                entry.selected = cheapestFastest(entry);
+                total += base;
+                if (entry.selected < 0) continue; // Not profiled: buildSelected falls back to "sorted".
+                size_t room = budget_bytes > base ? budget_bytes - base : 0;
+                upgradeGreedily(std::vector<BudgetedDataset*>(1, &entry), room);
+                total += entry.costs[entry.selected].bytes;
+            }
+            return total;
+        }
+
+        /**
+         * @brief Chooses one index per dataset so that all datasets and indexes together fit 'budget_bytes'.
+         *
+         * Starting from the fastest zero-byte option for every dataset, repeatedly applies the
+         * upgrade with the largest weighted time saved per extra byte until nothing else fits.
+         *
+         * @return The total bytes (datasets plus selected indexes) of the plan.
+         */
+        size_t planGlobal(size_t budget_bytes) {
+            std::vector<BudgetedDataset*> all;
+            size_t base = 0;
+            for (BudgetedDataset& entry : datasets) {
+                entry.selected = cheapestFastest(entry);
+                base += datasetBytes(entry);
+                if (entry.selected >= 0) all.push_back(&entry); // Unprofiled datasets keep the "sorted" fallback.
+            }
+            size_t room = budget_bytes > base ? budget_bytes - base : 0;
+            size_t used = upgradeGreedily(all, room);
+            return base + used;
+        }
+
+        /**
+         * @brief Builds and returns the index currently selected for dataset 'i'.
+         */
+        std::unique_ptr<SearchIndex> buildSelected(size_t i) const {
+            const BudgetedDataset& entry = datasets[i];
+            std::unique_ptr<SearchIndex> index = createSearchIndex(entry.selected >= 0 ? entry.costs[entry.selected].name : "sorted");
+            index->build(*entry.data);
+            return index;
+        }
+
+        const std::vector<BudgetedDataset>& entries() const { return datasets; }
+
+        /**
+         * @brief Prints bytes/key, lookup time and the selection for every dataset and index.
+         */
+        void printReport(std::ostream& out, size_t budget_bytes, size_t planned_bytes) const {
+            for (const BudgetedDataset& entry : datasets) {
+                size_t bytes = datasetBytes(entry);
+                out << "Dataset '" << entry.name << "': " << entry.data->size() << " keys, " << formatBytes(bytes)
+                    << " (" << std::fixed << std::setprecision(2)
+                    << (entry.data->empty() ? 0.0 : static_cast<double>(bytes) / entry.data->size()) << " bytes/key)\n";
+                if (entry.load_memory.peak_rss > 0) {
+                    out << "  Peak RSS during load: " << formatBytes(static_cast<double>(entry.load_memory.peak_rss))
+                        << (entry.load_memory.peak_is_for_load ? "" : " (process peak)") << "\n";
+                }
+                out << "  " << std::left << std::setw(15) << "Index" << std::right << std::setw(12) << "Bytes"
+                    << std::setw(11) << "Bytes/Key" << std::setw(12) << "ns/lookup" << std::setw(10) << "Speedup" << "  Selected\n";
+                for (size_t c = 0; c < entry.costs.size(); ++c) {
+                    const IndexCost& cost = entry.costs[c];
+                    out << "  " << std::left << std::setw(15) << cost.name << std::right << std::setw(12) << formatBytes(static_cast<double>(cost.bytes))
+                        << std::setw(11) << std::setprecision(2) << cost.bytes_per_key
+                        << std::setw(12) << std::setprecision(1) << cost.ns_per_lookup
+                        << std::setw(9) << std::setprecision(2) << cost.speedup << "x"
+                        << (static_cast<int>(c) == entry.selected ? "  <==" : "") << "\n";
+                }
+            }
+            out << "Budget: " << formatBytes(static_cast<double>(budget_bytes)) << ", planned: "
+                << formatBytes(static_cast<double>(planned_bytes)) << ", current RSS: "
+                << formatBytes(static_cast<double>(currentRssBytes())) << "\n";
+            if (planned_bytes > budget_bytes) {
+                out << "Warning: the datasets alone exceed the budget; every index has been dropped.\n";
+            }
+        }
+
+    private:
+        static size_t datasetBytes(const BudgetedDataset& entry) {
+            return entry.data->capacity() * sizeof(int);
+        }
+
+        static double timeLookups(const SearchIndex& index, const std::vector<int>& queries) {
+            if (queries.empty()) return 0.0;
+            long long checksum = 0; // Keeps the compiler from discarding the lookups.
+            auto start = std::chrono::high_resolution_clock::now();
+            for (int q : queries) checksum += index.search(q);
+            auto end = std::chrono::high_resolution_clock::now();
+            volatile long long sink = checksum;
+            (void)sink;
+            return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()) / queries.size();
+        }
+
+        // The fastest index that costs no extra bytes (the baseline is always one of them).
+        static int cheapestFastest(const BudgetedDataset& entry) {
+            int best = -1;
+            for (size_t c = 0; c < entry.costs.size(); ++c) {
+                if (entry.costs[c].bytes != 0) continue;
+                if (best < 0 || entry.costs[c].ns_per_lookup < entry.costs[best].ns_per_lookup) best = static_cast<int>(c);
+            }
+            return best;
+        }
+
+        // Applies the best time-saved-per-byte upgrades that fit 'room'. Returns the bytes used. Every entry must have a selection.
+        static size_t upgradeGreedily(const std::vector<BudgetedDataset*>& entries, size_t room) {
+            size_t used = 0;
+            while (true) {
+                BudgetedDataset* best_entry = nullptr;
+                int best_choice = -1;
+                double best_value = 0.0;
+                for (BudgetedDataset* entry : entries) {
+                    if (entry->selected < 0) continue;
+                    const IndexCost& current = entry->costs[entry->selected];
+                    for (size_t c = 0; c < entry->costs.size(); ++c) {
+                        const IndexCost& option = entry->costs[c];
+                        if (option.bytes <= current.bytes || option.ns_per_lookup >= current.ns_per_lookup) continue;
+                        size_t extra = option.bytes - current.bytes;
+                        if (used + extra > room) continue;
+                        double value = entry->query_weight * (current.ns_per_lookup - option.ns_per_lookup) / extra;
+                        if (value > best_value) {
+                            best_value = value;
+                            best_entry = entry;
+                            best_choice = static_cast<int>(c);
+                        }
+                    }
+                }
+                if (best_entry == nullptr) return used;
+                used += best_entry->costs[best_choice].bytes - best_entry->costs[best_entry->selected].bytes;
+                best_entry->selected = best_choice;
+            }
+        }
+
+        std::vector<BudgetedDataset> datasets;
+    };
+
+} // namespace ProjectUtils
+
+#endif // MEMORY_BUDGET_H
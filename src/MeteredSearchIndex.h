@@ -0,0 +1,95 @@
+#ifndef METERED_SEARCH_INDEX_H
+#define METERED_SEARCH_INDEX_H
+
+#include "SearchIndex.h"    // For wrapping any registered index.
+#include "CacheSimulator.h" // For TracedSearcher, used to count probes on sampled lookups.
+#include "Metrics.h"
+#include <string>
+#include <memory>
+#include <chrono>
+#include <cstdint>
+
+/*
+Puts the metrics layer from Metrics.h in front of any SearchIndex.
+
+Every lookup is counted as a hit or a miss. Every build records its duration as the "build"
+load phase and publishes the index's memory. Reading the clock twice costs more than a cached
+lookup itself, and counting probes needs an instrumented copy of the search, so only one
+lookup in METERED_SAMPLE_PERIOD per thread is timed, and replayed through TracedSearcher.
+Only algorithms that read the dataset in place (sorted, jump, interpolation,
+kary-interpolation, linear-model) have their probes sampled, so metering never copies the
+dataset into a second layout or table.
+*/
+
+namespace ProjectUtils {
+
+    // One lookup in this many (per thread) is timed and replayed to count its probes.
+    const unsigned METERED_SAMPLE_PERIOD = 64;
+
+    /**
+     * @brief SearchIndex decorator that records every lookup in MetricsRegistry::global().
+     */
+    class MeteredSearchIndex : public SearchIndex {
+    public:
+        explicit MeteredSearchIndex(std::unique_ptr<SearchIndex> inner)
+            : inner(std::move(inner)), metric_id(MetricsRegistry::global().algorithmId(this->inner->name())), sample_probes(false) {}
+
+        // Reports under the inner name, so dashboards do not change when metering is switched on.
+        std::string name() const override { return inner->name(); }
+
+        void build(const std::vector<int>& sorted) override {
+            {
+                ScopedLoadPhase phase(LoadPhase::Build);
+                inner->build(sorted);
+            }
+            std::string algorithm = inner->name();
+            sample_probes = (algorithm == "sorted" || algorithm == "jump" || algorithm == "interpolation"
+                || algorithm == "kary-interpolation" || algorithm == "linear-model") && traced.build(algorithm, sorted);
+            MetricsRegistry::global().setIndexMemory(metric_id, inner->memoryBytes());
+        }
+
+        int search(int target) const override {
+            MetricsRegistry& metrics = MetricsRegistry::global();
+            static thread_local unsigned countdown = 0;
+            if (countdown-- != 0) {
+                int result = inner->search(target);
+                metrics.recordQuery(metric_id, result != -1);
+                return result;
+            }
+            countdown = METERED_SAMPLE_PERIOD - 1;
+            auto start = std::chrono::steady_clock::now();
+            int result = inner->search(target);
+            uint64_t ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+            metrics.recordQuery(metric_id, result != -1, ns);
+            if (sample_probes) {
+                static thread_local AccessTrace trace;
+                trace.clear();
+                traced.search(target, trace);
+                metrics.recordProbes(metric_id, trace.addresses.size());
+            }
+            return result;
+        }
+
+        size_t memoryBytes() const override { return inner->memoryBytes(); }
+
+    private:
+        std::unique_ptr<SearchIndex> inner;
+        int metric_id;
+        bool sample_probes;
+        TracedSearcher traced;
+    };
+
+    /**
+     * @brief Creates a registered index wrapped in metering.
+     *
+     * @return The new index, or nullptr if the name is unknown.
+     */
+    inline std::unique_ptr<MeteredSearchIndex> createMeteredSearchIndex(const std::string& name) {
+        std::unique_ptr<SearchIndex> inner = createSearchIndex(name);
+        if (!inner) return nullptr;
+        return std::unique_ptr<MeteredSearchIndex>(new MeteredSearchIndex(std::move(inner)));
+    }
+
+} // namespace ProjectUtils
+
+#endif // METERED_SEARCH_INDEX_H
@@ -0,0 +1,494 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>   // For std::rename.
+#include <cstdlib>  // For std::strtol of the endpoint port.
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <algorithm>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>     // For read, close and unlink.
+#include <poll.h>       // For waiting on the listening socket with a timeout.
+#include <sys/socket.h>
+#include <sys/un.h>     // For Unix-domain endpoints.
+#include <netinet/in.h> // For loopback TCP endpoints.
+#include <arpa/inet.h>
+#define PROJECT_HAS_METRICS_ENDPOINT 1
+#else
+#define PROJECT_HAS_METRICS_ENDPOINT 0
+#endif
+
+/*
+Always-on metrics for lookups and dataset loads, exported in the Prometheus text format.
+
+Recording is cheap enough to leave on in production:
+    - Every thread writes only to its own shard, so recording never contends. A shard is
+      registered on the thread's first record and never freed, so counters stay monotonic after
+      the thread exits. Values are single-writer relaxed atomics (load, add, store), which a
+      scrape can read at any time without locking.
+    - Algorithms are interned once into a small id (algorithmId), so recording a query indexes
+      fixed arrays instead of hashing strings.
+    - Latency and probe counts go into fixed exponential buckets.
+
+What is recorded:
+    search_queries_total{algorithm,result}        hits and misses per algorithm
+    search_query_latency_seconds{algorithm}       latency histogram (sampled, see MeteredSearchIndex)
+    search_probes_per_query{algorithm}            array reads per query (sampled, see MeteredSearchIndex)
+    search_load_phase_seconds_total{phase}        time spent in read/sort/deduplicate/generate/build
+    search_load_phase_runs_total{phase}
+    search_ingested_bytes_total                   bytes read from dataset files
+    search_dataset_keys                           size of the active dataset (gauge)
+    search_index_memory_bytes{algorithm}          memory of each built index (gauge)
+
+Export either with writeTextfile (written to a temporary file and renamed, so the node
+exporter's textfile collector never reads a half-written file) or through a MetricsEndpoint,
+which answers HTTP GETs on a loopback TCP port or a Unix-domain socket.
+*/
+
+namespace ProjectUtils {
+
+    // Distinct algorithm labels that can be recorded; later names are dropped.
+    const int METRICS_MAX_ALGORITHMS = 32;
+    // Upper bounds of the latency buckets in nanoseconds (50ns doubling up to ~51us), then +Inf.
+    const int METRICS_LATENCY_BUCKETS = 12;
+    // Upper bounds of the probe buckets (1, 2, 4, ... 256), then +Inf.
+    const int METRICS_PROBE_BUCKETS = 10;
+
+    enum class LoadPhase { Read, Sort, Deduplicate, Generate, Build, Count };
+
+    inline const char* loadPhaseName(LoadPhase phase) {
+        switch (phase) {
+            case LoadPhase::Read: return "read";
+            case LoadPhase::Sort: return "sort";
+            case LoadPhase::Deduplicate: return "deduplicate";
+            case LoadPhase::Generate: return "generate";
+            case LoadPhase::Build: return "build";
+            default: return "unknown";
+        }
+    }
+
+    /**
+     * @brief Process-wide metrics registry; use MetricsRegistry::global().
+     */
+    class MetricsRegistry {
+    public:
+        static MetricsRegistry& global() {
+            static MetricsRegistry registry;
+            return registry;
+        }
+
+        /**
+         * @brief Interns an algorithm name. Call once per index, not per query.
+         *
+         * @return The id to pass to the record functions, or -1 once METRICS_MAX_ALGORITHMS names exist.
+         */
+        int algorithmId(const std::string& name) {
+            std::lock_guard<std::mutex> lock(registry_mutex);
+            for (int i = 0; i < num_algorithms; ++i) {
+                if (algorithm_names[i] == name) return i;
+            }
+            if (num_algorithms == METRICS_MAX_ALGORITHMS) return -1;
+            algorithm_names[num_algorithms] = name;
+            return num_algorithms++;
+        }
+
+        void recordQuery(int algorithm, bool hit) {
+            if (algorithm < 0) return;
+            Shard& shard = localShard();
+            bump(hit ? shard.hits[algorithm] : shard.misses[algorithm], 1);
+        }
+
+        void recordLatency(int algorithm, uint64_t latency_ns) {
+            if (algorithm < 0) return;
+            Shard& shard = localShard();
+            bump(shard.latency[algorithm][latencyBucket(latency_ns)], 1);
+            bump(shard.latency_sum_ns[algorithm], latency_ns);
+        }
+
+        // Counts a lookup and records its latency.
+        void recordQuery(int algorithm, bool hit, uint64_t latency_ns) {
+            recordQuery(algorithm, hit);
+            recordLatency(algorithm, latency_ns);
+        }
+
+        void recordProbes(int algorithm, uint64_t probes) {
+            if (algorithm < 0) return;
+            Shard& shard = localShard();
+            bump(shard.probes[algorithm][probeBucket(probes)], 1);
+            bump(shard.probe_sum[algorithm], probes);
+        }
+
+        void recordLoadPhase(LoadPhase phase, uint64_t duration_ns) {
+            Shard& shard = localShard();
+            bump(shard.phase_ns[static_cast<int>(phase)], duration_ns);
+            bump(shard.phase_runs[static_cast<int>(phase)], 1);
+        }
+
+        void addIngestedBytes(uint64_t bytes) { bump(localShard().ingested_bytes, bytes); }
+
+        void setDatasetKeys(uint64_t keys) { dataset_keys.store(keys, std::memory_order_relaxed); }
+
+        void setIndexMemory(int algorithm, uint64_t bytes) {
+            if (algorithm >= 0) index_memory[algorithm].store(bytes + 1, std::memory_order_relaxed); // 0 means never built.
+        }
+
+        /**
+         * @brief Writes every metric in the Prometheus text exposition format (version 0.0.4).
+         */
+        void writePrometheus(std::ostream& destination) const {
+            std::ostringstream out; // Fresh formatting state, whatever flags 'destination' carries.
+            Totals totals = collect();
+            std::vector<std::string> names = algorithmNames();
+
+            out << "# HELP search_queries_total Lookups answered, by algorithm and outcome.\n"
+                << "# TYPE search_queries_total counter\n";
+            for (size_t a = 0; a < names.size(); ++a) {
+                out << "search_queries_total{algorithm=\"" << names[a] << "\",result=\"hit\"} " << totals.hits[a] << "\n";
+                out << "search_queries_total{algorithm=\"" << names[a] << "\",result=\"miss\"} " << totals.misses[a] << "\n";
+            }
+
+            out << "# HELP search_query_latency_seconds Lookup latency, from sampled lookups.\n"
+                << "# TYPE search_query_latency_seconds histogram\n";
+            for (size_t a = 0; a < names.size(); ++a) {
+                uint64_t cumulative = 0;
+                for (int b = 0; b < METRICS_LATENCY_BUCKETS; ++b) {
+                    cumulative += totals.latency[a][b];
+                    out << "search_query_latency_seconds_bucket{algorithm=\"" << names[a] << "\",le=\"";
+                    if (b + 1 < METRICS_LATENCY_BUCKETS) out << latencyBound(b) * 1e-9;
+                    else out << "+Inf";
+                    out << "\"} " << cumulative << "\n";
+                }
+                out << "search_query_latency_seconds_sum{algorithm=\"" << names[a] << "\"} " << totals.latency_sum_ns[a] * 1e-9 << "\n";
+                out << "search_query_latency_seconds_count{algorithm=\"" << names[a] << "\"} " << cumulative << "\n";
+            }
+
+            out << "# HELP search_probes_per_query Array reads per lookup, from sampled lookups.\n"
+                << "# TYPE search_probes_per_query histogram\n";
+            for (size_t a = 0; a < names.size(); ++a) {
+                uint64_t cumulative = 0;
+                for (int b = 0; b < METRICS_PROBE_BUCKETS; ++b) cumulative += totals.probes[a][b];
+                if (cumulative == 0) continue; // Algorithm is not probe-sampled.
+                cumulative = 0;
+                for (int b = 0; b < METRICS_PROBE_BUCKETS; ++b) {
+                    cumulative += totals.probes[a][b];
+                    out << "search_probes_per_query_bucket{algorithm=\"" << names[a] << "\",le=\"";
+                    if (b + 1 < METRICS_PROBE_BUCKETS) out << (uint64_t(1) << b);
+                    else out << "+Inf";
+                    out << "\"} " << cumulative << "\n";
+                }
+                out << "search_probes_per_query_sum{algorithm=\"" << names[a] << "\"} " << totals.probe_sum[a] << "\n";
+                out << "search_probes_per_query_count{algorithm=\"" << names[a] << "\"} " << cumulative << "\n";
+            }
+
+            out << "# HELP search_load_phase_seconds_total Time spent loading datasets and building indexes, by phase.\n"
+                << "# TYPE search_load_phase_seconds_total counter\n";
+            for (int p = 0; p < static_cast<int>(LoadPhase::Count); ++p) {
+                out << "search_load_phase_seconds_total{phase=\"" << loadPhaseName(static_cast<LoadPhase>(p)) << "\"} "
+                    << totals.phase_ns[p] * 1e-9 << "\n";
+            }
+            out << "# HELP search_load_phase_runs_total Times each load phase ran.\n"
+                << "# TYPE search_load_phase_runs_total counter\n";
+            for (int p = 0; p < static_cast<int>(LoadPhase::Count); ++p) {
+                out << "search_load_phase_runs_total{phase=\"" << loadPhaseName(static_cast<LoadPhase>(p)) << "\"} "
+                    << totals.phase_runs[p] << "\n";
+            }
+
+            out << "# HELP search_ingested_bytes_total Bytes read from dataset files.\n"
+                << "# TYPE search_ingested_bytes_total counter\n"
+                << "search_ingested_bytes_total " << totals.ingested_bytes << "\n";
+            out << "# HELP search_dataset_keys Keys in the most recently loaded dataset.\n"
+                << "# TYPE search_dataset_keys gauge\n"
+                << "search_dataset_keys " << dataset_keys.load(std::memory_order_relaxed) << "\n";
+
+            out << "# HELP search_index_memory_bytes Bytes held by each built index on top of the dataset.\n"
+                << "# TYPE search_index_memory_bytes gauge\n";
+            for (size_t a = 0; a < names.size(); ++a) {
+                uint64_t bytes = index_memory[a].load(std::memory_order_relaxed);
+                if (bytes != 0) out << "search_index_memory_bytes{algorithm=\"" << names[a] << "\"} " << bytes - 1 << "\n";
+            }
+            destination << out.str();
+        }
+
+        std::string prometheusText() const {
+            std::ostringstream text;
+            writePrometheus(text);
+            return text.str();
+        }
+
+        /**
+         * @brief Writes the metrics for the node exporter's textfile collector.
+         *
+         * The text goes to 'path'.tmp first and is then renamed over 'path', so a scrape never
+         * sees a partial file. 'path' should end in .prom.
+         *
+         * @return false if the file could not be written.
+         */
+        bool writeTextfile(const std::string& path) const {
+            std::string temporary = path + ".tmp";
+            {
+                std::ofstream out(temporary);
+                if (!out.is_open()) {
+                    std::cerr << "Error: Could not write metrics file '" << temporary << "'.\n";
+                    return false;
+                }
+                writePrometheus(out);
+                if (!out) return false;
+            }
+            if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+                std::cerr << "Error: Could not move metrics file into place at '" << path << "'.\n";
+                return false;
+            }
+            return true;
+        }
+
+    private:
+        // One thread's counters. The padding keeps neighbouring shards off each other's cache lines.
+        struct Shard {
+            char leading_pad[64];
+            std::atomic<uint64_t> hits[METRICS_MAX_ALGORITHMS];
+            std::atomic<uint64_t> misses[METRICS_MAX_ALGORITHMS];
+            std::atomic<uint64_t> latency[METRICS_MAX_ALGORITHMS][METRICS_LATENCY_BUCKETS];
+            std::atomic<uint64_t> latency_sum_ns[METRICS_MAX_ALGORITHMS];
+            std::atomic<uint64_t> probes[METRICS_MAX_ALGORITHMS][METRICS_PROBE_BUCKETS];
+            std::atomic<uint64_t> probe_sum[METRICS_MAX_ALGORITHMS];
+            std::atomic<uint64_t> phase_ns[static_cast<int>(LoadPhase::Count)];
+            std::atomic<uint64_t> phase_runs[static_cast<int>(LoadPhase::Count)];
+            std::atomic<uint64_t> ingested_bytes;
+            char trailing_pad[64];
+        };
+
+        // Shard counters summed over every thread.
+        struct Totals {
+            uint64_t hits[METRICS_MAX_ALGORITHMS] = {};
+            uint64_t misses[METRICS_MAX_ALGORITHMS] = {};
+            uint64_t latency[METRICS_MAX_ALGORITHMS][METRICS_LATENCY_BUCKETS] = {};
+            uint64_t latency_sum_ns[METRICS_MAX_ALGORITHMS] = {};
+            uint64_t probes[METRICS_MAX_ALGORITHMS][METRICS_PROBE_BUCKETS] = {};
+            uint64_t probe_sum[METRICS_MAX_ALGORITHMS] = {};
+            uint64_t phase_ns[static_cast<int>(LoadPhase::Count)] = {};
+            uint64_t phase_runs[static_cast<int>(LoadPhase::Count)] = {};
+            uint64_t ingested_bytes = 0;
+        };
+
+        MetricsRegistry() : num_algorithms(0), dataset_keys(0) {
+            for (int a = 0; a < METRICS_MAX_ALGORITHMS; ++a) index_memory[a].store(0, std::memory_order_relaxed);
+        }
+        MetricsRegistry(const MetricsRegistry&) = delete;
+        MetricsRegistry& operator=(const MetricsRegistry&) = delete;
+
+        // Only the owning thread writes a shard, so a plain load and store is enough.
+        static void bump(std::atomic<uint64_t>& counter, uint64_t amount) {
+            counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+        }
+
+        static uint64_t latencyBound(int bucket) { return uint64_t(50) << bucket; }
+
+        static int latencyBucket(uint64_t ns) {
+            int bucket = 0;
+            while (bucket + 1 < METRICS_LATENCY_BUCKETS && ns > latencyBound(bucket)) ++bucket;
+            return bucket;
+        }
+
+        static int probeBucket(uint64_t probes) {
+            int bucket = 0;
+            while (bucket + 1 < METRICS_PROBE_BUCKETS && probes > (uint64_t(1) << bucket)) ++bucket;
+            return bucket;
+        }
+
+        Shard& localShard() {
+            static thread_local Shard* shard = nullptr;
+            if (!shard) {
+                std::unique_ptr<Shard> fresh(new Shard());
+                std::lock_guard<std::mutex> lock(registry_mutex);
+                shards.push_back(std::move(fresh));
+                shard = shards.back().get();
+            }
+            return *shard;
+        }
+
+        std::vector<std::string> algorithmNames() const {
+            std::lock_guard<std::mutex> lock(registry_mutex);
+            return std::vector<std::string>(algorithm_names, algorithm_names + num_algorithms);
+        }
+
+        Totals collect() const {
+            Totals totals;
+            std::lock_guard<std::mutex> lock(registry_mutex);
+            for (const std::unique_ptr<Shard>& shard : shards) {
+                for (int a = 0; a < num_algorithms; ++a) {
+                    totals.hits[a] += shard->hits[a].load(std::memory_order_relaxed);
+                    totals.misses[a] += shard->misses[a].load(std::memory_order_relaxed);
+                    totals.latency_sum_ns[a] += shard->latency_sum_ns[a].load(std::memory_order_relaxed);
+                    totals.probe_sum[a] += shard->probe_sum[a].load(std::memory_order_relaxed);
+                    for (int b = 0; b < METRICS_LATENCY_BUCKETS; ++b) totals.latency[a][b] += shard->latency[a][b].load(std::memory_order_relaxed);
+                    for (int b = 0; b < METRICS_PROBE_BUCKETS; ++b) totals.probes[a][b] += shard->probes[a][b].load(std::memory_order_relaxed);
+                }
+                for (int p = 0; p < static_cast<int>(LoadPhase::Count); ++p) {
+                    totals.phase_ns[p] += shard->phase_ns[p].load(std::memory_order_relaxed);
+                    totals.phase_runs[p] += shard->phase_runs[p].load(std::memory_order_relaxed);
+                }
+                totals.ingested_bytes += shard->ingested_bytes.load(std::memory_order_relaxed);
+            }
+            return totals;
+        }
+
+        mutable std::mutex registry_mutex; // Guards the shard list and the algorithm names, never the counters.
+        std::vector<std::unique_ptr<Shard>> shards;
+        std::string algorithm_names[METRICS_MAX_ALGORITHMS];
+        int num_algorithms;
+        std::atomic<uint64_t> dataset_keys;
+        std::atomic<uint64_t> index_memory[METRICS_MAX_ALGORITHMS];
+    };
+
+    /**
+     * @brief Records the duration of one load phase when it goes out of scope.
+     */
+    class ScopedLoadPhase {
+    public:
+        explicit ScopedLoadPhase(LoadPhase phase) : phase(phase), start(std::chrono::steady_clock::now()) {}
+        ~ScopedLoadPhase() {
+            uint64_t ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+            MetricsRegistry::global().recordLoadPhase(phase, ns);
+        }
+        ScopedLoadPhase(const ScopedLoadPhase&) = delete;
+        ScopedLoadPhase& operator=(const ScopedLoadPhase&) = delete;
+
+    private:
+        LoadPhase phase;
+        std::chrono::steady_clock::time_point start;
+    };
+
+#if PROJECT_HAS_METRICS_ENDPOINT
+
+    /**
+     * @brief Serves the registry over HTTP from a background thread, for Prometheus to scrape.
+     *
+     * Every request on the socket gets the full metrics page; the request path is ignored.
+     */
+    class MetricsEndpoint {
+    public:
+        MetricsEndpoint() : listen_fd(-1), running(false) {}
+        ~MetricsEndpoint() { stop(); }
+        MetricsEndpoint(const MetricsEndpoint&) = delete;
+        MetricsEndpoint& operator=(const MetricsEndpoint&) = delete;
+
+        /**
+         * @brief Starts listening.
+         *
+         * @param address "unix:<path>" for a Unix-domain socket, or a port number for 127.0.0.1:<port>.
+         * @return false if the socket could not be set up.
+         */
+        bool start(const std::string& address) {
+            stop();
+            if (address.compare(0, 5, "unix:") == 0) {
+                unix_path = address.substr(5);
+                sockaddr_un local;
+                std::memset(&local, 0, sizeof(local));
+                if (unix_path.empty() || unix_path.size() >= sizeof(local.sun_path)) {
+                    std::cerr << "Error: Invalid Unix socket path '" << unix_path << "'.\n";
+                    return false;
+                }
+                local.sun_family = AF_UNIX;
+                std::memcpy(local.sun_path, unix_path.c_str(), unix_path.size());
+                ::unlink(unix_path.c_str()); // Remove a stale socket from an earlier run.
+                listen_fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+                if (listen_fd < 0 || ::bind(listen_fd, reinterpret_cast<sockaddr*>(&local), sizeof(local)) != 0) return fail(address);
+            }
+            else {
+                char* end = nullptr;
+                long port = std::strtol(address.c_str(), &end, 10);
+                if (address.empty() || *end != '\0' || port <= 0 || port > 65535) {
+                    std::cerr << "Error: '" << address << "' is neither a port nor unix:<path>.\n";
+                    return false;
+                }
+                sockaddr_in local;
+                std::memset(&local, 0, sizeof(local));
+                local.sin_family = AF_INET;
+                local.sin_port = htons(static_cast<uint16_t>(port));
+                local.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+                listen_fd = ::socket(AF_INET, SOCK_STREAM, 0);
+                int reuse = 1;
+                if (listen_fd >= 0) ::setsockopt(listen_fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+                if (listen_fd < 0 || ::bind(listen_fd, reinterpret_cast<sockaddr*>(&local), sizeof(local)) != 0) return fail(address);
+            }
+            if (::listen(listen_fd, 16) != 0) return fail(address);
+            running = true;
+            server = std::thread([this]() { serve(); });
+            return true;
+        }
+
+        void stop() {
+            if (running.exchange(false)) server.join();
+            if (listen_fd >= 0) {
+                ::close(listen_fd);
+                listen_fd = -1;
+            }
+            if (!unix_path.empty()) {
+                ::unlink(unix_path.c_str());
+                unix_path.clear();
+            }
+        }
+
+    private:
+        bool fail(const std::string& address) {
+            std::cerr << "Error: Could not listen on '" << address << "': " << std::strerror(errno) << "\n";
+            if (listen_fd >= 0) ::close(listen_fd);
+            listen_fd = -1;
+            unix_path.clear();
+            return false;
+        }
+
+        void serve() {
+            while (running.load()) {
+                pollfd waiting = { listen_fd, POLLIN, 0 };
+                if (::poll(&waiting, 1, 200) <= 0) continue; // Wake up regularly to notice stop().
+                int client = ::accept(listen_fd, nullptr, nullptr);
+                if (client < 0) continue;
+                char request[1024];
+                pollfd readable = { client, POLLIN, 0 };
+                if (::poll(&readable, 1, 1000) > 0) (void)::read(client, request, sizeof(request)); // Any request gets the page.
+                std::string body = MetricsRegistry::global().prometheusText();
+                std::string response = "HTTP/1.0 200 OK\r\nContent-Type: text/plain; version=0.0.4\r\nContent-Length: "
+                    + std::to_string(body.size()) + "\r\nConnection: close\r\n\r\n" + body;
+                const char* data = response.data();
+                size_t remaining = response.size();
+                while (remaining > 0) {
+                    ssize_t written = ::send(client, data, remaining, SEND_FLAGS); // No SIGPIPE if the scraper hung up.
+                    if (written < 0 && errno == EINTR) continue;
+                    if (written <= 0) break;
+                    data += written;
+                    remaining -= static_cast<size_t>(written);
+                }
+                ::close(client);
+            }
+        }
+
+#ifdef MSG_NOSIGNAL
+        static const int SEND_FLAGS = MSG_NOSIGNAL;
+#else
+        static const int SEND_FLAGS = 0;
+#endif
+
+        int listen_fd;
+        std::string unix_path;
+        std::atomic<bool> running;
+        std::thread server;
+    };
+
+#endif // PROJECT_HAS_METRICS_ENDPOINT
+
+} // namespace ProjectUtils
+
+#endif // METRICS_H
@@ -0,0 +1,446 @@
+#ifndef MIXED_WORKLOAD_H
+#define MIXED_WORKLOAD_H
+
+#include "Benchmark.h"     // For makeZipfQueries and interpolationSearch.
+#include "LearnedIndex.h"  // For the updatable learned index.
+#include "CrackerIndex.h"  // For the cracked column with ripple updates.
+#include "LoadGenerator.h" // For LatencyHistogram.
+#include <vector>
+#include <string>
+#include <memory>
+#include <mutex>
+#include <shared_mutex> // For std::shared_timed_mutex: shared reads, exclusive writes.
+#include <thread>
+#include <atomic>
+#include <random>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <iterator> // For std::back_inserter.
+#include <unordered_set>
+#include <climits>
+#include <cmath>
+
+/*
+YCSB-style mixed read/write benchmark for the dataset representations that accept updates.
+
+A workload mix sets the fractions of point reads, inserts, deletes and short range scans
+(1 to 100 keys wide). The standard mixes follow the YCSB core workloads:
+    - 95/5 read/insert (like workload B) and 50/50 read/insert (like A),
+    - scan-heavy: 95% scans, 5% inserts (like E),
+    - latest: 95% reads of recently inserted keys, 5% inserts (like D),
+    - churn: 90% reads, 5% inserts, 5% deletes, so the key count stays about level.
+Reads and scan starts pick existing keys with YCSB's scrambled Zipf distribution (skew 0.99).
+Latest reads pick the r-th most recent insert, with r log-uniform over the inserts so far.
+Inserted keys are new, unique values spread over (and just past) the dataset's range.
+
+Representations:
+    - the updatable learned index and the cracker column with ripple updates, each behind a
+      reader/writer lock. Learned index reads and scans share the lock, since lookups write
+      nothing; inserts and deletes take it exclusively. A cracker read first tries the shared
+      lock and answers from existing cracks; only a read that must crack a piece retakes the
+      lock exclusively. Zipf reads mostly hit cracked keys. A cracker write ripples through
+      every piece above its value, and Zipf reads leave tens of thousands of pieces, so its
+      writes are slow by design;
+    - the immutable sorted vector as the baseline. Readers search a published snapshot without
+      locking. Writers queue changes, and every MIXED_RELOAD_BATCH changes rebuild the vector
+      from scratch (sort and de-duplicate, as a file reload would) and publish it. Reads may
+      therefore miss up to that many recent writes.
+
+Each mix and representation runs at 1, 2, 4, ... up to the maximum thread count. The fixed
+total operation count is split evenly over the threads. Every operation is timed (two clock
+reads, about 40 ns, included), and the report gives the throughput and the latency
+percentiles per operation type. Afterwards the final contents are checked against the
+expected key set.
+*/
+
+namespace ProjectUtils {
+
+    // Queued writes per reload of the sorted-vector baseline.
+    const size_t MIXED_RELOAD_BATCH = 1000;
+
+    // Operation fractions of one workload; they should add up to 1.
+    struct WorkloadMix {
+        std::string name;
+        double read = 0.0;
+        double insert = 0.0;
+        double erase = 0.0;
+        double scan = 0.0;
+        bool latest = false; // Reads favour the most recent inserts.
+    };
+
+    /**
+     * @brief The YCSB-like mixes described at the top of this file.
+     */
+    inline std::vector<WorkloadMix> standardWorkloadMixes() {
+        std::vector<WorkloadMix> mixes(5);
+        mixes[0].name = "95/5 read/insert";
+        mixes[0].read = 0.95;
+        mixes[0].insert = 0.05;
+        mixes[1].name = "50/50 read/insert";
+        mixes[1].read = 0.5;
+        mixes[1].insert = 0.5;
+        mixes[2].name = "scan-heavy 95/5";
+        mixes[2].scan = 0.95;
+        mixes[2].insert = 0.05;
+        mixes[3].name = "latest 95/5";
+        mixes[3].read = 0.95;
+        mixes[3].insert = 0.05;
+        mixes[3].latest = true;
+        mixes[4].name = "churn 90/5/5";
+        mixes[4].read = 0.9;
+        mixes[4].insert = 0.05;
+        mixes[4].erase = 0.05;
+        return mixes;
+    }
+
+    // One row of the mixed workload report.
+    struct MixedWorkloadResult {
+        std::string workload;
+        std::string representation;
+        int threads = 1;
+        double ops_per_second = 0.0;
+        LatencyHistogram reads;  // Point reads, including latest reads.
+        LatencyHistogram writes; // Inserts and deletes.
+        LatencyHistogram scans;
+        bool correct = true;     // The final contents matched the expected key set.
+    };
+
+    namespace detail {
+        // An updatable representation as driven by the mixed workload benchmark; must be thread-safe.
+        class MixedWorkloadTarget {
+        public:
+            virtual ~MixedWorkloadTarget() {}
+            virtual std::string name() const = 0;
+            virtual void load(const std::vector<int>& sorted) = 0;
+            virtual bool read(int key) = 0;
+            virtual void insert(int key) = 0;
+            virtual void erase(int key) = 0;
+            virtual size_t scan(int lo, int hi) = 0;
+            // Applies anything still queued; called after all threads have finished.
+            virtual void flush() {}
+            // True if the contents are exactly 'expected' (sorted, unique).
+            virtual bool matches(const std::vector<int>& expected) = 0;
+        };
+
+        class LearnedIndexTarget : public MixedWorkloadTarget {
+        public:
+            std::string name() const override { return "updatable learned index"; }
+            void load(const std::vector<int>& sorted) override { index.bulkLoad(sorted); }
+            bool read(int key) override {
+                std::shared_lock<std::shared_timed_mutex> lock(mutex);
+                return index.contains(key);
+            }
+            void insert(int key) override {
+                std::lock_guard<std::shared_timed_mutex> lock(mutex);
+                index.insert(key);
+            }
+            void erase(int key) override {
+                std::lock_guard<std::shared_timed_mutex> lock(mutex);
+                index.erase(key);
+            }
+            size_t scan(int lo, int hi) override {
+                static thread_local std::vector<int> scanned; // Concurrent scans each copy into their own buffer.
+                std::shared_lock<std::shared_timed_mutex> lock(mutex);
+                scanned.clear();
+                return index.rangeScan(lo, hi, scanned);
+            }
+            bool matches(const std::vector<int>& expected) override {
+                std::vector<int> contents;
+                index.rangeScan(INT_MIN, INT_MAX, contents);
+                return contents == expected && index.size() == expected.size();
+            }
+
+        private:
+            std::shared_timed_mutex mutex;
+            UpdatableLearnedIndex index;
+        };
+
+        class CrackerTarget : public MixedWorkloadTarget {
+        public:
+            std::string name() const override { return "cracker column (ripple)"; }
+            void load(const std::vector<int>& sorted) override {
+                // Cracking starts from file order, not sorted order.
+                std::vector<int> column = sorted;
+                std::shuffle(column.begin(), column.end(), std::mt19937(2025));
+                cracker.load(std::move(column));
+            }
+            bool read(int key) override { return scan(key, key) != 0; }
+            void insert(int key) override {
+                std::lock_guard<std::shared_timed_mutex> lock(mutex);
+                cracker.insert(key);
+            }
+            void erase(int key) override {
+                std::lock_guard<std::shared_timed_mutex> lock(mutex);
+                cracker.erase(key);
+            }
+            size_t scan(int lo, int hi) override {
+                size_t count = 0;
+                {
+                    std::shared_lock<std::shared_timed_mutex> lock(mutex);
+                    if (cracker.countIfCracked(lo, hi, count)) return count;
+                }
+                std::lock_guard<std::shared_timed_mutex> lock(mutex); // Both ends were not cracked yet.
+                return cracker.rangeCount(lo, hi);
+            }
+            bool matches(const std::vector<int>& expected) override {
+                std::vector<int> contents = cracker.data();
+                std::sort(contents.begin(), contents.end());
+                return contents == expected;
+            }
+
+        private:
+            std::shared_timed_mutex mutex;
+            CrackerIndex cracker;
+        };
+
+        class ReloadedVectorTarget : public MixedWorkloadTarget {
+        public:
+            std::string name() const override { return "sorted vector + reload"; }
+            void load(const std::vector<int>& sorted) override {
+                std::atomic_store(&snapshot, std::make_shared<const std::vector<int>>(sorted));
+                pending.clear();
+            }
+            bool read(int key) override {
+                std::shared_ptr<const std::vector<int>> keys = std::atomic_load(&snapshot);
+                return interpolationSearch(*keys, key) != -1;
+            }
+            void insert(int key) override { queue(true, key); }
+            void erase(int key) override { queue(false, key); }
+            size_t scan(int lo, int hi) override {
+                // Scans copy out their keys, as the learned index does; one buffer per thread.
+                static thread_local std::vector<int> scanned;
+                std::shared_ptr<const std::vector<int>> keys = std::atomic_load(&snapshot);
+                scanned.assign(std::lower_bound(keys->begin(), keys->end(), lo), std::upper_bound(keys->begin(), keys->end(), hi));
+                return scanned.size();
+            }
+            void flush() override {
+                std::lock_guard<std::mutex> lock(mutex);
+                reload();
+            }
+            bool matches(const std::vector<int>& expected) override { return *std::atomic_load(&snapshot) == expected; }
+
+        private:
+            void queue(bool is_insert, int key) {
+                std::lock_guard<std::mutex> lock(mutex);
+                pending.push_back(std::make_pair(is_insert, key));
+                if (pending.size() >= MIXED_RELOAD_BATCH) reload();
+            }
+
+            // Full reload: the new contents are sorted and de-duplicated from scratch.
+            void reload() {
+                if (pending.empty()) return;
+                // Only the last change to a key counts, so a delete followed by a re-insert leaves the key present.
+                std::stable_sort(pending.begin(), pending.end(),
+                    [](const std::pair<bool, int>& a, const std::pair<bool, int>& b) { return a.second < b.second; });
+                std::shared_ptr<const std::vector<int>> current = std::atomic_load(&snapshot);
+                std::vector<int> reloaded = *current, deleted;
+                for (size_t i = 0; i < pending.size(); ++i) {
+                    if (i + 1 < pending.size() && pending[i + 1].second == pending[i].second) continue;
+                    if (pending[i].first) reloaded.push_back(pending[i].second);
+                    else deleted.push_back(pending[i].second);
+                }
+                std::sort(reloaded.begin(), reloaded.end());
+                reloaded.erase(std::unique(reloaded.begin(), reloaded.end()), reloaded.end());
+                std::sort(deleted.begin(), deleted.end());
+                std::vector<int> keys;
+                keys.reserve(reloaded.size());
+                std::set_difference(reloaded.begin(), reloaded.end(), deleted.begin(), deleted.end(), std::back_inserter(keys));
+                std::atomic_store(&snapshot, std::make_shared<const std::vector<int>>(std::move(keys)));
+                pending.clear();
+            }
+
+            std::mutex mutex; // Serializes writers; readers only load the snapshot.
+            std::shared_ptr<const std::vector<int>> snapshot;
+            std::vector<std::pair<bool, int>> pending; // (is_insert, key) in arrival order
+        };
+
+        enum class MixedOp : unsigned char { Read, LatestRead, Insert, Erase, Scan };
+
+        // One pre-generated operation: the key (or scan start), or the recency draw of a latest read.
+        struct MixedOperation {
+            MixedOp op;
+            int key;
+            int hi;        // Scan end.
+            float recency; // Uniform in [0, 1) for latest reads.
+        };
+    }
+
+    /**
+     * @brief Runs every mix against every updatable representation at 1, 2, 4, ... 'max_threads' threads.
+     *
+     * @param sorted The sorted, de-duplicated starting dataset.
+     * @param total_ops Operations per run, split evenly over the threads.
+     */
+    inline std::vector<MixedWorkloadResult> runMixedWorkloadBenchmark(const std::vector<int>& sorted, int max_threads, size_t total_ops = 100000,
+        const std::vector<WorkloadMix>& mixes = standardWorkloadMixes()) {
+        typedef std::chrono::steady_clock Clock;
+        std::vector<MixedWorkloadResult> rows;
+        if (sorted.empty() || total_ops == 0) return rows;
+        max_threads = std::max(1, max_threads);
+        std::vector<int> thread_counts;
+        for (int threads = 1; threads < max_threads; threads *= 2) thread_counts.push_back(threads);
+        thread_counts.push_back(max_threads);
+        const long long span = std::max(1LL, static_cast<long long>(sorted.back()) - sorted.front());
+        const long long average_gap = std::max(1LL, span / static_cast<long long>(sorted.size()));
+
+        for (const WorkloadMix& mix : mixes) {
+            // The operation stream is fixed per mix, so every representation and thread count runs the same work.
+            std::mt19937 rng(2025);
+            std::uniform_real_distribution<double> unit(0.0, 1.0);
+            std::uniform_int_distribution<int> scan_length(1, 100);
+            std::vector<int> zipf_keys = makeZipfQueries(sorted, total_ops, 0.99, 2026);
+            std::vector<detail::MixedOperation> ops(total_ops);
+            size_t num_inserts = 0;
+            for (size_t i = 0; i < total_ops; ++i) {
+                double draw = unit(rng);
+                detail::MixedOperation& op = ops[i];
+                op.key = zipf_keys[i];
+                op.hi = op.key;
+                op.recency = static_cast<float>(unit(rng));
+                if (draw < mix.read) {
+                    op.op = mix.latest ? detail::MixedOp::LatestRead : detail::MixedOp::Read;
+                }
+                else if (draw < mix.read + mix.insert) {
+                    op.op = detail::MixedOp::Insert;
+                    ++num_inserts;
+                }
+                else if (draw < mix.read + mix.insert + mix.erase) {
+                    op.op = detail::MixedOp::Erase;
+                }
+                else {
+                    op.op = detail::MixedOp::Scan;
+                    op.hi = static_cast<int>(std::min<long long>(INT_MAX, op.key + scan_length(rng) * average_gap));
+                }
+            }
+            // New keys, unique and absent from the dataset, in the order they are inserted.
+            std::vector<int> new_keys;
+            {
+                long long high = std::min<long long>(INT_MAX, static_cast<long long>(sorted.back()) + 2 * static_cast<long long>(num_inserts) + 1);
+                std::uniform_int_distribution<long long> value(sorted.front(), high);
+                std::unordered_set<int> taken;
+                for (size_t attempt = 0; new_keys.size() < num_inserts && attempt < 20 * num_inserts + 100; ++attempt) {
+                    int key = static_cast<int>(value(rng));
+                    if (!std::binary_search(sorted.begin(), sorted.end(), key) && taken.insert(key).second) new_keys.push_back(key);
+                }
+                num_inserts = new_keys.size(); // Short only if the key space is nearly exhausted.
+            }
+            // Every run ends with the same key set: the dataset minus the deleted keys plus all inserts.
+            std::vector<int> expected, erased;
+            for (const detail::MixedOperation& op : ops) {
+                if (op.op == detail::MixedOp::Erase) erased.push_back(op.key);
+            }
+            std::sort(erased.begin(), erased.end());
+            std::set_difference(sorted.begin(), sorted.end(), erased.begin(), erased.end(), std::back_inserter(expected));
+            expected.insert(expected.end(), new_keys.begin(), new_keys.end());
+            std::sort(expected.begin(), expected.end());
+
+            for (int representation = 0; representation < 3; ++representation) {
+                for (int threads : thread_counts) {
+                    std::unique_ptr<detail::MixedWorkloadTarget> target;
+                    if (representation == 0) target.reset(new detail::LearnedIndexTarget());
+                    else if (representation == 1) target.reset(new detail::CrackerTarget());
+                    else target.reset(new detail::ReloadedVectorTarget());
+                    target->load(sorted);
+
+                    std::atomic<size_t> claimed(0); // New keys handed out so far; latest reads look just below it.
+                    std::vector<MixedWorkloadResult> partial(threads);
+                    std::atomic<size_t> sink(0);
+                    Clock::time_point start = Clock::now();
+                    auto work = [&](int t) {
+                        size_t first = total_ops * t / threads, last = total_ops * (t + 1) / threads;
+                        size_t local = 0;
+                        for (size_t i = first; i < last; ++i) {
+                            const detail::MixedOperation& op = ops[i];
+                            LatencyHistogram* histogram = &partial[t].reads;
+                            Clock::time_point before = Clock::now();
+                            switch (op.op) {
+                            case detail::MixedOp::Read:
+                                local += target->read(op.key);
+                                break;
+                            case detail::MixedOp::LatestRead: {
+                                size_t count = std::min(claimed.load(std::memory_order_relaxed), new_keys.size());
+                                int key = op.key;
+                                if (count > 0) {
+                                    size_t back = static_cast<size_t>(std::pow(static_cast<double>(count) + 1.0, op.recency)) - 1;
+                                    key = new_keys[count - 1 - std::min(back, count - 1)];
+                                }
+                                local += target->read(key);
+                                break;
+                            }
+                            case detail::MixedOp::Insert: {
+                                histogram = &partial[t].writes;
+                                size_t slot = claimed.fetch_add(1, std::memory_order_relaxed);
+                                if (slot < new_keys.size()) target->insert(new_keys[slot]);
+                                break;
+                            }
+                            case detail::MixedOp::Erase:
+                                histogram = &partial[t].writes;
+                                target->erase(op.key);
+                                break;
+                            case detail::MixedOp::Scan:
+                                histogram = &partial[t].scans;
+                                local += target->scan(op.key, op.hi);
+                                break;
+                            }
+                            histogram->record(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - before).count()));
+                        }
+                        sink += local;
+                    };
+                    if (threads == 1) {
+                        work(0);
+                    }
+                    else {
+                        std::vector<std::thread> pool;
+                        for (int t = 0; t < threads; ++t) pool.emplace_back(work, t);
+                        for (std::thread& thread : pool) thread.join();
+                    }
+                    double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+                    target->flush();
+
+                    MixedWorkloadResult row;
+                    row.workload = mix.name;
+                    row.representation = target->name();
+                    row.threads = threads;
+                    row.ops_per_second = seconds > 0.0 ? total_ops / seconds : 0.0;
+                    for (const MixedWorkloadResult& part : partial) {
+                        row.reads.add(part.reads);
+                        row.writes.add(part.writes);
+                        row.scans.add(part.scans);
+                    }
+                    row.correct = target->matches(expected);
+                    rows.push_back(std::move(row));
+                }
+            }
+        }
+        return rows;
+    }
+
+    /**
+     * @brief Prints mixed workload rows as a table; latencies in microseconds, "-" where a mix has no such operation.
+     */
+    inline void printMixedWorkloadTable(const std::vector<MixedWorkloadResult>& rows, std::ostream& out) {
+        out << std::left << std::setw(20) << "Workload" << std::setw(26) << "Representation" << std::right << std::setw(8) << "Threads"
+            << std::setw(11) << "Kops/s" << std::setw(10) << "read p50" << std::setw(10) << "read p99" << std::setw(11) << "write p50"
+            << std::setw(11) << "write p99" << std::setw(12) << "write p99.9" << std::setw(10) << "scan p99" << "  Correct\n";
+        auto cell = [&](const LatencyHistogram& histogram, double percentile, int width) {
+            if (histogram.count() == 0) out << std::setw(width) << "-";
+            else out << std::setw(width) << histogram.valueAtPercentile(percentile) / 1000.0;
+        };
+        for (const MixedWorkloadResult& row : rows) {
+            out << std::left << std::setw(20) << row.workload << std::setw(26) << row.representation << std::right << std::setw(8) << row.threads
+                << std::fixed << std::setprecision(1) << std::setw(11) << row.ops_per_second / 1000.0 << std::setprecision(2);
+            cell(row.reads, 50.0, 10);
+            cell(row.reads, 99.0, 10);
+            cell(row.writes, 50.0, 11);
+            cell(row.writes, 99.0, 11);
+            cell(row.writes, 99.9, 12);
+            cell(row.scans, 99.0, 10);
+            out << "  " << (row.correct ? "yes" : "NO") << "\n";
+        }
+    }
+
+} // namespace ProjectUtils
+
+#endif // MIXED_WORKLOAD_H
@@ -0,0 +1,294 @@
+#ifndef NUMA_SUPPORT_H
+#define NUMA_SUPPORT_H
+
+#include "SearchIndex.h"  // For the per-replica search index.
+#include "MemoryBudget.h" // For formatBytes in the benchmark report.
+#include <vector>
+#include <string>
+#include <memory>
+#include <thread>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+#if defined(__linux__)
+#include <pthread.h> // For pthread_setaffinity_np.
+#include <sched.h>   // For cpu_set_t and sched_getcpu.
+#endif
+#ifdef PROJECT_HAVE_LIBNUMA
+#include <numa.h>
+#endif
+
+/*
+NUMA awareness for multi-socket hosts.
+
+    - `detectNumaTopology` finds the memory nodes and their CPUs through libnuma when the
+      build found it (PROJECT_HAVE_LIBNUMA), otherwise through /sys/devices/system/node.
+      Machines without NUMA information are reported as a single node holding every CPU.
+    - `NumaReplicatedDataset` optionally keeps one copy of the dataset and its search index per
+      node. Each copy is made by a thread pinned to that node, so the kernel's first-touch
+      policy places its pages in that node's memory.
+    - `NumaSearchPool` runs batches of lookups on worker threads pinned to each node; every
+      worker searches the replica of its own node, so no lookup crosses the interconnect.
+
+On a single-node machine all of this collapses to one replica and ordinary worker threads.
+*/
+
+namespace ProjectUtils {
+
+    // Memory nodes of this machine and the CPUs that belong to each.
+    struct NumaTopology {
+        std::vector<std::vector<int>> node_cpus; // node_cpus[n] = CPU ids of node n.
+        std::string source;                      // "libnuma", "sysfs" or "fallback".
+
+        int nodeCount() const { return static_cast<int>(node_cpus.size()); }
+
+        // The node that owns 'cpu', or 0 if it is unknown.
+        int nodeOfCpu(int cpu) const {
+            for (size_t n = 0; n < node_cpus.size(); ++n) {
+                if (std::find(node_cpus[n].begin(), node_cpus[n].end(), cpu) != node_cpus[n].end()) return static_cast<int>(n);
+            }
+            return 0;
+        }
+    };
+
+    namespace detail {
+        // Parses a kernel CPU list such as "0-3,8-11".
+        inline std::vector<int> parseCpuList(const std::string& text) {
+            std::vector<int> cpus;
+            std::stringstream ranges(text);
+            std::string range;
+            while (std::getline(ranges, range, ',')) {
+                if (range.empty() || range[0] == '\n') continue;
+                size_t dash = range.find('-');
+                try {
+                    int first = std::stoi(range.substr(0, dash));
+                    int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+                    for (int cpu = first; cpu <= last; ++cpu) cpus.push_back(cpu);
+                }
+                catch (const std::exception&) {
+                    // Ignore malformed entries; the caller falls back to one node if nothing parses.
+                }
+            }
+            return cpus;
+        }
+    }
+
+    /**
+     * @brief Detects the NUMA nodes of this machine and the CPUs on each.
+     *
+     * @return The topology; always at least one node.
+     */
+    inline NumaTopology detectNumaTopology() {
+        NumaTopology topology;
+#ifdef PROJECT_HAVE_LIBNUMA
+        if (numa_available() >= 0) {
+            topology.source = "libnuma";
+            struct bitmask* mask = numa_allocate_cpumask();
+            for (int node = 0; node <= numa_max_node(); ++node) {
+                if (numa_node_to_cpus(node, mask) != 0) continue;
+                std::vector<int> cpus;
+                for (unsigned cpu = 0; cpu < mask->size; ++cpu) {
+                    if (numa_bitmask_isbitset(mask, cpu)) cpus.push_back(static_cast<int>(cpu));
+                }
+                if (!cpus.empty()) topology.node_cpus.push_back(cpus);
+            }
+            numa_free_cpumask(mask);
+        }
+#endif
+        if (topology.node_cpus.empty()) {
+            // Node directories may be sparse (node0, node2, ...); probe a generous range.
+            for (int node = 0; node < 64; ++node) {
+                std::ifstream cpulist("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+                if (!cpulist.is_open()) continue;
+                std::string text;
+                std::getline(cpulist, text);
+                std::vector<int> cpus = detail::parseCpuList(text);
+                if (!cpus.empty()) topology.node_cpus.push_back(cpus);
+            }
+            if (!topology.node_cpus.empty()) topology.source = "sysfs";
+        }
+        if (topology.node_cpus.empty()) {
+            topology.source = "fallback";
+            int count = std::max(1u, std::thread::hardware_concurrency());
+            std::vector<int> cpus;
+            for (int cpu = 0; cpu < count; ++cpu) cpus.push_back(cpu);
+            topology.node_cpus.push_back(cpus);
+        }
+        return topology;
+    }
+
+    /**
+     * @brief Restricts the calling thread to the given CPUs.
+     *
+     * @return True if the affinity was applied, false if unsupported or refused.
+     */
+    inline bool pinCurrentThreadToCpus(const std::vector<int>& cpus) {
+#if defined(__linux__)
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (int cpu : cpus) {
+            if (cpu >= 0 && cpu < CPU_SETSIZE) CPU_SET(cpu, &set);
+        }
+        return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+        (void)cpus;
+        return false;
+#endif
+    }
+
+    /**
+     * @brief Returns the CPU the calling thread is running on, or -1 if unknown.
+     */
+    inline int currentCpu() {
+#if defined(__linux__)
+        return sched_getcpu();
+#else
+        return -1;
+#endif
+    }
+
+    /**
+     * @brief One copy of a sorted dataset and its search index per NUMA node.
+     */
+    class NumaReplicatedDataset {
+    public:
+        /**
+         * @brief Builds the replicas.
+         *
+         * @param sorted The sorted dataset to copy.
+         * @param topology The machine topology from detectNumaTopology().
+         * @param replicate True for one replica per node, false for a single replica on node 0.
+         * @param index_name The SearchIndex built over each replica.
+         */
+        void build(const std::vector<int>& sorted, const NumaTopology& topology, bool replicate, const std::string& index_name) {
+            replicas.clear();
+            int count = replicate ? topology.nodeCount() : 1;
+            replicas.resize(count);
+            std::vector<std::thread> builders;
+            for (int node = 0; node < count; ++node) {
+                // Copy from a thread pinned to the node so first touch puts the pages there.
+                builders.emplace_back([&, node]() {
+                    pinCurrentThreadToCpus(topology.node_cpus[node]);
+                    Replica& replica = replicas[node];
+                    replica.keys.reset(new std::vector<int>(sorted));
+                    replica.index = createSearchIndex(index_name);
+                    replica.index->build(*replica.keys);
+                });
+            }
+            for (std::thread& builder : builders) builder.join();
+        }
+
+        int replicaCount() const { return static_cast<int>(replicas.size()); }
+
+        // The index of the replica that lives on 'node' (replica 0 when not replicated).
+        const SearchIndex& indexForNode(int node) const {
+            return *replicas[node < static_cast<int>(replicas.size()) ? node : 0].index;
+        }
+
+        // The index of the replica local to the CPU the calling thread is running on.
+        const SearchIndex& localIndex(const NumaTopology& topology) const {
+            int cpu = currentCpu();
+            return indexForNode(cpu < 0 ? 0 : topology.nodeOfCpu(cpu));
+        }
+
+        // Bytes held by all replicas (keys plus indexes).
+        size_t memoryBytes() const {
+            size_t bytes = 0;
+            for (const Replica& replica : replicas) {
+                bytes += replica.keys->capacity() * sizeof(int) + replica.index->memoryBytes();
+            }
+            return bytes;
+        }
+
+    private:
+        struct Replica {
+            std::unique_ptr<std::vector<int>> keys; // Heap-allocated so the index's pointer stays valid.
+            std::unique_ptr<SearchIndex> index;
+        };
+        std::vector<Replica> replicas;
+    };
+
+    /**
+     * @brief Runs lookup batches on worker threads pinned per node, each using its local replica.
+     */
+    class NumaSearchPool {
+    public:
+        /**
+         * @param topology The machine topology from detectNumaTopology().
+         * @param threads_per_node Worker threads per node (0 = one per CPU of the node).
+         */
+        NumaSearchPool(const NumaTopology& topology, int threads_per_node = 0) : topology(topology) {
+            for (int node = 0; node < topology.nodeCount(); ++node) {
+                int count = threads_per_node > 0 ? threads_per_node : static_cast<int>(topology.node_cpus[node].size());
+                for (int t = 0; t < count; ++t) worker_nodes.push_back(node);
+            }
+        }
+
+        int threadCount() const { return static_cast<int>(worker_nodes.size()); }
+
+        /**
+         * @brief Searches 'targets' in parallel; each worker uses the replica of its node.
+         *
+         * @param data The replicated dataset.
+         * @param targets The values to search for.
+         * @param results Receives the sorted index of each target, or -1.
+         */
+        void searchBatch(const NumaReplicatedDataset& data, const std::vector<int>& targets, std::vector<int>& results) const {
+            results.assign(targets.size(), -1);
+            size_t workers = worker_nodes.size();
+            std::vector<std::thread> threads;
+            for (size_t w = 0; w < workers; ++w) {
+                size_t begin = targets.size() * w / workers;
+                size_t end = targets.size() * (w + 1) / workers;
+                int node = worker_nodes[w];
+                threads.emplace_back([&, begin, end, node]() {
+                    pinCurrentThreadToCpus(topology.node_cpus[node]);
+                    const SearchIndex& index = data.indexForNode(node);
+                    for (size_t i = begin; i < end; ++i) results[i] = index.search(targets[i]);
+                });
+            }
+            for (std::thread& thread : threads) thread.join();
+        }
+
+    private:
+        NumaTopology topology;
+        std::vector<int> worker_nodes; // Node of each worker thread.
+    };
+
+    /**
+     * @brief Prints the topology and compares lookup throughput with and without per-node replicas.
+     */
+    inline void runNumaBenchmark(const std::vector<int>& sorted, int threads_per_node, const std::string& index_name, std::ostream& out) {
+        NumaTopology topology = detectNumaTopology();
+        out << "NUMA topology (" << topology.source << "): " << topology.nodeCount() << " node(s)\n";
+        for (int node = 0; node < topology.nodeCount(); ++node) {
+            out << "  Node " << node << ": " << topology.node_cpus[node].size() << " CPU(s)\n";
+        }
+        if (topology.nodeCount() == 1) {
+            out << "Single-node machine: one replica is used and threads are not split across nodes.\n";
+        }
+
+        std::vector<int> queries = makeBenchmarkQueries(sorted, 1000000, 1.0, 11); // Hits only.
+
+        NumaSearchPool pool(topology, threads_per_node);
+        std::vector<int> results;
+        for (int replicate = 0; replicate <= 1; ++replicate) {
+            if (replicate == 1 && topology.nodeCount() == 1) break; // Same as the shared run.
+            NumaReplicatedDataset data;
+            data.build(sorted, topology, replicate == 1, index_name);
+            auto start = std::chrono::high_resolution_clock::now();
+            pool.searchBatch(data, queries, results);
+            auto end = std::chrono::high_resolution_clock::now();
+            double seconds = std::chrono::duration<double>(end - start).count();
+            out << (replicate ? "Replicated per node" : "Single shared copy ") << ": " << data.replicaCount() << " replica(s), "
+                << pool.threadCount() << " thread(s), " << static_cast<long long>(queries.size() / seconds) << " lookups/sec, "
+                << formatBytes(static_cast<double>(data.memoryBytes())) << "\n";
+        }
+    }
+
+} // namespace ProjectUtils
+
+#endif // NUMA_SUPPORT_H
@@ -10,6 +10,8 @@
 #include <fstream>     // For file input/output operations (std::ifstream).
 #include <string>      // For std::string and std::getline.
 #include <unordered_set> // For ensuring uniqueness during data generation.
+#include "Metrics.h"   // For the load-phase, ingest and dataset-size metrics.
+#include "SmallSearch.h" // For the small-window kernels that finish jump and interpolation search.
 
 
 /*
@@ -64,6 +66,7 @@ namespace ProjectUtils {
      * @param max_val The maximum possible value for generated integers.
      */
     void generateAndSortDataset(std::vector<int>& dataset, int num_elements, int min_val, int max_val) {
+        ScopedLoadPhase phase(LoadPhase::Generate); // Generation and sorting are reported as one phase.
         dataset.clear(); // Clear any existing data in the vector.
         dataset.reserve(num_elements); // Pre-allocate memory for efficiency.
 
@@ -85,17 +88,38 @@ namespace ProjectUtils {
     }
 
     /**
-     * @brief Loads a dataset of integers from a specified file, removes duplicates, and sorts it.
+     * @brief Builds a reproducible query set: 'hit_ratio' of the queries are keys of the dataset,
+     *        the rest are random values between its minimum and maximum.
+     *
+     * Every benchmark and profiler draws its lookups from here, so they all measure the same kind of workload.
+     */
+    inline std::vector<int> makeBenchmarkQueries(const std::vector<int>& sorted, size_t count, double hit_ratio = 0.5, unsigned seed = 2025) {
+        std::vector<int> queries;
+        if (sorted.empty()) return queries;
+        std::mt19937 rng(seed);
+        std::uniform_int_distribution<size_t> pick(0, sorted.size() - 1);
+        std::uniform_int_distribution<int> value(sorted.front(), sorted.back());
+        std::uniform_real_distribution<double> coin(0.0, 1.0);
+        queries.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            queries.push_back(coin(rng) < hit_ratio ? sorted[pick(rng)] : value(rng));
+        }
+        return queries;
+    }
+
+    /**
+     * @brief Loads a dataset of integers from a specified file without sorting it.
      *
      * This function reads integers from the given file, with each integer expected on a new line.
-     * It includes error handling for file opening and invalid data formats. After loading,
-     * the dataset is sorted in ascending order, and then duplicate values are removed.
+     * It includes error handling for file opening and invalid data formats. The values are kept
+     * in file order, duplicates included, so callers that do not need a sorted dataset (such as
+     * cracking mode) pay for a single pass over the file.
      *
-     * @param dataset A reference to the std::vector<int> to be populated and sorted.
+     * @param dataset A reference to the std::vector<int> to be populated.
      * @param filename The path to the input file containing integers.
      * @return True if the file was successfully opened and data loaded, false otherwise.
      */
-    bool loadAndSortDatasetFromFile(std::vector<int>& dataset, const std::string& filename) {
+    bool loadDatasetFromFile(std::vector<int>& dataset, const std::string& filename) {
         dataset.clear(); // Clear any existing data in the vector.
         std::ifstream infile(filename); // Attempt to open the file for reading.
 
@@ -104,9 +128,12 @@ namespace ProjectUtils {
             return false; // Indicate failure.
         }
 
+        ScopedLoadPhase phase(LoadPhase::Read);
         std::string line;
         int value;
+        uint64_t bytes_read = 0;
         while (std::getline(infile, line)) { // Read the file line by line.
+            bytes_read += line.size() + 1; // Count the newline that getline consumed.
             try {
                 value = std::stoi(line); // Convert the string line to an integer.
                 dataset.push_back(value); // Add the integer to the dataset.
@@ -119,22 +146,59 @@ namespace ProjectUtils {
             }
         }
         infile.close(); // Close the file after reading.
+        MetricsRegistry::global().addIngestedBytes(bytes_read);
 
         if (dataset.empty()) { // Check if any valid data was loaded.
             std::cerr << "Warning: No valid data loaded from file '" << filename << "'. Dataset is empty.\n";
             return false;
         }
+        return true; // Indicate success.
+    }
 
+    /**
+     * @brief Sorts a dataset in ascending order and removes duplicate values.
+     *
+     * This is the pipeline every loaded dataset goes through, so other key sets (such as the
+     * Morton codes of a point file) can reuse it and its load-phase metrics.
+     *
+     * @param dataset A reference to the std::vector<int> to be sorted and de-duplicated in place.
+     */
+    inline void sortAndDeduplicateDataset(std::vector<int>& dataset) {
         // Sort the loaded data in ascending order.
-        std::sort(dataset.begin(), dataset.end());
+        {
+            ScopedLoadPhase phase(LoadPhase::Sort);
+            std::sort(dataset.begin(), dataset.end());
+        }
 
         // --- NEW: Remove duplicates after sorting ---
-        // std::unique moves all unique elements to the beginning of the range
-        // and returns an iterator to the end of the unique range.
-        auto last = std::unique(dataset.begin(), dataset.end());
-        // erase then removes the elements from 'last' to the actual end of the vector.
-        dataset.erase(last, dataset.end());
+        {
+            ScopedLoadPhase phase(LoadPhase::Deduplicate);
+            // std::unique moves all unique elements to the beginning of the range
+            // and returns an iterator to the end of the unique range.
+            auto last = std::unique(dataset.begin(), dataset.end());
+            // erase then removes the elements from 'last' to the actual end of the vector.
+            dataset.erase(last, dataset.end());
+        }
         // --- END NEW ---
+        MetricsRegistry::global().setDatasetKeys(dataset.size());
+    }
+
+    /**
+     * @brief Loads a dataset of integers from a specified file, removes duplicates, and sorts it.
+     *
+     * This function reads integers from the given file, with each integer expected on a new line.
+     * It includes error handling for file opening and invalid data formats. After loading,
+     * the dataset is sorted in ascending order, and then duplicate values are removed.
+     *
+     * @param dataset A reference to the std::vector<int> to be populated and sorted.
+     * @param filename The path to the input file containing integers.
+     * @return True if the file was successfully opened and data loaded, false otherwise.
+     */
+    bool loadAndSortDatasetFromFile(std::vector<int>& dataset, const std::string& filename) {
+        if (!loadDatasetFromFile(dataset, filename)) { // Read and validate every line of the file.
+            return false;
+        }
+        sortAndDeduplicateDataset(dataset);
 
         std::cout << "Dataset loaded, duplicates removed, and sorted from '" << filename << "' with " << dataset.size() << " elements.\n";
         return true; // Indicate success.
@@ -147,13 +211,22 @@ namespace ProjectUtils {
      * containing the target value is found. A linear search is then performed within that block.
      * The optimal block size is typically the square root of the array size.
      *
-     * @param arr The sorted vector of integers to search within.
+     * The body is written against any array type with `size()` and `operator[]`, so the cache
+     * simulator can run the exact same probe sequence over an instrumented array.
+     *
+     * @tparam Array A random-access container of int, such as std::vector<int>.
+     * @param arr The sorted array of integers to search within.
      * @param target The integer value to search for.
      * @return The index of the target if found, otherwise -1.
      */
-    int jumpSearch(const std::vector<int>& arr, int target) {
-        int n = arr.size();
+    template<typename Array>
+    int jumpSearchOver(const Array& arr, int target) {
+        int n = static_cast<int>(arr.size());
         if (n == 0) return -1; // Handle empty array.
+        if (n <= SMALL_SEARCH_MAX) { // Tiny dataset: one small-window count beats the block setup.
+            int position = smallCountBelowOver(arr, 0, n, target);
+            return (position < n && arr[position] == target) ? position : -1;
+        }
 
         // Determine the block size (square root of array size).
         int step = static_cast<int>(std::sqrt(n));
@@ -167,9 +240,14 @@ namespace ProjectUtils {
                 return -1;
         }
 
-        // Perform linear search within the identified block (from 'prev' to 'step').
-        while (prev < n && arr[prev] < target) {
-            prev++; // Move linearly through the block.
+        // Perform linear search within the identified block (from 'prev' to 'step'),
+        // counting up to SMALL_SEARCH_MAX keys at a time with the small-window kernel.
+        int block_end = std::min(step, n);
+        while (prev < block_end) {
+            int length = std::min(SMALL_SEARCH_MAX, block_end - prev);
+            int below = smallCountBelowOver(arr, prev, length, target);
+            prev += below; // Move past the keys smaller than the target.
+            if (below < length) break;
         }
 
         // Check if the target is found at the current position.
@@ -180,6 +258,13 @@ namespace ProjectUtils {
         return -1; // Target not found in the array.
     }
 
+    /**
+     * @brief Jump Search over a sorted vector; see `jumpSearchOver`.
+     */
+    int jumpSearch(const std::vector<int>& arr, int target) {
+        return jumpSearchOver(arr, target);
+    }
+
 
     /**
      * @brief Implements the Interpolation Search algorithm for sorted arrays.
@@ -188,25 +273,33 @@ namespace ProjectUtils {
      * distributed data. It estimates the position of the target value based on
      * its value relative to the values at the ends of the search space.
      *
-     * @param arr The sorted vector of integers to search within.
+     * Like `jumpSearchOver`, the body accepts any array type with `size()` and `operator[]`.
+     *
+     * @tparam Array A random-access container of int, such as std::vector<int>.
+     * @param arr The sorted array of integers to search within.
      * @param target The integer value to search for.
      * @return The index of the target if found, otherwise -1.
      */
-    int interpolationSearch(const std::vector<int>& arr, int target) {
+    template<typename Array>
+    int interpolationSearchOver(const Array& arr, int target) {
         int low = 0;
-        int high = arr.size() - 1;
+        int high = static_cast<int>(arr.size()) - 1;
+        // Windows up to this size are finished by the small-window kernel instead of more probes.
+        const int last_mile = high < SMALL_SEARCH_MAX ? SMALL_SEARCH_MAX : SMALL_SEARCH_PROBE_LAST_MILE;
 
         while (low <= high && target >= arr[low] && target <= arr[high]) {
-            // If the search space has shrunk to a single element.
-            if (low == high) {
-                if (arr[low] == target) return low;
-                return -1; // Not found
+            // target <= arr[high], so the count stops inside the window.
+            if (high - low < last_mile) {
+                int pos = low + smallCountBelowOver(arr, low, high - low + 1, target);
+                return arr[pos] == target ? pos : -1;
             }
 
             // Calculate the probe position using the interpolation formula.
-            // Using long long for intermediate calculations to prevent overflow,
+            // Using floating point for intermediate calculations to prevent overflow,
             // especially when (high - low) * (target - arr[low]) is large.
-            long long pos_calc = (long long)low + (((long long)high - low) / (arr[high] - arr[low])) * (target - arr[low]);
+            // Multiply before dividing: dividing first truncates the ratio to 0 whenever the value
+            // range is wider than the index range, which turns the search into a linear scan.
+            long long pos_calc = (long long)low + (long long)(((double)high - low) * ((double)target - arr[low]) / ((double)arr[high] - arr[low]));
 
             // Ensure pos_calc is within valid array bounds [low, high].
             // This check is important to prevent out-of-bounds access if the formula
@@ -231,6 +324,13 @@ namespace ProjectUtils {
         return -1; // Target not found.
     }
 
+    /**
+     * @brief Interpolation Search over a sorted vector; see `interpolationSearchOver`.
+     */
+    int interpolationSearch(const std::vector<int>& arr, int target) {
+        return interpolationSearchOver(arr, target);
+    }
+
 
     /**
      * @brief Measures the execution time of a given search function.
@@ -0,0 +1,309 @@
+#ifndef RANGE_FILTER_H
+#define RANGE_FILTER_H
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+#include <algorithm>
+
+/*
+Range emptiness filter: answers "may the dataset hold any key in [lo, hi]?" without searching.
+
+A point filter cannot answer this, so the filter stores the prefixes of the keys, Rosetta
+style. Keys are first offset by the smallest key, so a dataset spanning 2^B values has B-bit
+offsets. The prefix of level p is the top p bits of an offset, and a prefix stands for an
+aligned block of 2^(B - p) values. Any range [lo, hi] splits into at most 2B such dyadic
+blocks, and the range is non-empty iff one of their prefixes is present.
+
+Levels:
+    - Coarse levels (up to bitmap_level) are an exact bitmap with one bit per prefix. A
+      summary bitmap with one bit per word sits on top of it, and so on, so "is any bit set
+      in [a, b]" takes a few word tests however wide the range is. The bitmap gets about the
+      bits two Bloom levels would use, so for dense key ranges (such as 100k keys in 1..1M)
+      it covers every level and the filter is exact.
+    - The finer levels are stored in one Bloom filter keyed by (level, prefix). Each probe
+      touches a single 64-byte block. A positive below the last level is "doubted": the
+      filter recurses into the two child prefixes and reports the range only if a
+      full-length key is reached.
+    - With a bits-per-key cap too small for every finer level, only the bottom ones are
+      stored. A block above them is split into its children until the Bloom levels are
+      reached, but at most RANGE_FILTER_MAX_SPLIT_LEVELS levels deep; a wider block is
+      reported as "may contain", so the range false-positive rate then exceeds the target.
+
+A query first asks the bitmap about the cells that lie wholly inside the range. Only the
+partial cells at its two ends, and only if their bit is set, go down to the Bloom levels.
+
+The target false-positive rate is for a whole range query. Inside each partial cell the range
+splits into at most one dyadic block per level, and a block h levels above the keys is only
+reported after a chain of h + 1 false probes, so with per-probe rate p a partial cell passes
+with probability at most p / (1 - 2p). The probe rate is chosen so that the two ends together
+stay within the target, and the bits per stored prefix follow from it (1.44 * log2(1 / p)).
+By default every finer level is stored, so the memory follows from the target; an explicit
+cap smaller than that is honoured, and requiredBitsPerKey() says what the target would need.
+There are no false negatives.
+*/
+
+namespace ProjectUtils {
+
+    // Memory cap, in bits per key, meaning "as much as the target false-positive rate needs".
+    const double RANGE_FILTER_UNCAPPED = 0.0;
+
+    // Unstored levels a block may be split through before the filter gives up and answers "may contain".
+    const int RANGE_FILTER_MAX_SPLIT_LEVELS = 3;
+
+    /**
+     * @brief Prefix bitmap plus prefix Bloom filter over a sorted dataset, for range-emptiness checks.
+     */
+    class RangeFilter {
+    public:
+        RangeFilter() : min_key(0), max_key(-1), key_bits(0), bitmap_level(0), first_bloom_level(1), num_blocks(0), num_hashes(1), bits_per_prefix(0.0), fpr(0.0), required_bits_per_key(0.0), num_keys(0) {}
+
+        /**
+         * @brief Builds the filter.
+         *
+         * @param sorted The sorted, de-duplicated dataset; it is not referenced after build.
+         * @param target_fpr False-positive rate of a range query, e.g. 0.01.
+         * @param max_bits_per_key Memory cap for the bitmap and the Bloom levels together, or
+         *        RANGE_FILTER_UNCAPPED to store every level the target needs. A cap smaller than
+         *        requiredBitsPerKey() keeps only the bottom Bloom levels, and meetsTarget() is false.
+         */
+        void build(const std::vector<int>& sorted, double target_fpr = 0.01, double max_bits_per_key = RANGE_FILTER_UNCAPPED) {
+            *this = RangeFilter();
+            fpr = std::min(0.5, std::max(1e-6, target_fpr));
+            num_keys = sorted.size();
+            if (sorted.empty()) return;
+            min_key = sorted.front();
+            max_key = sorted.back();
+            uint32_t span = offsetOf(max_key);
+            while (key_bits < 32 && (span >> key_bits) != 0) ++key_bits;
+
+            // Each of the two partial cells passes with probability at most p / (1 - 2p); solve 2p / (1 - 2p) = fpr.
+            double probe_fpr = fpr / (2.0 * (1.0 + fpr));
+            bits_per_prefix = 1.44 * std::log2(1.0 / probe_fpr);
+            double n = static_cast<double>(sorted.size());
+            std::vector<size_t> distinct(key_bits + 1, 0); // Distinct prefixes per level.
+            for (int level = key_bits; level > 0; --level) {
+                int shift = key_bits - level;
+                for (size_t i = 0; i < sorted.size(); ++i) {
+                    distinct[level] += i == 0 || (offsetOf(sorted[i]) >> shift) != (offsetOf(sorted[i - 1]) >> shift);
+                }
+            }
+
+            // The bitmap may use about as many bits as two Bloom levels would, and at most half of a cap.
+            bool capped = max_bits_per_key > 0.0;
+            double budget_bits = max_bits_per_key * n;
+            double bitmap_bits = std::max(64.0, 2.0 * bits_per_prefix * n);
+            required_bits_per_key = layoutBits(distinct, bitmapLevelFor(bitmap_bits)) / n;
+            if (capped) bitmap_bits = std::max(64.0, std::min(bitmap_bits, budget_bits / 2.0));
+            bitmap_level = bitmapLevelFor(bitmap_bits);
+
+            std::vector<uint64_t> cells((size_t(1) << bitmap_level) / 64 + 1, 0);
+            for (int key : sorted) {
+                uint64_t cell = offsetOf(key) >> (key_bits - bitmap_level);
+                cells[cell >> 6] |= uint64_t(1) << (cell & 63);
+            }
+            bitmaps.clear();
+            bitmaps.push_back(std::move(cells));
+            while (bitmaps.back().size() > 1) {
+                const std::vector<uint64_t>& below = bitmaps.back();
+                std::vector<uint64_t> summary(below.size() / 64 + 1, 0);
+                for (size_t w = 0; w < below.size(); ++w) {
+                    if (below[w]) summary[w >> 6] |= uint64_t(1) << (w & 63);
+                }
+                bitmaps.push_back(std::move(summary));
+            }
+
+            first_bloom_level = key_bits + 1;
+            if (bitmap_level == key_bits) return; // The bitmap is exact at full resolution.
+
+            // Add levels from the bottom up: all of them, or with a cap while their prefixes fit in what the bitmap left over.
+            double bloom_budget = budget_bits - 64.0 * static_cast<double>(memoryBytes() / sizeof(uint64_t));
+            size_t prefixes = 0;
+            for (int level = key_bits; level > bitmap_level; --level) {
+                if (capped && bits_per_prefix * static_cast<double>(prefixes + distinct[level]) > bloom_budget) break;
+                prefixes += distinct[level];
+                first_bloom_level = level;
+            }
+            if (prefixes == 0) return; // No room for a Bloom level: partial cells answer "may contain".
+            num_blocks = std::max<size_t>(1, static_cast<size_t>(std::ceil(bits_per_prefix * prefixes / 512.0)));
+            num_hashes = std::min(16, std::max(1, static_cast<int>(std::lround(bits_per_prefix * 0.693))));
+            blocks.assign(num_blocks * 8, 0);
+            for (int level = first_bloom_level; level <= key_bits; ++level) {
+                int shift = key_bits - level;
+                for (size_t i = 0; i < sorted.size(); ++i) {
+                    uint32_t prefix = offsetOf(sorted[i]) >> shift;
+                    if (i == 0 || prefix != (offsetOf(sorted[i - 1]) >> shift)) bloomInsert(level, prefix);
+                }
+            }
+        }
+
+        /**
+         * @brief False if the dataset certainly holds no key in [lo, hi]; true if it may.
+         */
+        bool mayContain(int lo, int hi) const {
+            if (num_keys == 0 || lo > hi || hi < min_key || lo > max_key) return false;
+            uint64_t a = offsetOf(std::max(lo, min_key));
+            uint64_t b = offsetOf(std::min(hi, max_key));
+            int shift = key_bits - bitmap_level;
+            uint64_t first_cell = a >> shift, last_cell = b >> shift;
+            if (shift == 0) return anyCellSet(0, first_cell, last_cell);
+
+            // Bitmap cells that lie wholly inside the range answer exactly, however many there are.
+            uint64_t cell_mask = (uint64_t(1) << shift) - 1;
+            bool left_partial = (a & cell_mask) != 0;
+            bool right_partial = ((b + 1) & cell_mask) != 0;
+            uint64_t full_first = first_cell + (left_partial ? 1 : 0);
+            if (!right_partial || last_cell > 0) {
+                uint64_t full_last = last_cell - (right_partial ? 1 : 0);
+                if (full_first <= full_last && anyCellSet(0, full_first, full_last)) return true;
+            }
+
+            // Only the partial cells at the ends, and only if their bit is set, need the Bloom levels.
+            if (first_cell == last_cell) return (left_partial || right_partial) && cellSet(first_cell) && bloomRange(a, b);
+            if (left_partial && cellSet(first_cell) && bloomRange(a, ((first_cell + 1) << shift) - 1)) return true;
+            return right_partial && cellSet(last_cell) && bloomRange(last_cell << shift, b);
+        }
+
+        /**
+         * @brief True if the dataset may hold 'key'.
+         */
+        bool mayContain(int key) const { return mayContain(key, key); }
+
+        size_t memoryBytes() const {
+            size_t bytes = blocks.capacity() * sizeof(uint64_t);
+            for (const std::vector<uint64_t>& level : bitmaps) bytes += level.capacity() * sizeof(uint64_t);
+            return bytes;
+        }
+
+        double targetFpr() const { return fpr; }
+        double bitsPerKey() const { return num_keys ? 8.0 * memoryBytes() / num_keys : 0.0; }
+
+        // True if the bitmap covers every level, so there are no false positives at all.
+        bool isExact() const { return bitmap_level == key_bits; }
+
+        // Number of prefix levels held in the Bloom filter (the bottom ones).
+        int bloomLevels() const { return key_bits + 1 - first_bloom_level; }
+
+        // Number of levels below the bitmap; the target false-positive rate holds only if all of them are in the Bloom filter.
+        int neededBloomLevels() const { return key_bits - bitmap_level; }
+
+        // False if a bits-per-key cap left out levels the target needs, so ranges may pass more often than targetFpr().
+        bool meetsTarget() const { return bloomLevels() == neededBloomLevels(); }
+
+        // Bits per key an uncapped build of the same data and target uses.
+        double requiredBitsPerKey() const { return required_bits_per_key; }
+
+    private:
+        uint32_t offsetOf(int key) const { return static_cast<uint32_t>(key) - static_cast<uint32_t>(min_key); }
+
+        // Largest level, up to key_bits, whose bitmap of 2^level bits fits in 'bitmap_bits'.
+        int bitmapLevelFor(double bitmap_bits) const {
+            int level = 0;
+            while (level < key_bits && std::ldexp(1.0, level + 1) <= bitmap_bits) ++level;
+            return level;
+        }
+
+        // Bits of a bitmap of 'level' (with its summaries) plus a Bloom filter holding every level below it.
+        double layoutBits(const std::vector<size_t>& distinct, int level) const {
+            double words = 0.0;
+            for (double w = std::floor(std::ldexp(1.0, level) / 64.0) + 1.0; ; w = std::floor(w / 64.0) + 1.0) {
+                words += w;
+                if (w <= 1.0) break;
+            }
+            double prefixes = 0.0;
+            for (int l = level + 1; l <= key_bits; ++l) prefixes += static_cast<double>(distinct[l]);
+            return 64.0 * words + (prefixes > 0.0 ? 512.0 * std::max(1.0, std::ceil(bits_per_prefix * prefixes / 512.0)) : 0.0);
+        }
+
+        bool cellSet(uint64_t cell) const { return (bitmaps[0][cell >> 6] >> (cell & 63) & 1) != 0; }
+
+        // Checks the dyadic blocks of [a, b], which lies inside one bitmap cell, from left to right.
+        bool bloomRange(uint64_t a, uint64_t b) const {
+            if (blocks.empty()) return true;
+            while (a <= b) {
+                int size_bits = a == 0 ? key_bits : std::min(key_bits, __builtin_ctzll(a));
+                while ((a + (uint64_t(1) << size_bits) - 1) > b) --size_bits;
+                if (doubt(key_bits - size_bits, static_cast<uint32_t>(a >> size_bits))) return true;
+                a += uint64_t(1) << size_bits;
+            }
+            return false;
+        }
+
+        // Splits blocks of unstored levels, then follows positive Bloom probes down to full-length keys.
+        bool doubt(int level, uint32_t prefix) const {
+            if (level < first_bloom_level) {
+                if (first_bloom_level - level > RANGE_FILTER_MAX_SPLIT_LEVELS) return true;
+                return doubt(level + 1, prefix << 1) || doubt(level + 1, (prefix << 1) | 1);
+            }
+            if (!bloomContains(level, prefix)) return false;
+            if (level == key_bits) return true;
+            return doubt(level + 1, prefix << 1) || doubt(level + 1, (prefix << 1) | 1);
+        }
+
+        // Is any bit in [a, b] of bitmaps[depth] set? Whole words in between are read from the summary above.
+        bool anyCellSet(size_t depth, uint64_t a, uint64_t b) const {
+            const std::vector<uint64_t>& bits = bitmaps[depth];
+            uint64_t wa = a >> 6, wb = b >> 6;
+            uint64_t low_mask = ~uint64_t(0) << (a & 63);
+            uint64_t high_mask = ~uint64_t(0) >> (63 - (b & 63));
+            if (wa == wb) return (bits[wa] & low_mask & high_mask) != 0;
+            if (bits[wa] & low_mask) return true;
+            if (bits[wb] & high_mask) return true;
+            if (wa + 1 > wb - 1) return false;
+            return anyCellSet(depth + 1, wa + 1, wb - 1);
+        }
+
+        static uint64_t mix(uint64_t x) {
+            x += 0x9E3779B97F4A7C15ull;
+            x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+            x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+            return x ^ (x >> 31);
+        }
+
+        // Calls visit(word, bit) for each of the num_hashes bits of (level, prefix), all in one 512-bit block.
+        template<typename Visit>
+        bool forEachBloomBit(int level, uint32_t prefix, Visit visit) const {
+            uint64_t h = mix((uint64_t(level) << 32) | prefix);
+            size_t block = static_cast<size_t>(((h >> 32) * num_blocks) >> 32);
+            uint64_t bits = mix(h);
+            for (int i = 0, used = 0; i < num_hashes; ++i, used += 9) {
+                if (used + 9 > 64) {
+                    bits = mix(bits);
+                    used = 0;
+                }
+                unsigned bit = static_cast<unsigned>(bits >> used) & 511;
+                if (!visit(block * 8 + (bit >> 6), bit & 63)) return false;
+            }
+            return true;
+        }
+
+        void bloomInsert(int level, uint32_t prefix) {
+            forEachBloomBit(level, prefix, [&](size_t word, unsigned bit) {
+                blocks[word] |= uint64_t(1) << bit;
+                return true;
+            });
+        }
+
+        bool bloomContains(int level, uint32_t prefix) const {
+            return forEachBloomBit(level, prefix, [&](size_t word, unsigned bit) { return (blocks[word] >> bit & 1) != 0; });
+        }
+
+        int min_key;
+        int max_key;
+        int key_bits;     // B: bits of the largest offset.
+        int bitmap_level; // Levels 0..bitmap_level are exact bitmaps.
+        int first_bloom_level; // Levels first_bloom_level..key_bits are in the Bloom filter.
+        std::vector<std::vector<uint64_t>> bitmaps; // bitmaps[0] has one bit per prefix of bitmap_level; each next one summarizes words.
+        std::vector<uint64_t> blocks;               // Blocked Bloom filter, 8 words per block.
+        size_t num_blocks;
+        int num_hashes;
+        double bits_per_prefix;
+        double fpr;        // Target false-positive rate of a range query.
+        double required_bits_per_key;
+        size_t num_keys;
+    };
+
+} // namespace ProjectUtils
+
+#endif // RANGE_FILTER_H
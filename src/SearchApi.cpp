@@ -0,0 +1,381 @@
+#define EDR_BUILDING_LIBRARY
+#include "SearchApi.h"
+#include "SearchIndex.h" // For the search functions, layouts and createSearchIndex.
+#include <vector>
+#include <string>
+#include <memory>
+#include <atomic>
+#include <chrono>
+#include <climits>
+#include <cstring>
+#include <algorithm>
+#include <type_traits>
+#include <new>
+
+/*
+Implementation of the C API in SearchApi.h (the shared library target edrsearch).
+
+The SearchIndex classes are built from a std::vector, which a caller-owned buffer cannot
+become without a copy. The library therefore runs the search functions directly over a view
+of the borrowed keys:
+    - sorted, jump, interpolation and kary-interpolation read the keys in place,
+    - eytzinger and btree read the keys once to build their own layout (index memory).
+Other registered indexes (radix, linear-model) are wrapped as they are, over a private
+sorted copy. edr_index_stats.copied_bytes reports that copy.
+*/
+
+static_assert(std::is_same<int32_t, int>::value, "The C API passes keys as int32_t and the engines search int.");
+
+struct edr_dataset {
+    const int* keys;
+    size_t count;
+    std::vector<int> owned; // Only for datasets made by edr_dataset_create_copy.
+};
+
+namespace {
+
+    typedef std::chrono::steady_clock Clock;
+
+    // Read-only view of the dataset keys, indexable like the std::vector the templates expect.
+    struct KeyView {
+        const int* keys;
+        size_t count;
+        size_t size() const { return count; }
+        const int* data() const { return keys; } // Lets the small-window kernels read the keys directly.
+        int operator[](size_t i) const { return keys[i]; }
+    };
+
+    class Engine {
+    public:
+        virtual ~Engine() {}
+        virtual int find(int key) const = 0;
+        // Position of the first key >= 'key' in 'keys' (keys.count if none). Engines with a
+        // lower-bound walk override this; the others answer hits with find and finish misses
+        // with the small-window lower bound.
+        virtual int lowerBound(KeyView keys, int key) const {
+            int position = find(key);
+            return position != -1 ? position : ProjectUtils::smallLowerBound(keys.keys, static_cast<int>(keys.count), key);
+        }
+        virtual size_t memoryBytes() const = 0;
+        virtual size_t copiedBytes() const { return 0; }
+    };
+
+    class SortedEngine : public Engine {
+    public:
+        explicit SortedEngine(KeyView keys) : keys(keys) {}
+        int find(int key) const override {
+            int slot = ProjectUtils::sortedLowerBoundSlot(keys.keys, static_cast<int>(keys.count), key);
+            return keys[slot] == key ? slot : -1;
+        }
+        int lowerBound(KeyView, int key) const override {
+            int slot = ProjectUtils::sortedLowerBoundSlot(keys.keys, static_cast<int>(keys.count), key);
+            return keys[slot] < key ? static_cast<int>(keys.count) : slot;
+        }
+        size_t memoryBytes() const override { return 0; }
+    private:
+        KeyView keys;
+    };
+
+    class JumpEngine : public Engine {
+    public:
+        explicit JumpEngine(KeyView keys) : keys(keys) {}
+        int find(int key) const override { return ProjectUtils::jumpSearchOver(keys, key); }
+        size_t memoryBytes() const override { return 0; }
+    private:
+        KeyView keys;
+    };
+
+    class InterpolationEngine : public Engine {
+    public:
+        explicit InterpolationEngine(KeyView keys) : keys(keys) {}
+        int find(int key) const override { return ProjectUtils::interpolationSearchOver(keys, key); }
+        size_t memoryBytes() const override { return 0; }
+    private:
+        KeyView keys;
+    };
+
+    class KaryInterpolationEngine : public Engine {
+    public:
+        explicit KaryInterpolationEngine(KeyView keys) : keys(keys) {}
+        int find(int key) const override { return ProjectUtils::kAryInterpolationSearchOver(keys.keys, static_cast<int>(keys.count), key); }
+        size_t memoryBytes() const override { return 0; }
+    private:
+        KeyView keys;
+    };
+
+    // Eytzinger or B-tree layout built from the view; the same search as LayoutIndex.
+    class LayoutEngine : public Engine {
+    public:
+        LayoutEngine(KeyView keys, ProjectUtils::SearchLayout kind) : kind(kind), num_keys(static_cast<int>(keys.count)) {
+            if (kind == ProjectUtils::SearchLayout::Eytzinger) ProjectUtils::buildEytzingerLayout(keys, layout, ranks);
+            else ProjectUtils::buildBTreeLayout(keys, layout, ranks);
+        }
+        int find(int key) const override {
+            if (kind == ProjectUtils::SearchLayout::Eytzinger) {
+                int slot = ProjectUtils::eytzingerLowerBoundSlot(layout.data(), num_keys, key);
+                return (slot != 0 && layout[slot] == key) ? ranks[slot] : -1;
+            }
+            int slot = ProjectUtils::bTreeLowerBoundSlot(layout.data(), static_cast<int>(layout.size()) / ProjectUtils::BTREE_NODE_KEYS, key);
+            return (slot != -1 && layout[slot] == key) ? ranks[slot] : -1;
+        }
+        int lowerBound(KeyView, int key) const override {
+            if (kind == ProjectUtils::SearchLayout::Eytzinger) {
+                int slot = ProjectUtils::eytzingerLowerBoundSlot(layout.data(), num_keys, key);
+                return slot != 0 ? ranks[slot] : num_keys;
+            }
+            int slot = ProjectUtils::bTreeLowerBoundSlot(layout.data(), static_cast<int>(layout.size()) / ProjectUtils::BTREE_NODE_KEYS, key);
+            return (slot != -1 && ranks[slot] != -1) ? ranks[slot] : num_keys; // Padding slots come after every key.
+        }
+        size_t memoryBytes() const override { return (layout.capacity() + ranks.capacity()) * sizeof(int); }
+    private:
+        ProjectUtils::SearchLayout kind;
+        int num_keys;
+        std::vector<int> layout;
+        std::vector<int> ranks;
+    };
+
+    // Any other registered SearchIndex, over its own copy of the keys.
+    class CopiedEngine : public Engine {
+    public:
+        CopiedEngine(KeyView keys, std::unique_ptr<ProjectUtils::SearchIndex> index)
+            : copy(keys.keys, keys.keys + keys.count), index(std::move(index)) {
+            this->index->build(copy);
+        }
+        int find(int key) const override { return index->search(key); }
+        size_t memoryBytes() const override { return index->memoryBytes(); }
+        size_t copiedBytes() const override { return copy.capacity() * sizeof(int); }
+    private:
+        std::vector<int> copy;
+        std::unique_ptr<ProjectUtils::SearchIndex> index;
+    };
+
+    const char* const ZERO_COPY_ENGINES[] = { "sorted", "jump", "interpolation", "kary-interpolation", "eytzinger", "btree" };
+
+    std::unique_ptr<Engine> createEngine(KeyView keys, const std::string& name) {
+        if (name == "sorted") return std::unique_ptr<Engine>(new SortedEngine(keys));
+        if (name == "jump") return std::unique_ptr<Engine>(new JumpEngine(keys));
+        if (name == "interpolation") return std::unique_ptr<Engine>(new InterpolationEngine(keys));
+        if (name == "kary-interpolation") return std::unique_ptr<Engine>(new KaryInterpolationEngine(keys));
+        if (name == "eytzinger") return std::unique_ptr<Engine>(new LayoutEngine(keys, ProjectUtils::SearchLayout::Eytzinger));
+        if (name == "btree") return std::unique_ptr<Engine>(new LayoutEngine(keys, ProjectUtils::SearchLayout::BTree));
+        std::unique_ptr<ProjectUtils::SearchIndex> index = ProjectUtils::createSearchIndex(name);
+        if (!index) return nullptr;
+        return std::unique_ptr<Engine>(new CopiedEngine(keys, std::move(index)));
+    }
+
+    // Nanoseconds for one pass of 'probes' through 'engine'; the checksum keeps the loop alive.
+    uint64_t timeEngine(const Engine& engine, const std::vector<int>& probes) {
+        volatile int checksum = 0;
+        auto start = Clock::now();
+        int sum = 0;
+        for (int key : probes) sum += engine.find(key);
+        auto end = Clock::now();
+        checksum = sum;
+        (void)checksum;
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+    }
+
+    // Times every zero-copy engine on present and absent sample keys and returns the fastest.
+    std::unique_ptr<Engine> selectFastestEngine(KeyView keys, std::string& kind) {
+        const size_t SAMPLE = 4096;
+        std::vector<int> probes;
+        size_t step = std::max<size_t>(1, keys.count / SAMPLE);
+        for (size_t i = 0; i < keys.count; i += step) {
+            probes.push_back(keys[i]);
+            if (keys[i] != INT_MAX) probes.push_back(keys[i] + 1); // Usually a miss.
+        }
+        std::unique_ptr<Engine> best;
+        uint64_t best_ns = UINT64_MAX;
+        for (const char* name : ZERO_COPY_ENGINES) {
+            std::unique_ptr<Engine> engine = createEngine(keys, name);
+            uint64_t ns = UINT64_MAX;
+            for (int round = 0; round < 3; ++round) ns = std::min(ns, timeEngine(*engine, probes));
+            if (ns < best_ns) {
+                best_ns = ns;
+                best = std::move(engine);
+                kind = name;
+            }
+        }
+        return best;
+    }
+
+} // namespace
+
+struct edr_index {
+    const edr_dataset* dataset;
+    std::string kind;
+    std::unique_ptr<Engine> engine;
+    uint64_t build_ns;
+    mutable std::atomic<uint64_t> queries;
+    mutable std::atomic<uint64_t> hits;
+};
+
+extern "C" {
+
+EDR_API int edr_api_version(void) {
+    return EDR_API_VERSION;
+}
+
+EDR_API const char* edr_status_string(edr_status status) {
+    switch (status) {
+        case EDR_OK: return "ok";
+        case EDR_ERROR_INVALID_ARGUMENT: return "invalid argument";
+        case EDR_ERROR_NOT_SORTED: return "keys are not strictly ascending";
+        case EDR_ERROR_UNKNOWN_INDEX: return "unknown index name";
+        case EDR_ERROR_OUT_OF_MEMORY: return "out of memory";
+        case EDR_ERROR_TOO_LARGE: return "too many keys";
+        case EDR_ERROR_INTERNAL: return "internal error";
+    }
+    return "unknown status";
+}
+
+EDR_API size_t edr_index_name_count(void) {
+    static const std::vector<std::string> names = ProjectUtils::registeredSearchIndexNames();
+    return names.size();
+}
+
+EDR_API const char* edr_index_name(size_t i) {
+    static const std::vector<std::string> names = ProjectUtils::registeredSearchIndexNames();
+    return i < names.size() ? names[i].c_str() : nullptr;
+}
+
+EDR_API edr_status edr_dataset_create(const int32_t* keys, size_t count, edr_dataset** out) {
+    if (!out || !keys || count == 0) return EDR_ERROR_INVALID_ARGUMENT;
+    *out = nullptr;
+    if (count > static_cast<size_t>(INT_MAX)) return EDR_ERROR_TOO_LARGE;
+    for (size_t i = 1; i < count; ++i) {
+        if (keys[i - 1] >= keys[i]) return EDR_ERROR_NOT_SORTED;
+    }
+    edr_dataset* dataset = new (std::nothrow) edr_dataset();
+    if (!dataset) return EDR_ERROR_OUT_OF_MEMORY;
+    dataset->keys = keys;
+    dataset->count = count;
+    *out = dataset;
+    return EDR_OK;
+}
+
+EDR_API edr_status edr_dataset_create_copy(const int32_t* keys, size_t count, edr_dataset** out) {
+    if (!out || !keys || count == 0) return EDR_ERROR_INVALID_ARGUMENT;
+    *out = nullptr;
+    if (count > static_cast<size_t>(INT_MAX)) return EDR_ERROR_TOO_LARGE;
+    try {
+        std::unique_ptr<edr_dataset> dataset(new edr_dataset());
+        dataset->owned.assign(keys, keys + count);
+        std::sort(dataset->owned.begin(), dataset->owned.end());
+        dataset->owned.erase(std::unique(dataset->owned.begin(), dataset->owned.end()), dataset->owned.end());
+        dataset->keys = dataset->owned.data();
+        dataset->count = dataset->owned.size();
+        *out = dataset.release();
+        return EDR_OK;
+    }
+    catch (const std::bad_alloc&) {
+        return EDR_ERROR_OUT_OF_MEMORY;
+    }
+}
+
+EDR_API void edr_dataset_destroy(edr_dataset* dataset) {
+    delete dataset;
+}
+
+EDR_API size_t edr_dataset_size(const edr_dataset* dataset) {
+    return dataset ? dataset->count : 0;
+}
+
+EDR_API const int32_t* edr_dataset_keys(const edr_dataset* dataset) {
+    return dataset ? dataset->keys : nullptr;
+}
+
+EDR_API edr_status edr_index_create(const edr_dataset* dataset, const char* name, edr_index** out) {
+    if (!out || !dataset || !name) return EDR_ERROR_INVALID_ARGUMENT;
+    *out = nullptr;
+    try {
+        std::unique_ptr<edr_index> index(new edr_index());
+        KeyView keys = { dataset->keys, dataset->count };
+        auto start = Clock::now();
+        if (std::string(name) == "auto") {
+            index->engine = selectFastestEngine(keys, index->kind);
+        }
+        else {
+            index->engine = createEngine(keys, name);
+            index->kind = name;
+        }
+        if (!index->engine) return EDR_ERROR_UNKNOWN_INDEX;
+        index->build_ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+        index->dataset = dataset;
+        index->queries.store(0);
+        index->hits.store(0);
+        *out = index.release();
+        return EDR_OK;
+    }
+    catch (const std::bad_alloc&) {
+        return EDR_ERROR_OUT_OF_MEMORY;
+    }
+    catch (...) {
+        return EDR_ERROR_INTERNAL;
+    }
+}
+
+EDR_API void edr_index_destroy(edr_index* index) {
+    delete index;
+}
+
+EDR_API const char* edr_index_kind(const edr_index* index) {
+    return index ? index->kind.c_str() : nullptr;
+}
+
+EDR_API int64_t edr_index_find(const edr_index* index, int32_t key) {
+    if (!index) return -1;
+    int position = index->engine->find(key);
+    index->queries.fetch_add(1, std::memory_order_relaxed);
+    if (position != -1) index->hits.fetch_add(1, std::memory_order_relaxed);
+    return position;
+}
+
+EDR_API edr_status edr_index_find_batch(const edr_index* index, const int32_t* keys, size_t count, int64_t* positions) {
+    if (!index || (count > 0 && (!keys || !positions))) return EDR_ERROR_INVALID_ARGUMENT;
+    uint64_t found = 0;
+    for (size_t i = 0; i < count; ++i) {
+        positions[i] = index->engine->find(keys[i]);
+        found += positions[i] != -1;
+    }
+    index->queries.fetch_add(count, std::memory_order_relaxed); // Once per batch, not per key.
+    index->hits.fetch_add(found, std::memory_order_relaxed);
+    return EDR_OK;
+}
+
+EDR_API edr_status edr_index_nearest(const edr_index* index, int32_t key, size_t k, int64_t* positions, size_t* written) {
+    if (!index || !written || (k > 0 && !positions)) return EDR_ERROR_INVALID_ARGUMENT;
+    const int* keys = index->dataset->keys;
+    long long n = static_cast<long long>(index->dataset->count);
+    // Walk outwards from the engine's lower bound, taking the closer neighbour each time (the left one on ties).
+    long long right = index->engine->lowerBound(KeyView{ keys, index->dataset->count }, key);
+    long long left = right - 1;
+    size_t count = 0;
+    while (count < k && (left >= 0 || right < n)) {
+        bool take_left = right >= n
+            || (left >= 0 && static_cast<long long>(key) - keys[left] <= static_cast<long long>(keys[right]) - key);
+        positions[count++] = take_left ? left-- : right++;
+    }
+    *written = count;
+    index->queries.fetch_add(1, std::memory_order_relaxed);
+    if (count > 0 && keys[positions[0]] == key) index->hits.fetch_add(1, std::memory_order_relaxed);
+    return EDR_OK;
+}
+
+EDR_API edr_status edr_index_get_stats(const edr_index* index, edr_index_stats* stats) {
+    if (!index || !stats || stats->struct_size < sizeof(uint32_t)) return EDR_ERROR_INVALID_ARGUMENT;
+    edr_index_stats full;
+    full.struct_size = stats->struct_size;
+    full.num_keys = index->dataset->count;
+    full.memory_bytes = index->engine->memoryBytes();
+    full.copied_bytes = index->engine->copiedBytes();
+    full.build_ns = index->build_ns;
+    full.queries = index->queries.load(std::memory_order_relaxed);
+    full.hits = index->hits.load(std::memory_order_relaxed);
+    // Fill only the fields the caller's (possibly older, smaller) struct has.
+    std::memcpy(reinterpret_cast<char*>(stats) + sizeof(uint32_t), reinterpret_cast<const char*>(&full) + sizeof(uint32_t),
+        std::min<size_t>(stats->struct_size, sizeof(full)) - sizeof(uint32_t));
+    return EDR_OK;
+}
+
+} // extern "C"
@@ -0,0 +1,122 @@
+#ifndef SEARCH_API_H
+#define SEARCH_API_H
+
+/*
+Stable C API of the search engines, built as the shared library libedrsearch.
+
+Usage:
+    edr_dataset* dataset;
+    edr_index* index;
+    edr_dataset_create(keys, count, &dataset);      // Wraps the caller's sorted buffer, no copy.
+    edr_index_create(dataset, "eytzinger", &index); // Or "auto" to keep the fastest engine.
+    int64_t position = edr_index_find(index, 42);  // -1 if absent.
+    edr_index_destroy(index);
+    edr_dataset_destroy(dataset);
+
+Rules:
+    - Functions never throw and never print. Those that can fail return an edr_status;
+      edr_status_string describes it.
+    - A dataset made with edr_dataset_create borrows the caller's buffer. The buffer must stay
+      alive and unchanged until the dataset is destroyed. Indexes must be destroyed before
+      their dataset.
+    - Positions are indexes into the dataset's keys (the caller's buffer for a borrowed
+      dataset), or -1 for "not found".
+    - Queries on one index may run concurrently from any number of threads. Create and destroy
+      calls must not race with queries on the same handle.
+    - ABI stability: handles are opaque. Enum values and struct fields are only ever appended.
+      edr_index_stats carries its own size. Compare edr_api_version() with EDR_API_VERSION
+      to detect a mismatched header.
+*/
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32)
+#  if defined(EDR_BUILDING_LIBRARY)
+#    define EDR_API __declspec(dllexport)
+#  else
+#    define EDR_API __declspec(dllimport)
+#  endif
+#elif defined(__GNUC__)
+#  define EDR_API __attribute__((visibility("default")))
+#else
+#  define EDR_API
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define EDR_API_VERSION 1
+
+typedef struct edr_dataset edr_dataset;
+typedef struct edr_index edr_index;
+
+typedef enum edr_status {
+    EDR_OK = 0,
+    EDR_ERROR_INVALID_ARGUMENT = 1, /* Null handle or pointer, or an empty dataset. */
+    EDR_ERROR_NOT_SORTED = 2,       /* A borrowed buffer is not strictly ascending. */
+    EDR_ERROR_UNKNOWN_INDEX = 3,    /* The index name is not one of edr_index_name(). */
+    EDR_ERROR_OUT_OF_MEMORY = 4,
+    EDR_ERROR_TOO_LARGE = 5,        /* More keys than an int can index. */
+    EDR_ERROR_INTERNAL = 6
+} edr_status;
+
+typedef struct edr_index_stats {
+    uint32_t struct_size;   /* Set to sizeof(edr_index_stats) before calling edr_index_get_stats. */
+    uint64_t num_keys;
+    uint64_t memory_bytes;  /* Held by the index on top of the dataset. */
+    uint64_t copied_bytes;  /* Dataset bytes the index had to copy; 0 for zero-copy engines. */
+    uint64_t build_ns;
+    uint64_t queries;       /* Keys looked up through find, find_batch and nearest. */
+    uint64_t hits;          /* Lookups that found their key. */
+} edr_index_stats;
+
+/* EDR_API_VERSION of the library actually loaded. */
+EDR_API int edr_api_version(void);
+
+EDR_API const char* edr_status_string(edr_status status);
+
+/* Names accepted by edr_index_create, besides "auto". */
+EDR_API size_t edr_index_name_count(void);
+EDR_API const char* edr_index_name(size_t i); /* NULL past the end. */
+
+/* Borrows 'keys' (strictly ascending) without copying; the check is one pass over the buffer. */
+EDR_API edr_status edr_dataset_create(const int32_t* keys, size_t count, edr_dataset** out);
+
+/* Copies, sorts and de-duplicates 'keys'; for input that is not sorted yet. */
+EDR_API edr_status edr_dataset_create_copy(const int32_t* keys, size_t count, edr_dataset** out);
+
+EDR_API void edr_dataset_destroy(edr_dataset* dataset);
+EDR_API size_t edr_dataset_size(const edr_dataset* dataset);
+
+/* The dataset's keys in ascending order (the caller's buffer for a borrowed dataset). */
+EDR_API const int32_t* edr_dataset_keys(const edr_dataset* dataset);
+
+/*
+Builds the index 'name' over 'dataset'. "auto" times every zero-copy engine on a sample of the
+dataset's keys and keeps the fastest; edr_index_kind reports which one won.
+*/
+EDR_API edr_status edr_index_create(const edr_dataset* dataset, const char* name, edr_index** out);
+EDR_API void edr_index_destroy(edr_index* index);
+EDR_API const char* edr_index_kind(const edr_index* index);
+
+/* Position of 'key', or -1 if it is absent or 'index' is NULL. */
+EDR_API int64_t edr_index_find(const edr_index* index, int32_t key);
+
+/* positions[i] = edr_index_find(index, keys[i]) for i < count. */
+EDR_API edr_status edr_index_find_batch(const edr_index* index, const int32_t* keys, size_t count, int64_t* positions);
+
+/*
+Positions of the (up to) k keys closest to 'key', nearest first; ties go to the smaller key.
+*written receives the number stored, min(k, dataset size).
+*/
+EDR_API edr_status edr_index_nearest(const edr_index* index, int32_t key, size_t k, int64_t* positions, size_t* written);
+
+EDR_API edr_status edr_index_get_stats(const edr_index* index, edr_index_stats* stats);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SEARCH_API_H */
@@ -0,0 +1,82 @@
+/*
+Minimal C client of libedrsearch (SearchApi.h), built by CMake as SearchApiExample.
+
+It borrows a small sorted buffer, builds an index (the name given as the first argument,
+"auto" by default), and runs a lookup, a batch lookup and a nearest-key query, then reads the
+stats back. Every answer is checked against the buffer, so the program exits with 0 only if
+the library is linked correctly and answers right.
+*/
+
+#include "SearchApi.h"
+#include <stdio.h>
+
+#define NUM_KEYS 1000
+
+static int fail(const char* what, edr_status status) {
+    fprintf(stderr, "Error: %s: %s\n", what, edr_status_string(status));
+    return 1;
+}
+
+int main(int argc, char** argv) {
+    const char* name = argc >= 2 ? argv[1] : "auto";
+    int32_t keys[NUM_KEYS];
+    int32_t queries[4] = { 0, 30, 31, 2997 };
+    int64_t positions[4];
+    int64_t nearest[3];
+    size_t written = 0;
+    edr_dataset* dataset = NULL;
+    edr_index* index = NULL;
+    edr_index_stats stats;
+    edr_status status;
+    int i;
+
+    if (edr_api_version() != EDR_API_VERSION) {
+        fprintf(stderr, "Error: Header version %d, library version %d.\n", EDR_API_VERSION, edr_api_version());
+        return 1;
+    }
+    for (i = 0; i < NUM_KEYS; ++i) keys[i] = 3 * i; /* 0, 3, 6, ..., 2997 */
+
+    status = edr_dataset_create(keys, NUM_KEYS, &dataset);
+    if (status != EDR_OK) return fail("edr_dataset_create", status);
+    status = edr_index_create(dataset, name, &index);
+    if (status != EDR_OK) {
+        edr_dataset_destroy(dataset);
+        return fail("edr_index_create", status);
+    }
+    printf("Index: %s over %zu keys\n", edr_index_kind(index), edr_dataset_size(dataset));
+
+    if (edr_index_find(index, 300) != 100 || edr_index_find(index, 301) != -1) {
+        fprintf(stderr, "Error: edr_index_find gave a wrong position.\n");
+        return 1;
+    }
+
+    status = edr_index_find_batch(index, queries, 4, positions);
+    if (status != EDR_OK) return fail("edr_index_find_batch", status);
+    if (positions[0] != 0 || positions[1] != 10 || positions[2] != -1 || positions[3] != NUM_KEYS - 1) {
+        fprintf(stderr, "Error: edr_index_find_batch gave a wrong position.\n");
+        return 1;
+    }
+
+    /* Keys at distance 1 (30), 2 (33) and 4 (27) from 31, nearest first. */
+    status = edr_index_nearest(index, 31, 3, nearest, &written);
+    if (status != EDR_OK) return fail("edr_index_nearest", status);
+    if (written != 3 || nearest[0] != 10 || nearest[1] != 11 || nearest[2] != 9) {
+        fprintf(stderr, "Error: edr_index_nearest gave wrong neighbours.\n");
+        return 1;
+    }
+    printf("Nearest to 31: %d %d %d\n", keys[nearest[0]], keys[nearest[1]], keys[nearest[2]]);
+
+    stats.struct_size = sizeof(stats);
+    status = edr_index_get_stats(index, &stats);
+    if (status != EDR_OK) return fail("edr_index_get_stats", status);
+    printf("Stats: %llu queries, %llu hits, %llu index bytes, built in %llu ns\n", (unsigned long long)stats.queries,
+        (unsigned long long)stats.hits, (unsigned long long)stats.memory_bytes, (unsigned long long)stats.build_ns);
+    if (stats.queries != 7 || stats.hits != 4) {
+        fprintf(stderr, "Error: The stats do not match the queries made.\n");
+        return 1;
+    }
+
+    edr_index_destroy(index);
+    edr_dataset_destroy(dataset);
+    return 0;
+}
@@ -0,0 +1,269 @@
+#ifndef SEARCH_INDEX_H
+#define SEARCH_INDEX_H
+
+#include "ProjectUtils.h"  // For jumpSearch and interpolationSearch.
+#include "SearchLayouts.h" // For LayoutIndex.
+#include "SimdSearch.h"    // For kAryInterpolationSearch.
+#include "SmallSearch.h"   // For the small-window kernels that finish each lookup.
+#include <memory>          // For std::unique_ptr returned by createSearchIndex.
+#include <string>
+#include <vector>
+#include <algorithm>
+
+/*
+A common interface over every way this project can answer "where is 'target' in the sorted
+dataset?". Each index is built from the sorted, de-duplicated dataset produced by
+`loadAndSortDatasetFromFile` / `generateAndSortDataset` and reports the bytes it holds on top
+of that dataset, so tools such as the memory budget manager can compare them directly.
+
+Indexes are created by name through `createSearchIndex`; `registeredSearchIndexNames` lists
+every name it accepts.
+*/
+
+namespace ProjectUtils {
+
+    /**
+     * @brief Interface implemented by every search algorithm and auxiliary index.
+     */
+    class SearchIndex {
+    public:
+        virtual ~SearchIndex() {}
+
+        // Name used by createSearchIndex and in reports.
+        virtual std::string name() const = 0;
+
+        // Builds the index over 'sorted'. The dataset must outlive the index.
+        virtual void build(const std::vector<int>& sorted) = 0;
+
+        // Returns the index of 'target' in the sorted dataset, or -1 if it is not present.
+        virtual int search(int target) const = 0;
+
+        // Bytes held by the index in addition to the dataset itself.
+        virtual size_t memoryBytes() const = 0;
+    };
+
+    /**
+     * @brief Binary search straight over the sorted dataset; the zero-byte baseline.
+     *
+     * The last SMALL_SEARCH_LAST_MILE keys (or a whole tiny dataset) are finished by the
+     * small-window kernel.
+     */
+    class SortedArrayIndex : public SearchIndex {
+    public:
+        SortedArrayIndex() : data(nullptr) {}
+        std::string name() const override { return "sorted"; }
+        void build(const std::vector<int>& sorted) override { data = &sorted; }
+        int search(int target) const override { return searchOver(data->data(), target); }
+
+        /**
+         * @brief search() over any key array with operator[] (the cache simulator passes a traced copy).
+         */
+        template<typename Keys>
+        int searchOver(const Keys& keys, int target) const {
+            int n = static_cast<int>(data->size());
+            int position = smallLowerBoundOver(keys, 0, n, target);
+            return (position < n && keys[position] == target) ? position : -1;
+        }
+
+        size_t memoryBytes() const override { return 0; }
+    private:
+        const std::vector<int>* data;
+    };
+
+    /**
+     * @brief Adapts a plain search function such as `jumpSearch` to the SearchIndex interface.
+     */
+    class FunctionSearchIndex : public SearchIndex {
+    public:
+        typedef int (*SearchFunction)(const std::vector<int>&, int);
+
+        FunctionSearchIndex(const std::string& index_name, SearchFunction function)
+            : index_name(index_name), function(function), data(nullptr) {}
+        std::string name() const override { return index_name; }
+        void build(const std::vector<int>& sorted) override { data = &sorted; }
+        int search(int target) const override { return function(*data, target); }
+        size_t memoryBytes() const override { return 0; }
+    private:
+        std::string index_name;
+        SearchFunction function;
+        const std::vector<int>* data;
+    };
+
+    /**
+     * @brief The Eytzinger or static B-tree copy of the dataset from SearchLayouts.h.
+     */
+    class LayoutSearchIndex : public SearchIndex {
+    public:
+        explicit LayoutSearchIndex(SearchLayout layout) : layout(layout) {}
+        std::string name() const override { return searchLayoutName(layout); }
+        void build(const std::vector<int>& sorted) override { index.build(sorted, layout); }
+        int search(int target) const override { return index.search(target); }
+        size_t memoryBytes() const override { return index.memoryBytes(); }
+    private:
+        SearchLayout layout;
+        LayoutIndex index;
+    };
+
+    /**
+     * @brief Radix table over the high bits of (key - min).
+     *
+     * Bucket 'b' stores the index of the first key whose offset from the minimum has
+     * 'b' as its high bits, so a lookup only binary searches inside one bucket.
+     * The table has roughly one entry per 'keys_per_bucket' keys.
+     */
+    class RadixTableIndex : public SearchIndex {
+    public:
+        explicit RadixTableIndex(int keys_per_bucket = 4) : keys_per_bucket(keys_per_bucket), data(nullptr), min_key(0), shift(0) {}
+        std::string name() const override { return "radix"; }
+
+        void build(const std::vector<int>& sorted) override {
+            data = &sorted;
+            table.clear();
+            if (sorted.empty()) return;
+            min_key = sorted.front();
+            unsigned long long range = static_cast<unsigned long long>(static_cast<long long>(sorted.back()) - min_key);
+            unsigned long long buckets_wanted = std::max<unsigned long long>(1, sorted.size() / keys_per_bucket);
+            shift = 0;
+            while ((range >> shift) + 1 > buckets_wanted) {
+                ++shift; // Widen the buckets until the table is about the requested size.
+            }
+            size_t num_buckets = static_cast<size_t>(range >> shift) + 1;
+            table.assign(num_buckets + 1, 0);
+            size_t i = 0;
+            for (size_t b = 0; b <= num_buckets; ++b) {
+                while (i < sorted.size() && bucketOf(sorted[i]) < b) ++i;
+                table[b] = static_cast<int>(i);
+            }
+        }
+
+        int search(int target) const override {
+            if (table.empty()) return -1;
+            return searchOver(data->data(), table.data(), target);
+        }
+
+        /**
+         * @brief search() over any key and bucket arrays with operator[] (the cache simulator passes traced copies).
+         */
+        template<typename Keys, typename Table>
+        int searchOver(const Keys& keys, const Table& buckets, int target) const {
+            if (table.empty() || target < min_key || target > keys[static_cast<int>(data->size()) - 1]) return -1;
+            size_t b = bucketOf(target);
+            int first = buckets[b];
+            int end = buckets[b + 1];
+            int position = smallLowerBoundOver(keys, first, end - first, target);
+            return (position < end && keys[position] == target) ? position : -1;
+        }
+
+        const std::vector<int>& bucketTable() const { return table; }
+
+        size_t memoryBytes() const override { return table.capacity() * sizeof(int); }
+
+    private:
+        size_t bucketOf(int key) const {
+            return static_cast<size_t>(static_cast<unsigned long long>(static_cast<long long>(key) - min_key) >> shift);
+        }
+
+        int keys_per_bucket;
+        const std::vector<int>* data;
+        int min_key;
+        int shift;
+        std::vector<int> table;
+    };
+
+    /**
+     * @brief Learned index: a least-squares line from key to position plus its maximum error.
+     *
+     * A lookup predicts the position and binary searches only the window
+     * [prediction - max_error, prediction + max_error], which is exact by construction.
+     */
+    class LinearModelIndex : public SearchIndex {
+    public:
+        LinearModelIndex() : data(nullptr), slope(0.0), intercept(0.0), max_error(0) {}
+        std::string name() const override { return "linear-model"; }
+
+        void build(const std::vector<int>& sorted) override {
+            data = &sorted;
+            slope = 0.0;
+            intercept = 0.0;
+            max_error = 0;
+            size_t n = sorted.size();
+            if (n < 2) return;
+            // Fit position = slope * key + intercept by least squares.
+            double mean_x = 0.0, mean_y = (n - 1) / 2.0;
+            for (int key : sorted) mean_x += key;
+            mean_x /= n;
+            double cov = 0.0, var = 0.0;
+            for (size_t i = 0; i < n; ++i) {
+                double dx = sorted[i] - mean_x;
+                cov += dx * (static_cast<double>(i) - mean_y);
+                var += dx * dx;
+            }
+            slope = var > 0.0 ? cov / var : 0.0;
+            intercept = mean_y - slope * mean_x;
+            for (size_t i = 0; i < n; ++i) {
+                long long error = std::llabs(predict(sorted[i]) - static_cast<long long>(i));
+                if (error > max_error) max_error = error;
+            }
+        }
+
+        int search(int target) const override { return searchOver(data->data(), target); }
+
+        /**
+         * @brief search() over any key array with operator[] (the cache simulator passes a traced copy).
+         */
+        template<typename Keys>
+        int searchOver(const Keys& keys, int target) const {
+            long long n = static_cast<long long>(data->size());
+            if (n == 0) return -1;
+            long long guess = predict(target);
+            long long lo = std::max(0LL, guess - max_error);
+            long long hi = std::min(n, guess + max_error + 1);
+            if (lo >= hi) return -1;
+            int position = smallLowerBoundOver(keys, static_cast<int>(lo), static_cast<int>(hi - lo), target);
+            return (position < hi && keys[position] == target) ? position : -1;
+        }
+
+        size_t memoryBytes() const override { return sizeof(slope) + sizeof(intercept) + sizeof(max_error); }
+
+    private:
+        long long predict(int key) const {
+            double position = slope * key + intercept;
+            double limit = static_cast<double>(data->size());
+            position = position < 0.0 ? 0.0 : (position > limit ? limit : position);
+            return static_cast<long long>(position);
+        }
+
+        const std::vector<int>* data;
+        double slope;
+        double intercept;
+        long long max_error;
+    };
+
+    /**
+     * @brief Returns the names accepted by createSearchIndex.
+     */
+    inline std::vector<std::string> registeredSearchIndexNames() {
+        return { "sorted", "jump", "interpolation", "kary-interpolation", "eytzinger", "btree", "radix", "linear-model" };
+    }
+
+    /**
+     * @brief Creates an (unbuilt) search index by name.
+     *
+     * @param name One of registeredSearchIndexNames().
+     * @return The new index, or nullptr if the name is unknown.
+     */
+    inline std::unique_ptr<SearchIndex> createSearchIndex(const std::string& name) {
+        if (name == "sorted") return std::unique_ptr<SearchIndex>(new SortedArrayIndex());
+        if (name == "jump") return std::unique_ptr<SearchIndex>(new FunctionSearchIndex(name, jumpSearch));
+        if (name == "interpolation") return std::unique_ptr<SearchIndex>(new FunctionSearchIndex(name, interpolationSearch));
+        if (name == "kary-interpolation") return std::unique_ptr<SearchIndex>(new FunctionSearchIndex(name, kAryInterpolationSearch));
+        if (name == "eytzinger") return std::unique_ptr<SearchIndex>(new LayoutSearchIndex(SearchLayout::Eytzinger));
+        if (name == "btree") return std::unique_ptr<SearchIndex>(new LayoutSearchIndex(SearchLayout::BTree));
+        if (name == "radix") return std::unique_ptr<SearchIndex>(new RadixTableIndex());
+        if (name == "linear-model") return std::unique_ptr<SearchIndex>(new LinearModelIndex());
+        return nullptr;
+    }
+
+} // namespace ProjectUtils
+
+#endif // SEARCH_INDEX_H
@@ -0,0 +1,260 @@
+#ifndef SEARCH_LAYOUTS_H
+#define SEARCH_LAYOUTS_H
+
+#include <vector>    // For std::vector to hold the laid-out keys.
+#include <climits>   // For INT_MAX used as B-tree padding.
+#include <string>    // For std::string layout names.
+
+/*
+This header contains the cache-friendly index layouts that can be built from a sorted,
+de-duplicated dataset. The same builders are used at runtime and by the
+GenerateEmbeddedTable build tool, so a table embedded at build time has exactly the
+same layout as one built after `loadAndSortDatasetFromFile`.
+
+    - Sorted:    the plain ascending array (what `jumpSearch` and `interpolationSearch` use).
+    - Eytzinger: the keys stored in BFS order of an implicit binary search tree (1-indexed).
+    - B-tree:    the keys stored as an implicit static B-tree with 16 keys per node.
+
+Each layout also produces a "rank" array that maps a layout slot back to the index of the
+key in the sorted dataset, so every search still reports the familiar sorted index.
+*/
+
+namespace ProjectUtils {
+
+    // The index layouts available for a sorted dataset.
+    enum class SearchLayout { Sorted, Eytzinger, BTree };
+
+    // Number of keys held in one B-tree node (16 ints = one 64-byte cache line).
+    const int BTREE_NODE_KEYS = 16;
+
+    /**
+     * @brief Returns the display name of a layout ("sorted", "eytzinger" or "btree").
+     */
+    inline std::string searchLayoutName(SearchLayout layout) {
+        switch (layout) {
+        case SearchLayout::Eytzinger: return "eytzinger";
+        case SearchLayout::BTree:     return "btree";
+        default:                      return "sorted";
+        }
+    }
+
+    /**
+     * @brief Parses a layout name as written by `searchLayoutName`.
+     *
+     * @param name The layout name to parse.
+     * @param layout Receives the parsed layout.
+     * @return True if the name was recognized, false otherwise.
+     */
+    inline bool parseSearchLayout(const std::string& name, SearchLayout& layout) {
+        if (name == "sorted") { layout = SearchLayout::Sorted; return true; }
+        if (name == "eytzinger") { layout = SearchLayout::Eytzinger; return true; }
+        if (name == "btree") { layout = SearchLayout::BTree; return true; }
+        return false;
+    }
+
+    namespace detail {
+        // Fills the Eytzinger array with an in-order walk of the implicit tree rooted at 'k'.
+        template<typename Keys>
+        void fillEytzinger(const Keys& sorted, std::vector<int>& layout,
+            std::vector<int>& ranks, int& next, int k) {
+            int n = static_cast<int>(sorted.size());
+            if (k > n) return;
+            fillEytzinger(sorted, layout, ranks, next, 2 * k);
+            layout[k] = sorted[next];
+            ranks[k] = next++;
+            fillEytzinger(sorted, layout, ranks, next, 2 * k + 1);
+        }
+
+        // Index of the i-th child of B-tree node 'k'.
+        inline int bTreeChild(int k, int i) {
+            return k * (BTREE_NODE_KEYS + 1) + i + 1;
+        }
+
+        // Fills the B-tree array with an in-order walk of the implicit tree rooted at node 'k'.
+        template<typename Keys>
+        void fillBTree(const Keys& sorted, std::vector<int>& layout,
+            std::vector<int>& ranks, int& next, int num_nodes, int k) {
+            if (k >= num_nodes) return;
+            int n = static_cast<int>(sorted.size());
+            for (int i = 0; i < BTREE_NODE_KEYS; ++i) {
+                fillBTree(sorted, layout, ranks, next, num_nodes, bTreeChild(k, i));
+                int slot = k * BTREE_NODE_KEYS + i;
+                if (next < n) {
+                    layout[slot] = sorted[next];
+                    ranks[slot] = next++;
+                }
+                else {
+                    layout[slot] = INT_MAX; // Padding keys sort after every real key.
+                    ranks[slot] = -1;
+                }
+            }
+            fillBTree(sorted, layout, ranks, next, num_nodes, bTreeChild(k, BTREE_NODE_KEYS));
+        }
+    }
+
+    /**
+     * @brief Builds the Eytzinger (BFS-order) layout of a sorted, unique dataset.
+     *
+     * The result is 1-indexed: slot 0 is unused and slots 1..n hold the keys.
+     *
+     * @tparam Keys std::vector<int>, or any view of the keys with size() and operator[].
+     * @param sorted The sorted dataset without duplicates.
+     * @param layout Receives the n + 1 laid-out keys.
+     * @param ranks Receives, for each slot, the index of that key in 'sorted'.
+     */
+    template<typename Keys>
+    void buildEytzingerLayout(const Keys& sorted, std::vector<int>& layout, std::vector<int>& ranks) {
+        layout.assign(sorted.size() + 1, 0);
+        ranks.assign(sorted.size() + 1, -1);
+        int next = 0;
+        detail::fillEytzinger(sorted, layout, ranks, next, 1);
+    }
+
+    /**
+     * @brief Builds the implicit static B-tree layout of a sorted, unique dataset.
+     *
+     * Node 'k' occupies slots [k * 16, k * 16 + 16) and its children are nodes
+     * k * 17 + 1 ... k * 17 + 17. Unused slots in the last nodes are padded with INT_MAX.
+     *
+     * @tparam Keys std::vector<int>, or any view of the keys with size() and operator[].
+     * @param sorted The sorted dataset without duplicates.
+     * @param layout Receives the laid-out keys (a multiple of 16 slots).
+     * @param ranks Receives, for each slot, the index of that key in 'sorted' (-1 for padding).
+     */
+    template<typename Keys>
+    void buildBTreeLayout(const Keys& sorted, std::vector<int>& layout, std::vector<int>& ranks) {
+        int num_nodes = (static_cast<int>(sorted.size()) + BTREE_NODE_KEYS - 1) / BTREE_NODE_KEYS;
+        layout.assign(static_cast<size_t>(num_nodes) * BTREE_NODE_KEYS, INT_MAX);
+        ranks.assign(layout.size(), -1);
+        int next = 0;
+        detail::fillBTree(sorted, layout, ranks, next, num_nodes, 0);
+    }
+
+    /**
+     * @brief Branch-free binary search over a plain sorted array.
+     *
+     * @tparam Keys A pointer to int, or any type indexable like one.
+     * @param keys The sorted keys.
+     * @param n The number of keys; must be at least 1.
+     * @param target The value to search for.
+     * @return The slot of the first key not less than 'target', or n - 1 if every key is smaller.
+     */
+    template<typename Keys>
+    int sortedLowerBoundSlot(const Keys& keys, int n, int target) {
+        int lo = 0, len = n;
+        while (len > 1) {
+            int half = len / 2;
+            lo += (keys[lo + half - 1] < target) ? half : 0;
+            len -= half;
+        }
+        return lo;
+    }
+
+    /**
+     * @brief Branch-free lower bound over an Eytzinger layout.
+     *
+     * @tparam Keys A pointer to int, or any type indexable like one (the cache simulator passes a traced array).
+     * @param layout The 1-indexed Eytzinger keys.
+     * @param n The number of keys (the layout holds n + 1 slots).
+     * @param target The value to search for.
+     * @return The slot of the first key not less than 'target', or 0 if there is none.
+     */
+    template<typename Keys>
+    int eytzingerLowerBoundSlot(const Keys& layout, int n, int target) {
+        unsigned k = 1;
+        while (k <= static_cast<unsigned>(n)) {
+            k = 2 * k + (layout[k] < target); // Go right when the key is too small.
+        }
+        // Undo the trailing right turns plus one left turn to reach the lower bound.
+        k >>= __builtin_ffs(~k);
+        return static_cast<int>(k);
+    }
+
+    /**
+     * @brief Lower bound over an implicit static B-tree layout.
+     *
+     * @tparam Keys A pointer to int, or any type indexable like one.
+     * @param layout The B-tree keys as produced by `buildBTreeLayout`.
+     * @param num_nodes The number of 16-key nodes in the layout.
+     * @param target The value to search for.
+     * @return The slot of the first key not less than 'target', or -1 if there is none.
+     */
+    template<typename Keys>
+    int bTreeLowerBoundSlot(const Keys& layout, int num_nodes, int target) {
+        int k = 0;
+        int result = -1;
+        while (k < num_nodes) {
+            size_t node = static_cast<size_t>(k) * BTREE_NODE_KEYS;
+            // Count the keys smaller than the target; this loop vectorizes into a few compares.
+            int i = 0;
+            for (int j = 0; j < BTREE_NODE_KEYS; ++j) {
+                i += (layout[node + j] < target);
+            }
+            if (i < BTREE_NODE_KEYS) {
+                result = k * BTREE_NODE_KEYS + i;
+            }
+            k = detail::bTreeChild(k, i);
+        }
+        return result;
+    }
+
+    /**
+     * @brief A sorted dataset re-laid out for faster lookups.
+     *
+     * `search` returns the same index `jumpSearch` would return on the sorted dataset,
+     * or -1 if the target is not present.
+     */
+    class LayoutIndex {
+    public:
+        LayoutIndex() : layout_kind(SearchLayout::Sorted), num_keys(0) {}
+
+        /**
+         * @brief Builds the chosen layout from a sorted, unique dataset.
+         */
+        void build(const std::vector<int>& sorted, SearchLayout layout) {
+            layout_kind = layout;
+            num_keys = static_cast<int>(sorted.size());
+            if (layout == SearchLayout::Eytzinger) {
+                buildEytzingerLayout(sorted, keys, ranks);
+            }
+            else if (layout == SearchLayout::BTree) {
+                buildBTreeLayout(sorted, keys, ranks);
+            }
+            else {
+                keys = sorted;
+                ranks.clear(); // The sorted layout is its own rank.
+            }
+        }
+
+        int search(int target) const {
+            if (num_keys == 0) return -1;
+            if (layout_kind == SearchLayout::Eytzinger) {
+                int slot = eytzingerLowerBoundSlot(keys.data(), num_keys, target);
+                return (slot != 0 && keys[slot] == target) ? ranks[slot] : -1;
+            }
+            if (layout_kind == SearchLayout::BTree) {
+                int slot = bTreeLowerBoundSlot(keys.data(), static_cast<int>(keys.size()) / BTREE_NODE_KEYS, target);
+                return (slot != -1 && keys[slot] == target) ? ranks[slot] : -1;
+            }
+            int lo = sortedLowerBoundSlot(keys.data(), num_keys, target);
+            return keys[lo] == target ? lo : -1;
+        }
+
+        SearchLayout layout() const { return layout_kind; }
+        int size() const { return num_keys; }
+
+        // Bytes held by the layout (keys plus rank map).
+        size_t memoryBytes() const {
+            return (keys.capacity() + ranks.capacity()) * sizeof(int);
+        }
+
+    private:
+        SearchLayout layout_kind;
+        int num_keys;
+        std::vector<int> keys;
+        std::vector<int> ranks;
+    };
+
+} // namespace ProjectUtils
+
+#endif // SEARCH_LAYOUTS_H
@@ -0,0 +1,285 @@
+#ifndef SET_OPERATIONS_H
+#define SET_OPERATIONS_H
+
+#include "SmallSearch.h" // For the lower bound that finishes each gallop.
+#include "CpuDispatch.h" // For the run-time check before the SSSE3 merge.
+#include <vector>
+#include <string>
+#include <thread>
+#include <algorithm>
+#include <cstddef>
+
+/*
+Set algebra between two sorted, de-duplicated datasets: intersection, union and difference.
+
+    - Sizes within SKEW_RATIO of each other are intersected with a merge. On a CPU with SSSE3
+      (checked at run time, see CpuDispatch.h) the merge compares 4 x 4 keys per step with
+      SIMD and compacts the matches with a byte shuffle.
+    - Skewed sizes gallop: each key of the small set is found in the large set with an
+      exponential search from the previous match, finished by smallLowerBound, so the cost
+      is O(small * log(large / small)) instead of O(small + large).
+    - Difference uses the same galloping search when the subtracted set is much larger.
+    - Every operation can run partitioned by key range on several threads.
+
+Results are either materialized into a vector or only counted (pass nullptr as the output).
+*/
+
+namespace ProjectUtils {
+
+    // The set operations supported between two datasets.
+    enum class SetOperation { Intersection, Union, Difference };
+
+    // Size ratio above which galloping replaces merging.
+    const size_t SKEW_RATIO = 32;
+
+    namespace detail {
+        // First position in [from, n) whose key is >= target, found by galloping from 'from'.
+        inline size_t gallopLowerBound(const int* keys, size_t from, size_t n, int target) {
+            size_t step = 1;
+            size_t hi = from;
+            while (hi < n && keys[hi] < target) {
+                from = hi + 1;
+                hi += step;
+                step *= 2;
+            }
+            size_t window = std::min(hi, n) - from;
+            return from + static_cast<size_t>(smallLowerBound(keys + from, static_cast<int>(window), target));
+        }
+
+        // Intersection of a small set with a much larger one by galloping. 'out' may be null.
+        inline size_t intersectGalloping(const int* small, size_t ns, const int* large, size_t nl, int* out) {
+            size_t count = 0;
+            size_t pos = 0;
+            for (size_t i = 0; i < ns && pos < nl; ++i) {
+                pos = gallopLowerBound(large, pos, nl, small[i]);
+                if (pos < nl && large[pos] == small[i]) {
+                    if (out) out[count] = small[i];
+                    ++count;
+                }
+            }
+            return count;
+        }
+
+        // Scalar merge intersection. 'out' may be null.
+        inline size_t intersectMergeScalar(const int* a, size_t na, const int* b, size_t nb, int* out) {
+            size_t i = 0, j = 0, count = 0;
+            while (i < na && j < nb) {
+                if (a[i] < b[j]) ++i;
+                else if (b[j] < a[i]) ++j;
+                else {
+                    if (out) out[count] = a[i];
+                    ++count;
+                    ++i;
+                    ++j;
+                }
+            }
+            return count;
+        }
+
+#if PROJECT_HAS_SSSE3_KERNELS
+        // Byte shuffles that move the lanes selected by a 4-bit mask to the front of a vector.
+        struct CompactShuffleTable {
+            __m128i shuffles[16];
+            PROJECT_TARGET("ssse3") CompactShuffleTable() {
+                for (int mask = 0; mask < 16; ++mask) {
+                    alignas(16) signed char bytes[16];
+                    int next = 0;
+                    for (int lane = 0; lane < 4; ++lane) {
+                        if (!(mask & (1 << lane))) continue;
+                        for (int b = 0; b < 4; ++b) bytes[next * 4 + b] = static_cast<signed char>(lane * 4 + b);
+                        ++next;
+                    }
+                    for (int b = next * 4; b < 16; ++b) bytes[b] = -1; // Zero the unused lanes.
+                    shuffles[mask] = _mm_load_si128(reinterpret_cast<const __m128i*>(bytes));
+                }
+            }
+        };
+
+        inline const __m128i* compactShuffleTable() {
+            static const CompactShuffleTable table; // Thread-safe one-time initialization.
+            return table.shuffles;
+        }
+
+        // SIMD merge intersection: compares each block of 4 keys of 'a' with all 4 rotations of
+        // a block of 'b'. 'out' may be null; otherwise it needs 3 slots of slack past the result.
+        inline PROJECT_TARGET("ssse3") size_t intersectMergeSimd(const int* a, size_t na, const int* b, size_t nb, int* out) {
+            const __m128i* shuffles = compactShuffleTable();
+            size_t i = 0, j = 0, count = 0;
+            size_t blocks_a = na & ~static_cast<size_t>(3);
+            size_t blocks_b = nb & ~static_cast<size_t>(3);
+            while (i < blocks_a && j < blocks_b) {
+                __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+                __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + j));
+                __m128i matches = _mm_or_si128(
+                    _mm_or_si128(_mm_cmpeq_epi32(va, vb), _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(0, 3, 2, 1)))),
+                    _mm_or_si128(_mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(1, 0, 3, 2))),
+                        _mm_cmpeq_epi32(va, _mm_shuffle_epi32(vb, _MM_SHUFFLE(2, 1, 0, 3)))));
+                int mask = _mm_movemask_ps(_mm_castsi128_ps(matches));
+                if (out) {
+                    _mm_storeu_si128(reinterpret_cast<__m128i*>(out + count), _mm_shuffle_epi8(va, shuffles[mask]));
+                }
+                count += static_cast<size_t>(__builtin_popcount(mask));
+                int max_a = a[i + 3];
+                int max_b = b[j + 3];
+                if (max_a <= max_b) i += 4;
+                if (max_b <= max_a) j += 4;
+            }
+            return count + intersectMergeScalar(a + i, na - i, b + j, nb - j, out ? out + count : nullptr);
+        }
+#endif
+
+        inline size_t intersectRange(const int* a, size_t na, const int* b, size_t nb, int* out) {
+            if (na > nb) return intersectRange(b, nb, a, na, out);
+            if (na == 0) return 0;
+            if (nb / na >= SKEW_RATIO) return intersectGalloping(a, na, b, nb, out);
+#if PROJECT_HAS_SSSE3_KERNELS
+            if (cpuHasSsse3()) return intersectMergeSimd(a, na, b, nb, out);
+#endif
+            return intersectMergeScalar(a, na, b, nb, out);
+        }
+
+        inline size_t unionRange(const int* a, size_t na, const int* b, size_t nb, int* out) {
+            size_t i = 0, j = 0, count = 0;
+            while (i < na && j < nb) {
+                int next;
+                if (a[i] < b[j]) next = a[i++];
+                else if (b[j] < a[i]) next = b[j++];
+                else { next = a[i++]; ++j; }
+                if (out) out[count] = next;
+                ++count;
+            }
+            for (; i < na; ++i, ++count) if (out) out[count] = a[i];
+            for (; j < nb; ++j, ++count) if (out) out[count] = b[j];
+            return count;
+        }
+
+        // Keys of 'a' that are not in 'b'.
+        inline size_t differenceRange(const int* a, size_t na, const int* b, size_t nb, int* out) {
+            size_t count = 0;
+            if (na > 0 && nb / na >= SKEW_RATIO) {
+                size_t pos = 0; // Gallop through the much larger 'b'.
+                for (size_t i = 0; i < na; ++i) {
+                    pos = gallopLowerBound(b, pos, nb, a[i]);
+                    if (pos >= nb || b[pos] != a[i]) {
+                        if (out) out[count] = a[i];
+                        ++count;
+                    }
+                }
+                return count;
+            }
+            size_t j = 0;
+            for (size_t i = 0; i < na; ++i) {
+                while (j < nb && b[j] < a[i]) ++j;
+                if (j < nb && b[j] == a[i]) continue;
+                if (out) out[count] = a[i];
+                ++count;
+            }
+            return count;
+        }
+
+        inline size_t setOperationRange(SetOperation op, const int* a, size_t na, const int* b, size_t nb, int* out) {
+            if (op == SetOperation::Intersection) return intersectRange(a, na, b, nb, out);
+            if (op == SetOperation::Union) return unionRange(a, na, b, nb, out);
+            return differenceRange(a, na, b, nb, out);
+        }
+
+        // Upper bound on the result size, used to size output buffers (+4 slack for SIMD stores).
+        inline size_t resultCapacity(SetOperation op, size_t na, size_t nb) {
+            if (op == SetOperation::Intersection) return std::min(na, nb) + 4;
+            if (op == SetOperation::Union) return na + nb;
+            return na;
+        }
+    }
+
+    /**
+     * @brief Returns the display name of a set operation.
+     */
+    inline std::string setOperationName(SetOperation op) {
+        switch (op) {
+        case SetOperation::Intersection: return "intersection";
+        case SetOperation::Union:        return "union";
+        default:                         return "difference";
+        }
+    }
+
+    /**
+     * @brief Describes which kernel `computeSetOperation` uses for two set sizes.
+     */
+    inline std::string setOperationMethod(SetOperation op, size_t na, size_t nb) {
+        size_t small = std::min(na, nb), large = std::max(na, nb);
+        bool skewed = small > 0 && large / small >= SKEW_RATIO;
+        if (op == SetOperation::Intersection) {
+            if (skewed) return "galloping";
+            return PROJECT_HAS_SSSE3_KERNELS && cpuHasSsse3() ? "SIMD merge" : "merge";
+        }
+        if (op == SetOperation::Difference && na > 0 && nb / na >= SKEW_RATIO) return "galloping";
+        return "merge";
+    }
+
+    /**
+     * @brief Computes a set operation between two sorted, de-duplicated datasets.
+     *
+     * With more than one thread both inputs are split at the same key boundaries (taken
+     * evenly from the larger input) and each thread works on one key range.
+     *
+     * @param op The operation; Difference computes a \ b.
+     * @param a The first sorted dataset.
+     * @param b The second sorted dataset.
+     * @param result Receives the sorted result, or nullptr to only count it.
+     * @param threads Number of worker threads (1 = run on the calling thread).
+     * @return The number of keys in the result.
+     */
+    inline size_t computeSetOperation(SetOperation op, const std::vector<int>& a, const std::vector<int>& b,
+        std::vector<int>* result, int threads = 1) {
+        const std::vector<int>& larger = a.size() >= b.size() ? a : b;
+        size_t parts = static_cast<size_t>(std::max(1, threads));
+        if (larger.size() < parts * 1024) parts = 1; // Not worth the threads.
+
+        // Part p covers keys in [splits[p], splits[p + 1]); the first and last parts are open-ended.
+        std::vector<size_t> a_bounds(parts + 1), b_bounds(parts + 1);
+        a_bounds[0] = b_bounds[0] = 0;
+        a_bounds[parts] = a.size();
+        b_bounds[parts] = b.size();
+        for (size_t p = 1; p < parts; ++p) {
+            int split = larger[larger.size() * p / parts];
+            a_bounds[p] = static_cast<size_t>(std::lower_bound(a.begin(), a.end(), split) - a.begin());
+            b_bounds[p] = static_cast<size_t>(std::lower_bound(b.begin(), b.end(), split) - b.begin());
+        }
+
+        std::vector<std::vector<int>> outputs(parts);
+        std::vector<size_t> counts(parts, 0);
+        auto run_part = [&](size_t p) {
+            size_t na = a_bounds[p + 1] - a_bounds[p];
+            size_t nb = b_bounds[p + 1] - b_bounds[p];
+            int* out = nullptr;
+            if (result) {
+                outputs[p].resize(detail::resultCapacity(op, na, nb));
+                out = outputs[p].data();
+            }
+            counts[p] = detail::setOperationRange(op, a.data() + a_bounds[p], na, b.data() + b_bounds[p], nb, out);
+        };
+
+        if (parts == 1) {
+            run_part(0);
+        }
+        else {
+            std::vector<std::thread> workers;
+            for (size_t p = 0; p < parts; ++p) workers.emplace_back(run_part, p);
+            for (std::thread& worker : workers) worker.join();
+        }
+
+        size_t total = 0;
+        for (size_t count : counts) total += count;
+        if (result) {
+            result->clear();
+            result->reserve(total);
+            for (size_t p = 0; p < parts; ++p) {
+                result->insert(result->end(), outputs[p].begin(), outputs[p].begin() + counts[p]);
+            }
+        }
+        return total;
+    }
+
+} // namespace ProjectUtils
+
+#endif // SET_OPERATIONS_H
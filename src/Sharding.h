@@ -0,0 +1,364 @@
+#ifndef SHARDING_H
+#define SHARDING_H
+
+#include "SearchIndex.h" // For createSearchIndex, used by each worker on its partition.
+#include <vector>
+#include <string>
+#include <memory>
+#include <chrono>
+#include <iostream>
+#include <algorithm>
+#include <cstdint>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <unistd.h>     // For fork, read and close.
+#include <sys/socket.h> // For socketpair and send.
+#include <sys/wait.h>   // For waitpid.
+#define PROJECT_HAS_SHARDING 1
+#else
+#define PROJECT_HAS_SHARDING 0
+#endif
+
+/*
+Range-partitioned sharding across local worker processes.
+
+`ShardRouter::start` splits the sorted dataset into N contiguous key ranges of (nearly) equal
+size and forks one worker process per range. Each worker copies only its own partition, builds
+a search index over it and serves requests over a Unix-domain socket pair, so the whole setup
+runs (and can be tested) on one machine.
+
+The router keeps the first key and the global offset of each partition:
+    - point queries go to the single partition whose range holds the target,
+    - batch queries are split per partition, sent to every worker before any reply is read
+      (so the workers search in parallel), and scattered back into request order,
+    - range queries go to every overlapping partition and the sorted pieces are concatenated.
+Indexes returned by the router are positions in the full sorted dataset, the same values
+`jumpSearch` would return.
+
+Wire format (native byte order, both directions are streams of 32-bit words):
+    request:  op, count, count payload words
+    POINT/BATCH reply: count result indexes (local to the partition, -1 if not found)
+    RANGE reply: number of keys, then the keys
+*/
+
+namespace ProjectUtils {
+
+#if PROJECT_HAS_SHARDING
+
+    namespace detail {
+        enum ShardOp : int32_t { SHARD_OP_BATCH = 1, SHARD_OP_RANGE = 2, SHARD_OP_SHUTDOWN = 3 };
+
+#ifdef MSG_NOSIGNAL
+        const int SHARD_SEND_FLAGS = MSG_NOSIGNAL;
+#else
+        const int SHARD_SEND_FLAGS = 0;
+#endif
+
+        // Writes exactly 'bytes' bytes to a socket, retrying on short writes and EINTR. A closed peer is a failed write, not SIGPIPE.
+        inline bool writeFully(int fd, const void* buffer, size_t bytes) {
+            const char* data = static_cast<const char*>(buffer);
+            while (bytes > 0) {
+                ssize_t written = ::send(fd, data, bytes, SHARD_SEND_FLAGS);
+                if (written < 0 && errno == EINTR) continue;
+                if (written <= 0) return false;
+                data += written;
+                bytes -= static_cast<size_t>(written);
+            }
+            return true;
+        }
+
+        // Reads exactly 'bytes' bytes, retrying on short reads and EINTR.
+        inline bool readFully(int fd, void* buffer, size_t bytes) {
+            char* data = static_cast<char*>(buffer);
+            while (bytes > 0) {
+                ssize_t received = ::read(fd, data, bytes);
+                if (received < 0 && errno == EINTR) continue;
+                if (received <= 0) return false;
+                data += received;
+                bytes -= static_cast<size_t>(received);
+            }
+            return true;
+        }
+
+        // Serves requests for one partition until the router shuts it down or disconnects.
+        inline void runShardWorker(int fd, std::vector<int> partition, const std::string& index_name) {
+            std::unique_ptr<SearchIndex> index = createSearchIndex(index_name);
+            index->build(partition);
+            std::vector<int32_t> payload;
+            std::vector<int32_t> reply;
+            while (true) {
+                int32_t header[2];
+                if (!readFully(fd, header, sizeof(header))) return;
+                payload.resize(static_cast<size_t>(header[1]));
+                if (header[1] > 0 && !readFully(fd, payload.data(), payload.size() * sizeof(int32_t))) return;
+
+                reply.clear();
+                if (header[0] == SHARD_OP_BATCH) {
+                    for (int32_t target : payload) reply.push_back(index->search(target));
+                }
+                else if (header[0] == SHARD_OP_RANGE && payload.size() == 2) {
+                    auto first = std::lower_bound(partition.begin(), partition.end(), payload[0]);
+                    auto last = std::upper_bound(first, partition.end(), payload[1]);
+                    reply.push_back(static_cast<int32_t>(last - first));
+                    reply.insert(reply.end(), first, last);
+                }
+                else {
+                    return; // SHARD_OP_SHUTDOWN or a malformed request.
+                }
+                if (!writeFully(fd, reply.data(), reply.size() * sizeof(int32_t))) return;
+            }
+        }
+    }
+
+    /**
+     * @brief Routes point, batch and range queries to per-partition worker processes.
+     */
+    class ShardRouter {
+    public:
+        ShardRouter() {}
+        ~ShardRouter() { stop(); }
+        ShardRouter(const ShardRouter&) = delete;
+        ShardRouter& operator=(const ShardRouter&) = delete;
+
+        /**
+         * @brief Partitions 'sorted' and starts one worker process per partition.
+         *
+         * @param sorted The sorted, de-duplicated dataset.
+         * @param num_shards Requested number of partitions (clamped to [1, dataset size]).
+         * @param index_name The SearchIndex each worker builds over its partition.
+         * @return True if every worker started, false otherwise.
+         */
+        bool start(const std::vector<int>& sorted, int num_shards, const std::string& index_name = "interpolation") {
+            stop();
+            if (sorted.empty()) {
+                std::cerr << "Error: Cannot shard an empty dataset.\n";
+                return false;
+            }
+            if (!createSearchIndex(index_name)) {
+                std::cerr << "Error: Unknown search index '" << index_name << "'.\n";
+                return false;
+            }
+            total_keys = static_cast<int>(sorted.size());
+            num_shards = std::max(1, std::min(num_shards, total_keys));
+            std::cout.flush(); // Do not let forked workers inherit (and re-print) buffered output.
+
+            for (int s = 0; s < num_shards; ++s) {
+                int begin = static_cast<int>(static_cast<long long>(total_keys) * s / num_shards);
+                int end = static_cast<int>(static_cast<long long>(total_keys) * (s + 1) / num_shards);
+                int fds[2];
+                if (::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) {
+                    std::cerr << "Error: Could not create a socket pair for shard " << s << ".\n";
+                    stop();
+                    return false;
+                }
+#if defined(SO_NOSIGPIPE)
+                int on = 1; // Where send has no MSG_NOSIGNAL, the socket itself must not raise SIGPIPE.
+                ::setsockopt(fds[0], SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+                ::setsockopt(fds[1], SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+#endif
+                pid_t pid = ::fork();
+                if (pid < 0) {
+                    std::cerr << "Error: Could not start the worker process for shard " << s << ".\n";
+                    ::close(fds[0]);
+                    ::close(fds[1]);
+                    stop();
+                    return false;
+                }
+                if (pid == 0) { // Worker: keep only its own socket and partition.
+                    ::close(fds[0]);
+                    for (const Shard& other : shards) ::close(other.fd);
+                    detail::runShardWorker(fds[1], std::vector<int>(sorted.begin() + begin, sorted.begin() + end), index_name);
+                    ::close(fds[1]);
+                    ::_exit(0); // Skip the parent's atexit handlers and stream destructors.
+                }
+                ::close(fds[1]);
+                Shard shard;
+                shard.pid = pid;
+                shard.fd = fds[0];
+                shard.first_key = sorted[begin];
+                shard.last_key = sorted[end - 1];
+                shard.offset = begin;
+                shards.push_back(shard);
+            }
+            return true;
+        }
+
+        /**
+         * @brief Shuts every worker down and waits for it to exit.
+         */
+        void stop() {
+            for (Shard& shard : shards) {
+                int32_t header[2] = { detail::SHARD_OP_SHUTDOWN, 0 };
+                detail::writeFully(shard.fd, header, sizeof(header));
+                ::close(shard.fd);
+                ::waitpid(shard.pid, nullptr, 0);
+            }
+            shards.clear();
+        }
+
+        int shardCount() const { return static_cast<int>(shards.size()); }
+
+        /**
+         * @brief Searches for one value.
+         *
+         * @return The index of 'target' in the full sorted dataset, or -1 if not found (or on I/O failure).
+         */
+        int search(int target) {
+            std::vector<int> results;
+            if (!searchBatch(std::vector<int>(1, target), results)) return -1;
+            return results[0];
+        }
+
+        /**
+         * @brief Searches for many values; each partition receives its share in one message.
+         *
+         * @param targets The values to search for.
+         * @param results Receives, in the order of 'targets', each index in the full dataset or -1.
+         * @return False if a worker could not be reached.
+         */
+        bool searchBatch(const std::vector<int>& targets, std::vector<int>& results) {
+            results.assign(targets.size(), -1);
+            if (shards.empty()) return false;
+            std::vector<std::vector<int32_t>> per_shard(shards.size());
+            std::vector<std::vector<size_t>> positions(shards.size());
+            for (size_t i = 0; i < targets.size(); ++i) {
+                int s = shardFor(targets[i]);
+                if (s < 0) continue; // Outside the dataset's key range.
+                per_shard[s].push_back(targets[i]);
+                positions[s].push_back(i);
+            }
+            // Send every request before reading any reply so the workers run concurrently.
+            for (size_t s = 0; s < shards.size(); ++s) {
+                if (per_shard[s].empty()) continue;
+                if (!sendRequest(shards[s], detail::SHARD_OP_BATCH, per_shard[s])) return false;
+            }
+            std::vector<int32_t> reply;
+            for (size_t s = 0; s < shards.size(); ++s) {
+                if (per_shard[s].empty()) continue;
+                reply.resize(per_shard[s].size());
+                if (!detail::readFully(shards[s].fd, reply.data(), reply.size() * sizeof(int32_t))) return false;
+                for (size_t k = 0; k < reply.size(); ++k) {
+                    results[positions[s][k]] = reply[k] < 0 ? -1 : shards[s].offset + reply[k];
+                }
+            }
+            return true;
+        }
+
+        /**
+         * @brief Collects every key in [lo, hi], merging the pieces of all overlapping partitions.
+         *
+         * @param keys Receives the keys in ascending order.
+         * @return False if a worker could not be reached.
+         */
+        bool rangeQuery(int lo, int hi, std::vector<int>& keys) {
+            keys.clear();
+            if (shards.empty() || lo > hi) return !shards.empty();
+            std::vector<size_t> asked;
+            std::vector<int32_t> bounds = { lo, hi };
+            for (size_t s = 0; s < shards.size(); ++s) {
+                if (shards[s].last_key < lo || shards[s].first_key > hi) continue;
+                if (!sendRequest(shards[s], detail::SHARD_OP_RANGE, bounds)) return false;
+                asked.push_back(s);
+            }
+            // Partitions are disjoint and in key order, so appending the pieces keeps 'keys' sorted.
+            for (size_t s : asked) {
+                int32_t count = 0;
+                if (!detail::readFully(shards[s].fd, &count, sizeof(count))) return false;
+                size_t old_size = keys.size();
+                keys.resize(old_size + static_cast<size_t>(count));
+                if (count > 0 && !detail::readFully(shards[s].fd, keys.data() + old_size, static_cast<size_t>(count) * sizeof(int32_t))) return false;
+            }
+            return true;
+        }
+
+        /**
+         * @brief Prints the key range and size of every partition.
+         */
+        void printPartitions(std::ostream& out) const {
+            for (size_t s = 0; s < shards.size(); ++s) {
+                int next_offset = s + 1 < shards.size() ? shards[s + 1].offset : total_keys;
+                out << "  Shard " << s << " (pid " << shards[s].pid << "): keys [" << shards[s].first_key << ", "
+                    << shards[s].last_key << "], " << next_offset - shards[s].offset << " keys\n";
+            }
+        }
+
+    private:
+        struct Shard {
+            pid_t pid;
+            int fd;
+            int first_key;
+            int last_key;
+            int offset; // Index of the partition's first key in the full dataset.
+        };
+
+        // The partition whose key range can hold 'target', or -1 if it is outside the dataset.
+        int shardFor(int target) const {
+            if (target < shards.front().first_key || target > shards.back().last_key) return -1;
+            int lo = 0, hi = static_cast<int>(shards.size()) - 1;
+            while (lo < hi) { // Last shard whose first key is <= target.
+                int mid = (lo + hi + 1) / 2;
+                if (shards[mid].first_key <= target) lo = mid;
+                else hi = mid - 1;
+            }
+            return lo;
+        }
+
+        static bool sendRequest(const Shard& shard, int32_t op, const std::vector<int32_t>& payload) {
+            int32_t header[2] = { op, static_cast<int32_t>(payload.size()) };
+            return detail::writeFully(shard.fd, header, sizeof(header))
+                && detail::writeFully(shard.fd, payload.data(), payload.size() * sizeof(int32_t));
+        }
+
+        std::vector<Shard> shards;
+        int total_keys = 0;
+    };
+
+    // Batch lookup throughput measured for one shard count.
+    struct ShardThroughput {
+        int shards = 0;
+        double queries_per_second = 0.0;
+        double ns_per_query = 0.0;
+    };
+
+    /**
+     * @brief Measures batch lookup throughput of the sharded mode for several shard counts.
+     *
+     * @param sorted The sorted dataset.
+     * @param shard_counts The shard counts to measure.
+     * @param num_queries Total lookups per shard count (half hits, half random values in range).
+     * @param batch_size Lookups per routed batch.
+     * @param index_name The SearchIndex used inside each worker.
+     * @return One entry per shard count that could be started.
+     */
+    inline std::vector<ShardThroughput> measureShardThroughput(const std::vector<int>& sorted, const std::vector<int>& shard_counts,
+        int num_queries = 200000, int batch_size = 4096, const std::string& index_name = "interpolation") {
+        std::vector<ShardThroughput> results;
+        if (sorted.empty()) return results;
+        std::vector<int> queries = makeBenchmarkQueries(sorted, static_cast<size_t>(std::max(0, num_queries)), 0.5, 7);
+
+        for (int count : shard_counts) {
+            ShardRouter router;
+            if (!router.start(sorted, count, index_name)) continue;
+            std::vector<int> batch, batch_results;
+            auto start = std::chrono::high_resolution_clock::now();
+            for (int i = 0; i < num_queries; i += batch_size) {
+                batch.assign(queries.begin() + i, queries.begin() + std::min(num_queries, i + batch_size));
+                router.searchBatch(batch, batch_results);
+            }
+            auto end = std::chrono::high_resolution_clock::now();
+            double seconds = std::chrono::duration<double>(end - start).count();
+            ShardThroughput entry;
+            entry.shards = router.shardCount();
+            entry.queries_per_second = seconds > 0.0 ? num_queries / seconds : 0.0;
+            entry.ns_per_query = seconds * 1e9 / num_queries;
+            results.push_back(entry);
+        }
+        return results;
+    }
+
+#endif // PROJECT_HAS_SHARDING
+
+} // namespace ProjectUtils
+
+#endif // SHARDING_H
@@ -0,0 +1,327 @@
+#ifndef SIMD_SEARCH_H
+#define SIMD_SEARCH_H
+
+#include "ProjectUtils.h" // For the scalar interpolationSearch fallback.
+#include "SmallSearch.h"  // For the last-mile kernel of kAryInterpolationSearch.
+#include "CpuDispatch.h"  // For the run-time choice of the AVX-512 and AVX2 kernels.
+#include <vector>
+#include <cstddef>
+
+/*
+Batch search engines that vectorize across queries instead of within one lookup.
+
+Each SIMD lane carries an independent query. Every step gathers one probe per lane, so a
+single gather instruction keeps 8 (AVX2) or 16 (AVX-512) cache misses in flight, and the
+comparisons update every lane's bounds without branches.
+
+    - `batchBinarySearch`: branchless lower-bound steps. All lanes take the same
+      log2(n) steps, so no lane ever finishes early.
+    - `batchInterpolationSearch`: interpolation steps with a per-lane "active" mask; lanes that
+      have found their key (or proven it absent) are masked out of later gathers and updates.
+      After a few interpolation steps the remaining lanes switch to bisection, which bounds
+      the worst case on skewed data.
+
+`kAryInterpolationSearch` vectorizes within a single lookup instead: every step places
+KARY_PROBES probe positions, loads them with one gather, compares them all with one SIMD
+compare and keeps only the sub-interval between the two probes that bracket the target.
+
+The AVX-512 and AVX2 kernels are compiled in every build and run when the CPU supports them
+(checked at run time, see CpuDispatch.h). Otherwise the same interfaces run scalar code:
+binary search interleaved over groups of queries, and `interpolationSearch` per query.
+Results match `jumpSearch`: the index of each target in 'arr', or -1.
+*/
+
+namespace ProjectUtils {
+
+    // Interpolation steps a lane may take before it falls back to bisection.
+    const int SIMD_INTERPOLATION_STEPS = 8;
+
+    // Probes per step of kAryInterpolationSearch (one AVX2 register of positions).
+    const int KARY_PROBES = 8;
+
+    // Ranges at most this long are finished with a linear scan in kAryInterpolationSearch.
+    const int KARY_SCAN_LENGTH = 16;
+
+    namespace detail {
+        // Branchless lower-bound search of several queries in lockstep (scalar fallback and tails).
+        inline void batchBinarySearchScalar(const int* arr, int n, const int* queries, int* results, size_t count) {
+            const size_t GROUP = 8;
+            for (size_t g = 0; g < count; g += GROUP) {
+                size_t group = std::min(GROUP, count - g);
+                int base[GROUP] = { 0 };
+                int len = n;
+                while (len > 1) {
+                    int half = len / 2;
+                    for (size_t k = 0; k < group; ++k) {
+                        base[k] += (arr[base[k] + half - 1] < queries[g + k]) ? half : 0;
+                    }
+                    len -= half;
+                }
+                for (size_t k = 0; k < group; ++k) {
+                    results[g + k] = arr[base[k]] == queries[g + k] ? base[k] : -1;
+                }
+            }
+        }
+
+#if PROJECT_HAS_AVX512_KERNELS
+        // Branchless lower-bound search of 16 queries per step; returns how many queries it answered (a multiple of 16).
+        inline PROJECT_TARGET("avx512f") size_t batchBinarySearchAvx512(const int* data, int n, const int* queries, int* results, size_t count) {
+            const __m512i not_found = _mm512_set1_epi32(-1);
+            size_t i = 0;
+            for (; i + 16 <= count; i += 16) {
+                __m512i q = _mm512_loadu_si512(queries + i);
+                __m512i base = _mm512_setzero_si512();
+                int len = n;
+                while (len > 1) {
+                    int half = len / 2;
+                    __m512i probe = _mm512_i32gather_epi32(_mm512_add_epi32(base, _mm512_set1_epi32(half - 1)), data, 4);
+                    __mmask16 less = _mm512_cmpgt_epi32_mask(q, probe); // probe < query
+                    base = _mm512_mask_add_epi32(base, less, base, _mm512_set1_epi32(half));
+                    len -= half;
+                }
+                __mmask16 hit = _mm512_cmpeq_epi32_mask(_mm512_i32gather_epi32(base, data, 4), q);
+                _mm512_storeu_si512(results + i, _mm512_mask_mov_epi32(not_found, hit, base));
+            }
+            return i;
+        }
+#endif
+
+#if PROJECT_HAS_AVX2_KERNELS
+        // The same with 8 queries per step.
+        inline PROJECT_TARGET("avx2") size_t batchBinarySearchAvx2(const int* data, int n, const int* queries, int* results, size_t count) {
+            size_t i = 0;
+            for (; i + 8 <= count; i += 8) {
+                __m256i q = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(queries + i));
+                __m256i base = _mm256_setzero_si256();
+                int len = n;
+                while (len > 1) {
+                    int half = len / 2;
+                    __m256i probe = _mm256_i32gather_epi32(data, _mm256_add_epi32(base, _mm256_set1_epi32(half - 1)), 4);
+                    __m256i less = _mm256_cmpgt_epi32(q, probe); // probe < query
+                    base = _mm256_add_epi32(base, _mm256_and_si256(less, _mm256_set1_epi32(half)));
+                    len -= half;
+                }
+                __m256i hit = _mm256_cmpeq_epi32(_mm256_i32gather_epi32(data, base, 4), q);
+                __m256i result = _mm256_blendv_epi8(_mm256_set1_epi32(-1), base, hit);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(results + i), result);
+            }
+            return i;
+        }
+
+        // Interpolation steps for 8 queries at a time, with finished lanes masked out; returns how many queries it answered.
+        inline PROJECT_TARGET("avx2") size_t batchInterpolationSearchAvx2(const int* data, int n, const int* queries, int* results, size_t count) {
+            const __m256i one = _mm256_set1_epi32(1);
+            const __m256i all = _mm256_set1_epi32(-1);
+            size_t i = 0;
+            for (; i + 8 <= count; i += 8) {
+                __m256i q = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(queries + i));
+                __m256i lo = _mm256_setzero_si256();
+                __m256i hi = _mm256_set1_epi32(n - 1);
+                __m256i result = all;
+                __m256i active = all;
+                for (int step = 0; ; ++step) {
+                    // Masked gathers: finished lanes load nothing (their lo/hi may be out of range).
+                    __m256i lo_val = _mm256_mask_i32gather_epi32(_mm256_setzero_si256(), data, lo, active, 4);
+                    __m256i hi_val = _mm256_mask_i32gather_epi32(_mm256_setzero_si256(), data, hi, active, 4);
+                    // A lane stays active while lo <= hi and arr[lo] <= q <= arr[hi].
+                    __m256i out_of_range = _mm256_or_si256(_mm256_cmpgt_epi32(lo, hi),
+                        _mm256_or_si256(_mm256_cmpgt_epi32(lo_val, q), _mm256_cmpgt_epi32(q, hi_val)));
+                    active = _mm256_andnot_si256(out_of_range, active);
+                    if (_mm256_testz_si256(active, active)) break;
+
+                    __m256i pos;
+                    if (step < SIMD_INTERPOLATION_STEPS) {
+                        // pos = lo + (q - arr[lo]) * (hi - lo) / (arr[hi] - arr[lo]), in float to avoid overflow.
+                        __m256 lo_f = _mm256_cvtepi32_ps(lo_val);
+                        __m256 fraction = _mm256_div_ps(_mm256_sub_ps(_mm256_cvtepi32_ps(q), lo_f),
+                            _mm256_sub_ps(_mm256_cvtepi32_ps(hi_val), lo_f));
+                        __m256 offset = _mm256_mul_ps(fraction, _mm256_cvtepi32_ps(_mm256_sub_epi32(hi, lo)));
+                        pos = _mm256_add_epi32(lo, _mm256_cvttps_epi32(offset)); // NaN/inf become INT_MIN, clamped below.
+                    }
+                    else {
+                        pos = _mm256_add_epi32(lo, _mm256_srli_epi32(_mm256_sub_epi32(hi, lo), 1));
+                    }
+                    pos = _mm256_max_epi32(lo, _mm256_min_epi32(hi, pos));
+
+                    __m256i probe = _mm256_mask_i32gather_epi32(_mm256_setzero_si256(), data, pos, active, 4);
+                    __m256i found = _mm256_and_si256(active, _mm256_cmpeq_epi32(probe, q));
+                    result = _mm256_blendv_epi8(result, pos, found);
+                    active = _mm256_andnot_si256(found, active);
+                    __m256i go_right = _mm256_and_si256(active, _mm256_cmpgt_epi32(q, probe));
+                    __m256i go_left = _mm256_and_si256(active, _mm256_cmpgt_epi32(probe, q));
+                    lo = _mm256_blendv_epi8(lo, _mm256_add_epi32(pos, one), go_right);
+                    hi = _mm256_blendv_epi8(hi, _mm256_sub_epi32(pos, one), go_left);
+                }
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(results + i), result);
+            }
+            return i;
+        }
+#endif
+
+#if PROJECT_HAS_AVX2_KERNELS
+        // Loads all KARY_PROBES probes with one gather and compares them with one SIMD compare.
+        inline PROJECT_TARGET("avx2") int compareKaryProbesAvx2(const int* arr, const int* positions, int target, int& found_position) {
+            __m256i pos = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(positions));
+            __m256i keys = _mm256_i32gather_epi32(arr, pos, 4);
+            __m256i t = _mm256_set1_epi32(target);
+            int less = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(t, keys)));
+            int equal = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(t, keys)));
+            found_position = equal ? positions[__builtin_ctz(equal)] : -1;
+            return __builtin_popcount(less);
+        }
+#endif
+
+        // Counts the probes whose key is below 'target' and reports a probe holding it (-1 if none).
+        inline int compareKaryProbes(const int* arr, const int* positions, int target, int& found_position) {
+#if PROJECT_HAS_AVX2_KERNELS
+            if (cpuHasAvx2()) return compareKaryProbesAvx2(arr, positions, target, found_position);
+#endif
+            int less = 0;
+            found_position = -1;
+            for (int j = 0; j < KARY_PROBES; ++j) {
+                less += arr[positions[j]] < target;
+                if (arr[positions[j]] == target) found_position = positions[j];
+            }
+            return less;
+        }
+
+        // The same count for any other array type (such as the cache simulator's traced arrays): one read per probe.
+        template<typename Keys>
+        int compareKaryProbes(const Keys& arr, const int* positions, int target, int& found_position) {
+            int less = 0;
+            found_position = -1;
+            for (int j = 0; j < KARY_PROBES; ++j) {
+                int key = arr[positions[j]];
+                less += key < target;
+                if (key == target) found_position = positions[j];
+            }
+            return less;
+        }
+
+        // Position of 'target' in keys[first, first + n), or -1, with one small-window count.
+        inline int karyFinish(const int* keys, int first, int n, int target) {
+            int found = smallSearch(keys + first, n, target);
+            return found == -1 ? -1 : first + found;
+        }
+
+        template<typename Keys>
+        int karyFinish(const Keys& keys, int first, int n, int target) {
+            int position = first + smallCountBelowOver(keys, first, n, target);
+            return (position < first + n && keys[position] == target) ? position : -1;
+        }
+    }
+
+    /**
+     * @brief k-ary interpolation search: KARY_PROBES probes per step, compared with one SIMD compare.
+     *
+     * Probes are normally clustered around the interpolated position, spaced 1/512 of the range
+     * apart, so on uniform data (e.g. data_100k_random.txt) the target lands between two
+     * neighbouring probes and the range shrinks 512-fold per step; on perfectly linear data
+     * the middle probe is the target itself. When the
+     * target falls outside the cluster, the next step spaces the probes evenly instead, which
+     * still shrinks the range (KARY_PROBES + 1)-fold. That bounds the work on skewed data.
+     *
+     * @tparam Keys const int* (the SIMD path on CPUs with AVX2), or any array with operator[] such as a traced array.
+     * @param data The sorted keys to search within.
+     * @param n The number of keys.
+     * @param target The integer value to search for.
+     * @return The index of the target if found, otherwise -1.
+     */
+    template<typename Keys>
+    int kAryInterpolationSearchOver(const Keys& data, int n, int target) {
+        if (n <= 0) return -1;
+        if (n <= SMALL_SEARCH_MAX) return detail::karyFinish(data, 0, n, target); // Tiny dataset: a single count.
+        int lo = 0;
+        int hi = n - 1;
+        bool interpolate = true;
+        alignas(32) int positions[KARY_PROBES];
+
+        while (hi - lo + 1 > KARY_SCAN_LENGTH) {
+            if (target < data[lo] || target > data[hi]) return -1;
+            long long len = static_cast<long long>(hi) - lo + 1;
+            if (interpolate) {
+                double fraction = (static_cast<double>(target) - data[lo]) / (static_cast<double>(data[hi]) - data[lo]);
+                long long guess = lo + static_cast<long long>(fraction * (hi - lo));
+                long long spacing = std::max(1LL, len / (KARY_PROBES * 64));
+                for (int j = 0; j < KARY_PROBES; ++j) {
+                    long long p = guess + (j - KARY_PROBES / 2) * spacing; // Probe KARY_PROBES / 2 is the guess itself.
+                    positions[j] = static_cast<int>(std::max<long long>(lo, std::min<long long>(hi, p)));
+                }
+            }
+            else {
+                for (int j = 0; j < KARY_PROBES; ++j) {
+                    positions[j] = static_cast<int>(lo + (j + 1) * len / (KARY_PROBES + 1));
+                }
+            }
+
+            int found_position;
+            int below = detail::compareKaryProbes(data, positions, target, found_position);
+            if (found_position != -1) return found_position;
+
+            // Keep the sub-interval between the last probe below the target and the first above it.
+            int new_lo = below == 0 ? lo : positions[below - 1] + 1;
+            int new_hi = below == KARY_PROBES ? hi : positions[below] - 1;
+            // A target outside the probe cluster means the interpolation was off; spread out next time.
+            interpolate = (below != 0 && below != KARY_PROBES) || !interpolate;
+            lo = new_lo;
+            hi = new_hi;
+        }
+        if (hi < lo) return -1;
+        return detail::karyFinish(data, lo, hi - lo + 1, target); // Short remaining range: one small-window count.
+    }
+
+    /**
+     * @brief kAryInterpolationSearchOver on a vector.
+     */
+    inline int kAryInterpolationSearch(const std::vector<int>& arr, int target) {
+        return kAryInterpolationSearchOver(arr.data(), static_cast<int>(arr.size()), target);
+    }
+
+    /**
+     * @brief Searches many values at once with branchless binary search, one query per SIMD lane.
+     *
+     * @param arr The sorted vector of integers to search within.
+     * @param queries The values to search for.
+     * @param results Receives, for each query, its index in 'arr' or -1 (resized to match 'queries').
+     */
+    inline void batchBinarySearch(const std::vector<int>& arr, const std::vector<int>& queries, std::vector<int>& results) {
+        results.resize(queries.size());
+        if (arr.empty()) {
+            std::fill(results.begin(), results.end(), -1);
+            return;
+        }
+        const int* data = arr.data();
+        const int n = static_cast<int>(arr.size());
+        size_t i = 0;
+#if PROJECT_HAS_AVX512_KERNELS
+        if (cpuHasAvx512()) i = detail::batchBinarySearchAvx512(data, n, queries.data(), results.data(), queries.size());
+#endif
+#if PROJECT_HAS_AVX2_KERNELS
+        if (cpuHasAvx2()) i += detail::batchBinarySearchAvx2(data, n, queries.data() + i, results.data() + i, queries.size() - i);
+#endif
+        detail::batchBinarySearchScalar(data, n, queries.data() + i, results.data() + i, queries.size() - i);
+    }
+
+    /**
+     * @brief Searches many values at once with interpolation steps, one query per SIMD lane.
+     *
+     * @param arr The sorted vector of integers to search within.
+     * @param queries The values to search for.
+     * @param results Receives, for each query, its index in 'arr' or -1 (resized to match 'queries').
+     */
+    inline void batchInterpolationSearch(const std::vector<int>& arr, const std::vector<int>& queries, std::vector<int>& results) {
+        results.resize(queries.size());
+        size_t i = 0;
+#if PROJECT_HAS_AVX2_KERNELS
+        if (!arr.empty() && cpuHasAvx2()) {
+            i = detail::batchInterpolationSearchAvx2(arr.data(), static_cast<int>(arr.size()), queries.data(), results.data(), queries.size());
+        }
+#endif
+        for (; i < queries.size(); ++i) {
+            results[i] = interpolationSearch(arr, queries[i]);
+        }
+    }
+
+} // namespace ProjectUtils
+
+#endif // SIMD_SEARCH_H
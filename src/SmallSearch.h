@@ -0,0 +1,224 @@
+#ifndef SMALL_SEARCH_H
+#define SMALL_SEARCH_H
+
+#include "CpuDispatch.h" // For the run-time choice between the AVX-512, AVX2 and scalar kernels.
+#include <vector>
+#include <climits>
+#include <algorithm>
+
+/*
+Size-class kernels for tiny datasets and for the last few hundred keys of a larger search.
+
+For a handful of keys, the setup of the general algorithms costs more than the search: the
+square root and block loop in jump search, the division in every interpolation probe, the
+unpredictable branches of binary search. These kernels instead compare the target with every
+key in the window and count the keys below it. That count is the lower-bound position, and the
+target is present iff the key at that position equals it. There is no data-dependent branch,
+and with SIMD one instruction compares 8 (AVX2) or 16 (AVX-512) keys:
+
+    - AVX-512: a masked load and compare per 16 keys, popcount of the compare mask.
+    - AVX2: a masked load and compare per 8 keys, accumulated in a vector and summed once.
+    - Otherwise: the window is copied into a buffer of the size class, padded with INT_MAX,
+      and counted with a branchless loop that the compiler vectorizes with the baseline SSE2.
+
+Each size class (16, 64, 256 keys) is a separate instantiation. The scalar loop always runs
+the full class, so its trip count is a compile-time constant and it is fully unrolled. The
+SIMD loops stop after the last block that holds a key of the window. Their masked loads never
+touch memory past the window, so a window can end at the end of the dataset.
+
+The kernel is chosen at run time (see CpuDispatch.h): the AVX-512 and AVX2 kernels are
+compiled for their instruction sets even in default builds, and the best one this CPU runs is
+picked on the first call. With -march=native the choice is made at compile time instead.
+
+`smallCountBelow` dispatches on the window size. `smallCountBelowOver` is the entry point the
+larger algorithms use for their last mile. It runs the kernels on any array with contiguous
+data(). Other array types, such as the cache simulator's traced arrays, get the same
+full-window count, so they record the same reads.
+*/
+
+namespace ProjectUtils {
+
+    // Largest window the kernels handle; the size classes are 16, 64 and 256 keys.
+    const int SMALL_SEARCH_MAX = 256;
+
+    // Window size at which probing algorithms on large datasets hand over to a kernel. Smaller
+    // than SMALL_SEARCH_MAX because on a large dataset every extra cache line in the window
+    // is likely a miss.
+    const int SMALL_SEARCH_LAST_MILE = 64;
+
+    // Handover window for interpolation-style searches. Their probes usually land within a few
+    // keys of the target, so counting a wide window costs more than it saves.
+    const int SMALL_SEARCH_PROBE_LAST_MILE = 16;
+
+    namespace detail {
+        // The kernels count the keys in keys[0, n) that are less than 'target'; n must be at most Capacity.
+
+        template<int Capacity>
+        int smallCountBelowScalar(const int* keys, int n, int target) {
+            int window[Capacity];
+            std::copy(keys, keys + n, window);
+            std::fill(window + n, window + Capacity, INT_MAX); // Padding is never below the target.
+            int count = 0;
+#pragma GCC unroll 256
+            for (int i = 0; i < Capacity; ++i) count += window[i] < target;
+            return count;
+        }
+
+#if PROJECT_HAS_AVX2_KERNELS
+        template<int Capacity>
+        PROJECT_TARGET("avx2") int smallCountBelowAvx2(const int* keys, int n, int target) {
+            const __m256i t = _mm256_set1_epi32(target);
+            const __m256i lane = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+            __m256i below = _mm256_setzero_si256();
+#pragma GCC unroll 32
+            for (int base = 0; base < Capacity; base += 8) {
+                if (base >= n) break;
+                __m256i valid = _mm256_cmpgt_epi32(_mm256_set1_epi32(n - base), lane);
+                __m256i block = _mm256_maskload_epi32(keys + base, valid);
+                // Each lane below the target adds -1; lanes past the window are masked off.
+                below = _mm256_sub_epi32(below, _mm256_and_si256(_mm256_cmpgt_epi32(t, block), valid));
+            }
+            __m128i sum = _mm_add_epi32(_mm256_castsi256_si128(below), _mm256_extracti128_si256(below, 1));
+            sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0x4E));
+            sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0xB1));
+            return _mm_cvtsi128_si32(sum);
+        }
+#endif
+
+#if PROJECT_HAS_AVX512_KERNELS
+        template<int Capacity>
+        PROJECT_TARGET("avx512f") int smallCountBelowAvx512(const int* keys, int n, int target) {
+            const __m512i t = _mm512_set1_epi32(target);
+            int count = 0;
+#pragma GCC unroll 16
+            for (int base = 0; base < Capacity; base += 16) {
+                if (base >= n) break;
+                __mmask16 valid = n - base >= 16 ? __mmask16(0xFFFF) : __mmask16((1u << (n - base)) - 1);
+                __m512i block = _mm512_maskz_loadu_epi32(valid, keys + base);
+                count += __builtin_popcount(_mm512_mask_cmpgt_epi32_mask(valid, t, block));
+            }
+            return count;
+        }
+#endif
+
+        typedef int (*SmallCountKernel)(const int* keys, int n, int target);
+
+        // One kernel per size class, for the best instruction set this CPU runs.
+        struct SmallCountKernels {
+            SmallCountKernel up_to_16;
+            SmallCountKernel up_to_64;
+            SmallCountKernel up_to_max;
+        };
+
+        inline const SmallCountKernels& smallCountKernels() {
+            static const SmallCountKernels kernels = []() {
+#if PROJECT_HAS_AVX512_KERNELS
+                if (cpuHasAvx512()) return SmallCountKernels{ smallCountBelowAvx512<16>, smallCountBelowAvx512<64>, smallCountBelowAvx512<256> };
+#endif
+#if PROJECT_HAS_AVX2_KERNELS
+                if (cpuHasAvx2()) return SmallCountKernels{ smallCountBelowAvx2<16>, smallCountBelowAvx2<64>, smallCountBelowAvx2<256> };
+#endif
+                return SmallCountKernels{ smallCountBelowScalar<16>, smallCountBelowScalar<64>, smallCountBelowScalar<256> };
+            }();
+            return kernels;
+        }
+
+        template<int Capacity>
+        int smallCountBelow(const int* keys, int n, int target) {
+#if defined(__AVX512F__)
+            return smallCountBelowAvx512<Capacity>(keys, n, target);
+#elif defined(__AVX2__)
+            return smallCountBelowAvx2<Capacity>(keys, n, target);
+#elif PROJECT_HAS_CPU_DISPATCH
+            const SmallCountKernels& kernels = smallCountKernels();
+            return (Capacity <= 16 ? kernels.up_to_16 : Capacity <= 64 ? kernels.up_to_64 : kernels.up_to_max)(keys, n, target);
+#else
+            return smallCountBelowScalar<Capacity>(keys, n, target);
+#endif
+        }
+    }
+
+    /**
+     * @brief Lower-bound position of 'target' in a sorted window of at most SMALL_SEARCH_MAX keys.
+     *
+     * @return The number of keys in keys[0, n) that are less than 'target'.
+     */
+    inline int smallCountBelow(const int* keys, int n, int target) {
+        if (n <= 16) return detail::smallCountBelow<16>(keys, n, target);
+        if (n <= 64) return detail::smallCountBelow<64>(keys, n, target);
+        return detail::smallCountBelow<SMALL_SEARCH_MAX>(keys, n, target);
+    }
+
+    /**
+     * @brief Index of 'target' in a sorted window of at most SMALL_SEARCH_MAX keys, or -1.
+     */
+    inline int smallSearch(const int* keys, int n, int target) {
+        int position = smallCountBelow(keys, n, target);
+        return (position < n && keys[position] == target) ? position : -1;
+    }
+
+    /**
+     * @brief Lower-bound position of 'target' in keys[0, n) for any n.
+     *
+     * Halves the window branch-free until it is at most SMALL_SEARCH_LAST_MILE keys, then counts.
+     */
+    inline int smallLowerBound(const int* keys, int n, int target) {
+        int lo = 0, len = n;
+        while (len > SMALL_SEARCH_LAST_MILE) {
+            int half = len / 2;
+            lo += (keys[lo + half - 1] < target) ? half : 0;
+            len -= half;
+        }
+        return lo + smallCountBelow(keys + lo, len, target);
+    }
+
+    namespace detail {
+        // Arrays with contiguous storage (data()) run the kernels.
+        template<typename Array>
+        auto countBelowOver(const Array& arr, int first, int n, int target, int) -> decltype(static_cast<const int*>(arr.data()), int()) {
+            return ProjectUtils::smallCountBelow(arr.data() + first, n, target);
+        }
+
+        // Anything else is read element by element, every key of the window once.
+        template<typename Array>
+        int countBelowOver(const Array& arr, int first, int n, int target, long) {
+            int count = 0;
+            for (int i = 0; i < n; ++i) count += arr[first + i] < target;
+            return count;
+        }
+    }
+
+    /**
+     * @brief smallCountBelow over arr[first, first + n) for any array with operator[].
+     *
+     * @return The number of keys in the window that are less than 'target'.
+     */
+    template<typename Array>
+    int smallCountBelowOver(const Array& arr, int first, int n, int target) {
+        return detail::countBelowOver(arr, first, n, target, 0);
+    }
+
+    /**
+     * @brief smallLowerBound over arr[first, first + n), returned as a position in 'arr'.
+     */
+    inline int smallLowerBoundOver(const int* arr, int first, int n, int target) {
+        return first + smallLowerBound(arr + first, n, target);
+    }
+
+    /**
+     * @brief The same lower bound for any array with operator[] (same halving, same last-mile count).
+     */
+    template<typename Array>
+    int smallLowerBoundOver(const Array& arr, int first, int n, int target) {
+        int lo = first, len = n;
+        while (len > SMALL_SEARCH_LAST_MILE) {
+            int half = len / 2;
+            lo += (arr[lo + half - 1] < target) ? half : 0;
+            len -= half;
+        }
+        return lo + smallCountBelowOver(arr, lo, len, target);
+    }
+
+} // namespace ProjectUtils
+
+#endif // SMALL_SEARCH_H
@@ -0,0 +1,468 @@
+#ifndef SPATIAL_SEARCH_H
+#define SPATIAL_SEARCH_H
+
+#include "ProjectUtils.h" // For sortAndDeduplicateDataset, the pipeline the Morton keys go through.
+#include "SmallSearch.h"  // For smallLowerBound, which resolves every Morton interval.
+#include "CpuDispatch.h"  // For the run-time check before the BMI2 encode and decode.
+#include <vector>
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <random>
+#include <chrono>
+#include <cstdint>
+
+/*
+Two-dimensional point datasets stored as Morton (Z-order) codes.
+
+A point (x, y) with 16-bit coordinates becomes one 32-bit key by interleaving the bits of the
+two coordinates: x in the even bits, y in the odd bits. Points that are close in the plane
+mostly get close keys, so the keys go through the same sort/de-duplicate pipeline and the same
+lower-bound search as any integer dataset. On a CPU with BMI2 (checked at run time, see
+CpuDispatch.h) the interleave is one PDEP per coordinate; otherwise, the usual shift-and-mask
+sequence. The 16-bit limit comes from the
+32-bit int keys: x and y must be in 0..65535.
+
+The keys are stored as code ^ 0x80000000 so that signed int order matches Morton order.
+
+A bounding-box query covers the codes from zmin = code(xmin, ymin) to zmax = code(xmax, ymax),
+but that range also holds many points outside the box. The box is therefore split at the
+highest bit where zmin and zmax differ. Every code in the lower half is then smaller than
+every code in the upper half. LITMAX is the largest code of the lower half and BIGMIN the
+smallest code of the upper half. The halves are split again until each one's code range holds
+only points in the box (zmax - zmin + 1 equals its area), or until the interval budget is
+spent. Each interval is resolved with one lower bound over the keys. An interval that is not
+exact is scanned, and whenever the scan leaves the box, the classic BIGMIN computation gives
+the next code inside the box to jump to.
+*/
+
+namespace ProjectUtils {
+
+    // Largest coordinate a Morton-coded point can have on either axis.
+    const int MORTON_COORD_MAX = 65535;
+
+    // Default number of Morton intervals a box query is split into. Each split costs a few
+    // encodes and possibly a lower bound, so beyond about 8 intervals the splitting costs more
+    // than the BIGMIN jumps it saves.
+    const int MORTON_MAX_INTERVALS = 8;
+
+    /**
+     * @brief A point with coordinates in 0..MORTON_COORD_MAX.
+     */
+    struct Point2D {
+        int x = 0;
+        int y = 0;
+    };
+
+    /**
+     * @brief An axis-aligned box, inclusive on every side.
+     */
+    struct MortonBox {
+        int xmin = 0, ymin = 0, xmax = 0, ymax = 0;
+
+        bool contains(int x, int y) const { return x >= xmin && x <= xmax && y >= ymin && y <= ymax; }
+    };
+
+    /**
+     * @brief A range of Morton codes; 'exact' if every code in it lies in the queried box.
+     */
+    struct MortonInterval {
+        uint32_t zlo = 0;
+        uint32_t zhi = 0;
+        bool exact = false;
+    };
+
+    namespace detail {
+        // Spreads the 16 low bits of v to the even bit positions.
+        inline uint32_t spreadBits(uint32_t v) {
+            v &= 0xFFFF;
+            v = (v | (v << 8)) & 0x00FF00FF;
+            v = (v | (v << 4)) & 0x0F0F0F0F;
+            v = (v | (v << 2)) & 0x33333333;
+            v = (v | (v << 1)) & 0x55555555;
+            return v;
+        }
+
+        // Gathers the even bit positions of v into the 16 low bits.
+        inline uint32_t compactBits(uint32_t v) {
+            v &= 0x55555555;
+            v = (v | (v >> 1)) & 0x33333333;
+            v = (v | (v >> 2)) & 0x0F0F0F0F;
+            v = (v | (v >> 4)) & 0x00FF00FF;
+            v = (v | (v >> 8)) & 0x0000FFFF;
+            return v;
+        }
+
+        // Bits of the same axis as 'bit', at and below it.
+        inline uint32_t axisBitsUpTo(int bit) {
+            uint32_t axis = (bit & 1) ? 0xAAAAAAAAu : 0x55555555u;
+            uint32_t upto = bit == 31 ? 0xFFFFFFFFu : (2u << bit) - 1;
+            return axis & upto;
+        }
+    }
+
+#if PROJECT_HAS_BMI2_KERNELS
+    namespace detail {
+        inline PROJECT_TARGET("bmi2") uint32_t mortonEncodeBmi2(uint32_t x, uint32_t y) {
+            return _pdep_u32(x, 0x55555555u) | _pdep_u32(y, 0xAAAAAAAAu);
+        }
+
+        inline PROJECT_TARGET("bmi2") void mortonDecodeBmi2(uint32_t code, uint32_t& x, uint32_t& y) {
+            x = _pext_u32(code, 0x55555555u);
+            y = _pext_u32(code, 0xAAAAAAAAu);
+        }
+    }
+#endif
+
+    /**
+     * @brief Interleaves x (even bits) and y (odd bits) into a Morton code.
+     */
+    inline uint32_t mortonEncode(uint32_t x, uint32_t y) {
+#if PROJECT_HAS_BMI2_KERNELS
+        if (cpuHasBmi2()) return detail::mortonEncodeBmi2(x, y);
+#endif
+        return detail::spreadBits(x) | (detail::spreadBits(y) << 1);
+    }
+
+    /**
+     * @brief Splits a Morton code back into its x and y coordinates.
+     */
+    inline void mortonDecode(uint32_t code, uint32_t& x, uint32_t& y) {
+#if PROJECT_HAS_BMI2_KERNELS
+        if (cpuHasBmi2()) {
+            detail::mortonDecodeBmi2(code, x, y);
+            return;
+        }
+#endif
+        x = detail::compactBits(code);
+        y = detail::compactBits(code >> 1);
+    }
+
+    // Dataset key of a Morton code, and back; flipping the top bit makes signed order match code order.
+    inline int mortonKey(uint32_t code) { return static_cast<int>(code ^ 0x80000000u); }
+    inline uint32_t mortonCode(int key) { return static_cast<uint32_t>(key) ^ 0x80000000u; }
+
+    /**
+     * @brief Smallest Morton code greater than 'code' that lies in the box [zmin, zmax] (BIGMIN).
+     *
+     * Walks the bits from the top. Where 'code' and the box corners differ, either the answer is
+     * decided, or the box is cut to the half that can still hold it.
+     *
+     * @return True and the code in 'next' if such a code exists, false otherwise.
+     */
+    inline bool mortonBigMin(uint32_t code, uint32_t zmin, uint32_t zmax, uint32_t& next) {
+        bool found = false;
+        for (int bit = 31; bit >= 0; --bit) {
+            uint32_t mask = 1u << bit;
+            uint32_t axis = detail::axisBitsUpTo(bit);
+            int state = ((code & mask) ? 4 : 0) | ((zmin & mask) ? 2 : 0) | ((zmax & mask) ? 1 : 0);
+            switch (state) {
+            case 1: // code 0, zmin 0, zmax 1: the upper half starts a candidate; keep looking in the lower half.
+                next = (zmin & ~axis) | mask;
+                found = true;
+                zmax = (zmax & ~axis) | (axis & ~mask);
+                break;
+            case 3: // code 0, zmin 1, zmax 1: the whole box is above 'code'.
+                next = zmin;
+                return true;
+            case 4: // code 1, zmin 0, zmax 0: the whole box is below 'code'.
+                return found;
+            case 5: // code 1, zmin 0, zmax 1: only the upper half can hold the answer.
+                zmin = (zmin & ~axis) | mask;
+                break;
+            default: // 0/0/0 and 1/1/1 agree; 0/1/0 and 1/1/0 cannot happen for a valid box.
+                break;
+            }
+        }
+        return found;
+    }
+
+    /**
+     * @brief Splits a box into ascending Morton intervals at its LITMAX/BIGMIN points.
+     *
+     * @param box The query box; coordinates must be in 0..MORTON_COORD_MAX and min <= max.
+     * @param max_intervals Once this many intervals are emitted or pending, the remaining boxes are
+     *                      emitted whole (not exact), to be filtered while scanning.
+     * @param intervals Receives the intervals in ascending order; adjacent exact ones are merged.
+     */
+    inline void decomposeMortonBox(const MortonBox& box, int max_intervals, std::vector<MortonInterval>& intervals) {
+        intervals.clear();
+        static thread_local std::vector<MortonBox> pending; // Reused, so a query does not allocate.
+        pending.assign(1, box);
+        while (!pending.empty()) {
+            MortonBox b = pending.back();
+            pending.pop_back();
+            MortonInterval interval;
+            interval.zlo = mortonEncode(b.xmin, b.ymin);
+            interval.zhi = mortonEncode(b.xmax, b.ymax);
+            uint64_t area = static_cast<uint64_t>(b.xmax - b.xmin + 1) * static_cast<uint64_t>(b.ymax - b.ymin + 1);
+            interval.exact = static_cast<uint64_t>(interval.zhi) - interval.zlo + 1 == area;
+            if (!interval.exact && static_cast<int>(intervals.size() + pending.size()) + 2 > max_intervals) {
+                intervals.push_back(interval);
+                continue;
+            }
+            if (interval.exact) {
+                if (!intervals.empty() && intervals.back().exact && intervals.back().zhi + 1 == interval.zlo) {
+                    intervals.back().zhi = interval.zhi;
+                }
+                else {
+                    intervals.push_back(interval);
+                }
+                continue;
+            }
+            // The highest differing bit picks the axis and the coordinate bit to split at.
+            int bit = 31 - __builtin_clz(interval.zlo ^ interval.zhi);
+            int shift = bit / 2;
+            MortonBox lower = b, upper = b;
+            if (bit & 1) {
+                upper.ymin = (b.ymax >> shift) << shift;
+                lower.ymax = upper.ymin - 1; // LITMAX is code(lower.xmax, lower.ymax).
+            }
+            else {
+                upper.xmin = (b.xmax >> shift) << shift;
+                lower.xmax = upper.xmin - 1; // BIGMIN is code(upper.xmin, upper.ymin).
+            }
+            // Lower half on top, so intervals come out in ascending order.
+            pending.push_back(upper);
+            pending.push_back(lower);
+        }
+    }
+
+    /**
+     * @brief Loads points from a file with one "x y" or "x,y" pair per line.
+     *
+     * Lines that do not hold two coordinates in 0..MORTON_COORD_MAX are skipped with a warning,
+     * like invalid lines in loadDatasetFromFile.
+     *
+     * @return True if at least one point was loaded, false otherwise.
+     */
+    inline bool loadPointsFromFile(std::vector<Point2D>& points, const std::string& filename) {
+        points.clear();
+        std::ifstream infile(filename);
+        if (!infile.is_open()) {
+            std::cerr << "Error: Could not open file '" << filename << "'. Please check the path and verify it is valid.\n";
+            return false;
+        }
+
+        ScopedLoadPhase phase(LoadPhase::Read);
+        std::string line;
+        uint64_t bytes_read = 0;
+        while (std::getline(infile, line)) {
+            bytes_read += line.size() + 1;
+            std::string fields = line;
+            std::replace(fields.begin(), fields.end(), ',', ' ');
+            std::istringstream parser(fields);
+            long long x = 0, y = 0;
+            std::string rest;
+            if (!(parser >> x >> y) || (parser >> rest)) {
+                std::cerr << "Warning: Invalid data in file '" << filename << "': '" << line << "' is not a valid point. Skipping.\n";
+                continue;
+            }
+            if (x < 0 || x > MORTON_COORD_MAX || y < 0 || y > MORTON_COORD_MAX) {
+                std::cerr << "Warning: Coordinate out of range in file '" << filename << "': '" << line << "'. Skipping.\n";
+                continue;
+            }
+            Point2D point;
+            point.x = static_cast<int>(x);
+            point.y = static_cast<int>(y);
+            points.push_back(point);
+        }
+        MetricsRegistry::global().addIngestedBytes(bytes_read);
+
+        if (points.empty()) {
+            std::cerr << "Warning: No valid data loaded from file '" << filename << "'. Dataset is empty.\n";
+            return false;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Sorted, de-duplicated Morton keys of a point set, answering bounding-box queries.
+     */
+    class MortonPointIndex {
+    public:
+        /**
+         * @brief Encodes the points and runs them through the dataset sort/de-duplicate pipeline.
+         */
+        void build(const std::vector<Point2D>& points) {
+            keys.resize(points.size());
+            for (size_t i = 0; i < points.size(); ++i) {
+                keys[i] = mortonKey(mortonEncode(static_cast<uint32_t>(points[i].x), static_cast<uint32_t>(points[i].y)));
+            }
+            sortAndDeduplicateDataset(keys);
+        }
+
+        size_t size() const { return keys.size(); }
+        size_t memoryBytes() const { return keys.capacity() * sizeof(int); }
+        const std::vector<int>& sortedKeys() const { return keys; }
+
+        /**
+         * @brief Number of distinct points in 'box'.
+         *
+         * @param max_intervals How many Morton intervals the box may be split into; 1 scans zmin..zmax
+         *                      with BIGMIN jumps only.
+         * @param num_intervals If not null, receives the number of intervals used.
+         */
+        size_t boxCount(const MortonBox& box, int max_intervals = MORTON_MAX_INTERVALS, int* num_intervals = nullptr) const {
+            size_t count = 0;
+            visitBox(box, max_intervals, num_intervals,
+                [&](int first, int last) { count += static_cast<size_t>(last - first); },
+                [&](int) { ++count; });
+            return count;
+        }
+
+        /**
+         * @brief Appends the distinct points in 'box' to 'out', in Morton order.
+         *
+         * @param max_intervals, num_intervals As for boxCount.
+         */
+        void boxQuery(const MortonBox& box, std::vector<Point2D>& out, int max_intervals = MORTON_MAX_INTERVALS, int* num_intervals = nullptr) const {
+            auto append = [&](int position) {
+                uint32_t x, y;
+                mortonDecode(mortonCode(keys[position]), x, y);
+                Point2D point;
+                point.x = static_cast<int>(x);
+                point.y = static_cast<int>(y);
+                out.push_back(point);
+            };
+            visitBox(box, max_intervals, num_intervals,
+                [&](int first, int last) { for (int i = first; i < last; ++i) append(i); },
+                append);
+        }
+
+    private:
+        // Calls onRun(first, last) for each run of keys known to be in the box, onKey(position) for
+        // each key found in the box by filtering.
+        template<typename OnRun, typename OnKey>
+        void visitBox(const MortonBox& box, int max_intervals, int* num_intervals, OnRun onRun, OnKey onKey) const {
+            static thread_local std::vector<MortonInterval> intervals;
+            decomposeMortonBox(box, std::max(1, max_intervals), intervals);
+            if (num_intervals) *num_intervals = static_cast<int>(intervals.size());
+            const int* data = keys.data();
+            int n = static_cast<int>(keys.size());
+            int position = 0; // Intervals ascend, so each search starts where the previous one ended.
+            for (const MortonInterval& interval : intervals) {
+                if (position == n) break;
+                // The key the previous interval stopped at often already lies at or past this one.
+                uint32_t current = mortonCode(data[position]);
+                if (current > interval.zhi) continue;
+                if (current < interval.zlo) position += smallLowerBound(data + position, n - position, mortonKey(interval.zlo));
+                if (interval.exact) {
+                    int last = interval.zhi == 0xFFFFFFFFu ? n : position + smallLowerBound(data + position, n - position, mortonKey(interval.zhi + 1));
+                    onRun(position, last);
+                    position = last;
+                    continue;
+                }
+                uint32_t zmin = interval.zlo, zmax = interval.zhi;
+                while (position < n) {
+                    uint32_t code = mortonCode(data[position]);
+                    if (code > zmax) break;
+                    uint32_t x, y;
+                    mortonDecode(code, x, y);
+                    if (box.contains(static_cast<int>(x), static_cast<int>(y))) {
+                        onKey(position++);
+                        continue;
+                    }
+                    uint32_t next;
+                    if (!mortonBigMin(code, zmin, zmax, next)) {
+                        position = n;
+                        break;
+                    }
+                    position += smallLowerBound(data + position, n - position, mortonKey(next));
+                }
+            }
+        }
+
+        std::vector<int> keys;
+    };
+
+    /**
+     * @brief Times random box queries on a point set and checks every count against a full scan.
+     *
+     * Compares the scan, a single zmin..zmax interval with BIGMIN jumps, and the decomposition
+     * into up to MORTON_MAX_INTERVALS intervals.
+     *
+     * @param box_size Side length of the query boxes.
+     * @return True if every count matched the scan.
+     */
+    inline bool runSpatialQueryReport(const std::vector<Point2D>& points, size_t num_queries, int box_size, std::ostream& out) {
+        typedef std::chrono::high_resolution_clock Clock;
+        MortonPointIndex index;
+        auto start = Clock::now();
+        index.build(points);
+        auto end = Clock::now();
+        out << "Morton index: " << index.size() << " distinct points of " << points.size() << ", " << index.memoryBytes()
+            << " bytes, built in " << std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() << " us\n";
+        if (index.size() == 0 || num_queries == 0) return true;
+
+        // The scan baseline runs over the distinct points, as the index does.
+        std::vector<Point2D> distinct;
+        distinct.reserve(index.size());
+        for (int key : index.sortedKeys()) {
+            uint32_t x, y;
+            mortonDecode(mortonCode(key), x, y);
+            Point2D point;
+            point.x = static_cast<int>(x);
+            point.y = static_cast<int>(y);
+            distinct.push_back(point);
+        }
+
+        box_size = std::max(1, std::min(box_size, MORTON_COORD_MAX + 1));
+        std::mt19937 rng(2025);
+        std::uniform_int_distribution<int> corner(0, MORTON_COORD_MAX + 1 - box_size);
+        std::vector<MortonBox> boxes(num_queries);
+        for (MortonBox& box : boxes) {
+            box.xmin = corner(rng);
+            box.ymin = corner(rng);
+            box.xmax = box.xmin + box_size - 1;
+            box.ymax = box.ymin + box_size - 1;
+        }
+
+        std::vector<size_t> expected(num_queries), counts(num_queries);
+        auto t0 = Clock::now();
+        for (size_t q = 0; q < num_queries; ++q) {
+            size_t count = 0;
+            for (const Point2D& point : distinct) count += boxes[q].contains(point.x, point.y);
+            expected[q] = count;
+        }
+        auto t1 = Clock::now();
+        double scan_ns = std::chrono::duration<double, std::nano>(t1 - t0).count() / num_queries;
+
+        out << "Box " << box_size << "x" << box_size << ", " << num_queries << " queries\n";
+        out << std::left << std::setw(22) << "Method" << std::right << std::setw(14) << "ns/box" << std::setw(12) << "Intervals"
+            << std::setw(12) << "Points" << "  Correct\n";
+        auto report = [&](const char* name, double ns, double intervals, double found, bool correct) {
+            out << std::left << std::setw(22) << name << std::right << std::fixed << std::setprecision(1) << std::setw(14) << ns
+                << std::setw(12) << intervals << std::setw(12) << found << "  " << (correct ? "yes" : "NO") << "\n";
+        };
+        double mean_points = 0.0;
+        for (size_t count : expected) mean_points += static_cast<double>(count);
+        mean_points /= num_queries;
+        report("scan", scan_ns, 0.0, mean_points, true);
+
+        bool all_correct = true;
+        const int budgets[] = { 1, MORTON_MAX_INTERVALS };
+        const char* names[] = { "morton bigmin", "morton intervals" };
+        for (int b = 0; b < 2; ++b) {
+            long long total_intervals = 0;
+            t0 = Clock::now();
+            for (size_t q = 0; q < num_queries; ++q) {
+                int used = 0;
+                counts[q] = index.boxCount(boxes[q], budgets[b], &used);
+                total_intervals += used;
+            }
+            t1 = Clock::now();
+            bool correct = counts == expected;
+            all_correct = all_correct && correct;
+            report(names[b], std::chrono::duration<double, std::nano>(t1 - t0).count() / num_queries,
+                static_cast<double>(total_intervals) / num_queries, mean_points, correct);
+        }
+        return all_correct;
+    }
+
+} // namespace ProjectUtils
+
+#endif // SPATIAL_SEARCH_H
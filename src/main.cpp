@@ -1,10 +1,38 @@
 #include "ProjectUtils.h"
+#include "MemoryBudget.h"
+#include "Sharding.h"
+#include "NumaSupport.h"
+#include "SetOperations.h"
+#include "CrackerIndex.h"
+#include "Benchmark.h"
+#include "CacheSimulator.h"
+#include "AdversarialSearch.h"
+#include "ApproximateSummary.h"
+#include "MeteredSearchIndex.h"
+#include "SpatialSearch.h"
+#include "DatasetDelta.h"
+#include "LoadGenerator.h"
+#include "MixedWorkload.h"
 #include <string>
 #include <limits>
 #include <iostream>
 #include <vector> // These were missing in your original snippet's includes, added for completeness
 #include <algorithm> // for std::sort, std::min, std::max, std::lower_bound
 #include <cmath>     // for std::abs, std::sqrt
+#include <chrono>    // for timing searches that do not go through measureSearchTime
+#include <cstdio>    // for std::printf in command-line reports
+#include <utility>   // for std::move
+#include <thread>    // for the metrics textfile writer in serve mode
+#include <atomic>
+#include <sstream>   // for the comma-separated rates of load mode
+#include <csignal>   // for ignoring SIGPIPE while load mode writes to the server process
+#include <cerrno>    // for the range checks of parseNumberArgument
+#include <cstdlib>   // for std::strtoll and std::strtold
+#include <cctype>
+#include <type_traits>
+#ifdef HAVE_EMBEDDED_TABLES
+#include "EmbeddedRandom100k.h" // Generated at build time from data/data_100k_random.txt.
+#endif
 
 /*
 Change Log:
@@ -153,6 +181,479 @@ std::vector<int> findClosestValues(const std::vector<int>& dataset, int target)
     return closest_values;
 }
 
+// Prompts until the user enters a valid integer and clears the rest of the input line.
+int promptForInteger(const std::string& prompt) {
+    int value;
+    std::cout << prompt;
+    // --- Input validation for value ---
+    while (!(std::cin >> value)) { // Attempt to read integer. If fails...
+        std::cout << "Invalid input. Please enter a valid integer: ";
+        std::cin.clear(); // Clear the error flags on std::cin
+        // Discard invalid input from the buffer until a newline is found
+        std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    }
+    std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n'); // Clear leftover newline
+    return value;
+}
+
+// Prints the command-line usage for the non-interactive modes.
+void printCommandLineUsage() {
+    std::cout << "Usage:\n"
+        << "  Main                                  Start the interactive menu.\n"
+        << "  Main bench [file]...                  Run the benchmark suite on each file (default: the standard sweep).\n"
+        << "  Main budget <budget_kb> <file>...     Choose search indexes for the files within one global memory budget.\n"
+        << "  Main shard-bench <file> [max_shards]  Report sharded batch lookup throughput for 1, 2, 4, ... shards.\n"
+        << "  Main numa-bench <file> [threads]      Show NUMA topology and compare per-node replicas with one shared copy.\n"
+        << "  Main update-bench <file>...           Compare the updatable learned index with a sorted vector under inserts/deletes.\n"
+        << "  Main mixed-bench <file> [max_threads] [ops]\n"
+        << "                                        Run YCSB-style read/insert/delete/scan mixes on every updatable\n"
+        << "                                        representation at 1, 2, 4, ... threads with latency percentiles.\n"
+        << "  Main cache-sim <file> [queries] [key=value]...\n"
+        << "                                        Simulate L1/L2/LLC/TLB misses per query for each algorithm.\n"
+        << "                                        Settings: l1_kb, l2_kb, llc_kb, line, tlb, page.\n"
+        << "  Main hot-cache <file> [zipf_skew] [capacity]\n"
+        << "                                        Compare every algorithm with and without the hot-key cache on Zipf queries.\n"
+        << "  Main approx <file> [relative_error]   Check approximate rank/range-count/quantile answers against exact ones.\n"
+        << "  Main serve <file> [algorithm] [textfile=<path.prom>] [listen=<port|unix:path>]\n"
+        << "                                        Answer one lookup per stdin line with metrics exported to a\n"
+        << "                                        Prometheus textfile (rewritten every second) and/or an HTTP endpoint.\n"
+        << "  Main diff <old_file> <new_file> <delta_file> [threads]\n"
+        << "                                        Write the binary delta (inserted and deleted key runs) between two versions.\n"
+        << "  Main patch <file> <delta_file> [out_file]\n"
+        << "                                        Apply a delta to a dataset in place and optionally save the result.\n"
+        << "  Main load <file> [algorithm] [key=value]...\n"
+        << "                                        Open-loop load at fixed rates with latency from the intended send time.\n"
+        << "                                        Settings: target=inproc|server, arrivals=poisson|constant, workers,\n"
+        << "                                        rates=<qps,qps,...>, seconds, hgrm=<prefix|->.\n"
+        << "  Main range-filter <file> [fpr] [bits_per_key]\n"
+        << "                                        Time range-emptiness checks with and without the range filter\n"
+        << "                                        built for the given range false-positive rate (default 0.01)\n"
+        << "                                        and memory cap (default 0: what the rate needs).\n"
+        << "  Main points <file> [queries] [box_size]\n"
+        << "                                        Time Morton-coded bounding-box queries on an \"x y\" point file\n"
+        << "                                        and check them against a full scan.\n"
+        << "  Main adversarial <algorithm> [probes|latency] [iterations] [keys]\n"
+        << "                                        Search for the worst dataset and queries for one algorithm and save\n"
+        << "                                        them as data/data_adversarial_<algorithm>[_queries].txt.\n";
+}
+
+// Parses a numeric command-line argument. The whole of 'text' must be a number of type T in
+// [min_value, max_value]; otherwise the error and the usage are printed and false is returned,
+// so a mode can simply return 1.
+template<typename T>
+bool parseNumberArgument(const std::string& text, const std::string& name, T min_value, T max_value, T& value) {
+    const char* begin = text.c_str();
+    char* end = nullptr;
+    errno = 0;
+    long double parsed = 0.0L;
+    if (std::is_integral<T>::value) parsed = static_cast<long double>(std::strtoll(begin, &end, 10));
+    else parsed = std::strtold(begin, &end);
+    if (text.empty() || std::isspace(static_cast<unsigned char>(text[0])) || end != begin + text.size() || errno == ERANGE
+        || !(parsed >= static_cast<long double>(min_value) && parsed <= static_cast<long double>(max_value))) {
+        std::cerr << "Error: '" << text << "' is not a valid " << name << ".\n";
+        printCommandLineUsage();
+        return false;
+    }
+    value = static_cast<T>(parsed);
+    return true;
+}
+
+// Serve mode: answers one target per input line with its index (or -1) through a metered index.
+// A line that is not exactly one integer is answered with "error".
+// While serving, the metrics are rewritten to 'textfile' (if given) once a second and on exit.
+int serveLookups(ProjectUtils::SearchIndex& index, const std::string& textfile, std::istream& in, std::ostream& out) {
+    ProjectUtils::MetricsRegistry& metrics = ProjectUtils::MetricsRegistry::global();
+    std::atomic<bool> serving(true);
+    std::thread writer;
+    if (!textfile.empty()) {
+        if (!metrics.writeTextfile(textfile)) return 1;
+        writer = std::thread([&]() {
+            int ticks = 0;
+            while (serving.load()) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+                if (++ticks % 10 == 0) metrics.writeTextfile(textfile);
+            }
+        });
+    }
+    std::string line;
+    while (std::getline(in, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back(); // Accept CRLF line endings.
+        // Every request line gets exactly one reply, so pipelined clients stay matched to their requests.
+        int target = 0;
+        size_t parsed = 0;
+        try {
+            target = std::stoi(line, &parsed);
+        }
+        catch (const std::exception&) {
+            parsed = 0;
+        }
+        if (parsed == 0 || parsed != line.size()) {
+            std::cerr << "Warning: '" << line << "' is not a valid integer.\n";
+            out << "error\n";
+        }
+        else {
+            out << index.search(target) << "\n";
+        }
+        // Pipelined clients wait on each reply, so flush once no more input is already buffered.
+        if (in.rdbuf()->in_avail() <= 0) out.flush();
+    }
+    out.flush();
+    serving = false;
+    if (writer.joinable()) writer.join();
+    if (!textfile.empty() && !metrics.writeTextfile(textfile)) return 1;
+    return 0;
+}
+
+// Runs the non-interactive mode named by argv[1]. Returns the process exit code.
+int runCommandLine(int argc, char* argv[]) {
+    const std::string mode = argv[1];
+    if (mode == "bench") {
+        std::vector<std::string> files(argv + 2, argv + argc);
+        if (files.empty()) files = ProjectUtils::benchmarkSweepFiles();
+        ProjectUtils::printMachineProfile(ProjectUtils::machineProfile(), std::cout);
+        std::cout << ProjectUtils::simdKernelSummary() << "\n";
+        for (const std::string& file : files) {
+            std::vector<int> data;
+            if (!ProjectUtils::loadAndSortDatasetFromFile(data, file)) continue;
+            // A saved adversarial case comes with the queries that hurt most; use them when present.
+            std::string queries_file = file.size() > 4 ? file.substr(0, file.size() - 4) + "_queries.txt" : file;
+            std::vector<int> queries;
+            if (file.find("adversarial") != std::string::npos && ProjectUtils::loadDatasetFromFile(queries, queries_file) && !queries.empty()) {
+                ProjectUtils::printBenchmarkTable(ProjectUtils::runBenchmarkSuite(data, queries), std::cout);
+            }
+            else {
+                ProjectUtils::printBenchmarkTable(ProjectUtils::runBenchmarkSuite(data), std::cout);
+            }
+            ProjectUtils::printRangeFilterReport(ProjectUtils::runRangeFilterBenchmark(data), std::cout);
+        }
+        return 0;
+    }
+    if (mode == "budget" && argc >= 4) {
+        size_t budget_kb = 0;
+        if (!parseNumberArgument(argv[2], "budget in KB", size_t(0), std::numeric_limits<size_t>::max() / 1024, budget_kb)) return 1;
+        size_t budget_bytes = budget_kb * 1024;
+        std::vector<std::vector<int>> datasets(argc - 3);
+        ProjectUtils::MemoryBudgetManager manager;
+        for (int i = 3; i < argc; ++i) {
+            ProjectUtils::LoadMemoryReport load_memory;
+            std::vector<int>& data = datasets[i - 3];
+            if (!ProjectUtils::trackLoadPeakRss([&]() { return ProjectUtils::loadAndSortDatasetFromFile(data, argv[i]); }, load_memory)) {
+                return 1;
+            }
+            manager.addDataset(argv[i], data, 1.0, load_memory);
+        }
+        manager.profile();
+        size_t planned = manager.planGlobal(budget_bytes);
+        manager.printReport(std::cout, budget_bytes, planned);
+        return 0;
+    }
+    if (mode == "shard-bench" && argc >= 3) {
+#if PROJECT_HAS_SHARDING
+        std::vector<int> data;
+        if (!ProjectUtils::loadAndSortDatasetFromFile(data, argv[2])) return 1;
+        int max_shards = 8;
+        if (argc >= 4 && !parseNumberArgument(argv[3], "shard count", 1, 1 << 20, max_shards)) return 1;
+        std::vector<int> shard_counts;
+        for (int count = 1; count <= max_shards; count *= 2) shard_counts.push_back(count);
+
+        std::cout << "Shards   Queries/sec   ns/query\n";
+        for (const ProjectUtils::ShardThroughput& entry : ProjectUtils::measureShardThroughput(data, shard_counts)) {
+            std::printf("%6d %13.0f %10.1f\n", entry.shards, entry.queries_per_second, entry.ns_per_query);
+        }
+        return 0;
+#else
+        std::cerr << "Error: Sharded mode needs fork() and Unix-domain sockets, which this platform does not provide.\n";
+        return 1;
+#endif
+    }
+    if (mode == "numa-bench" && argc >= 3) {
+        std::vector<int> data;
+        if (!ProjectUtils::loadAndSortDatasetFromFile(data, argv[2])) return 1;
+        int threads_per_node = 0;
+        if (argc >= 4 && !parseNumberArgument(argv[3], "thread count", 0, 1 << 20, threads_per_node)) return 1;
+        ProjectUtils::runNumaBenchmark(data, threads_per_node, "interpolation", std::cout);
+        return 0;
+    }
+    if (mode == "update-bench" && argc >= 3) {
+        for (int i = 2; i < argc; ++i) {
+            std::vector<int> data;
+            if (!ProjectUtils::loadAndSortDatasetFromFile(data, argv[i])) continue;
+            ProjectUtils::printUpdateBenchmarkTable(ProjectUtils::runUpdateBenchmark(data), std::cout);
+        }
+        return 0;
+    }
+    if (mode == "mixed-bench" && argc >= 3) {
+        std::vector<int> data;
+        if (!ProjectUtils::loadAndSortDatasetFromFile(data, argv[2])) return 1;
+        int max_threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+        size_t ops = 100000;
+        if (argc >= 4 && !parseNumberArgument(argv[3], "thread count", 1, 1 << 20, max_threads)) return 1;
+        if (argc >= 5 && !parseNumberArgument(argv[4], "operation count", size_t(1), std::numeric_limits<size_t>::max(), ops)) return 1;
+        std::vector<ProjectUtils::MixedWorkloadResult> rows = ProjectUtils::runMixedWorkloadBenchmark(data, max_threads, ops);
+        ProjectUtils::printMixedWorkloadTable(rows, std::cout);
+        for (const ProjectUtils::MixedWorkloadResult& row : rows) {
+            if (!row.correct) return 1;
+        }
+        return 0;
+    }
+    if (mode == "cache-sim" && argc >= 3) {
+        std::vector<int> data;
+        if (!ProjectUtils::loadAndSortDatasetFromFile(data, argv[2])) return 1;
+        size_t num_queries = 10000;
+        ProjectUtils::CacheModelConfig config;
+        for (int i = 3; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg.find('=') == std::string::npos) {
+                if (!parseNumberArgument(arg, "query count", size_t(1), std::numeric_limits<size_t>::max(), num_queries)) return 1;
+            }
+            else if (!config.parseOverride(arg)) return 1;
+        }
+        ProjectUtils::printCacheSimulationReport(ProjectUtils::runCacheSimulation(data, num_queries, config), config, std::cout);
+        return 0;
+    }
+    if (mode == "hot-cache" && argc >= 3) {
+        std::vector<int> data;
+        if (!ProjectUtils::loadAndSortDatasetFromFile(data, argv[2])) return 1;
+        double skew = 1.0;
+        size_t capacity = 4096;
+        if (argc >= 4 && !parseNumberArgument(argv[3], "Zipf skew", 0.0, 100.0, skew)) return 1;
+        if (argc >= 5 && !parseNumberArgument(argv[4], "cache capacity", size_t(1), std::numeric_limits<size_t>::max(), capacity)) return 1;
+        ProjectUtils::printHotCacheBenchmarkTable(ProjectUtils::runHotCacheBenchmark(data, skew, capacity), std::cout);
+        return 0;
+    }
+    if (mode == "approx" && argc >= 3) {
+        std::vector<int> data;
+        if (!ProjectUtils::loadAndSortDatasetFromFile(data, argv[2])) return 1;
+        double relative_error = 0.001;
+        if (argc >= 4 && !parseNumberArgument(argv[3], "relative error", 0.0, 1.0, relative_error)) return 1;
+        if (!(relative_error > 0.0 && relative_error < 1.0)) {
+            std::cerr << "Error: The relative error must be between 0 and 1.\n";
+            return 1;
+        }
+        ProjectUtils::runApproximateQueryReport(data, relative_error, 100000, std::cout);
+        return 0;
+    }
+    if (mode == "serve" && argc >= 3) {
+        std::string algorithm = "interpolation", textfile, listen;
+        for (int i = 3; i < argc; ++i) {
+            std::string arg = argv[i];
+            if (arg.compare(0, 9, "textfile=") == 0) textfile = arg.substr(9);
+            else if (arg.compare(0, 7, "listen=") == 0) listen = arg.substr(7);
+            else algorithm = arg;
+        }
+        std::unique_ptr<ProjectUtils::MeteredSearchIndex> index = ProjectUtils::createMeteredSearchIndex(algorithm);
+        if (!index) {
+            std::cerr << "Error: Unknown algorithm '" << algorithm << "'.\n";
+            return 1;
+        }
+        std::vector<int> data;
+        std::streambuf* replies = std::cout.rdbuf(std::cerr.rdbuf()); // Keep stdout for answers only.
+        bool loaded = ProjectUtils::loadAndSortDatasetFromFile(data, argv[2]);
+        std::cout.rdbuf(replies);
+        if (!loaded) return 1;
+        index->build(data);
+#if PROJECT_HAS_METRICS_ENDPOINT
+        ProjectUtils::MetricsEndpoint endpoint;
+        if (!listen.empty() && !endpoint.start(listen)) return 1;
+#else
+        if (!listen.empty()) {
+            std::cerr << "Error: The metrics endpoint needs POSIX sockets, which this platform does not provide.\n";
+            return 1;
+        }
+#endif
+        return serveLookups(*index, textfile, std::cin, std::cout);
+    }
+    if (mode == "diff" && argc >= 5) {
+        std::vector<int> base, target;
+        if (!ProjectUtils::loadAndSortDatasetFromFile(base, argv[2]) || !ProjectUtils::loadAndSortDatasetFromFile(target, argv[3])) return 1;
+        int threads = 1;
+        if (argc >= 6 && !parseNumberArgument(argv[5], "thread count", 1, 1 << 20, threads)) return 1;
+        auto start = std::chrono::high_resolution_clock::now();
+        ProjectUtils::DatasetDelta delta = ProjectUtils::diffDatasets(base, target, threads);
+        auto end = std::chrono::high_resolution_clock::now();
+        size_t delta_bytes = ProjectUtils::encodeDatasetDelta(delta).size();
+        if (!ProjectUtils::writeDatasetDeltaFile(delta, argv[4])) return 1;
+        std::printf("%zu inserted, %zu deleted in %zu runs; diffed in %.1f ms on %d thread(s)\n", delta.insertedCount(), delta.deletedCount(),
+            delta.runs.size(), std::chrono::duration<double, std::milli>(end - start).count(), threads);
+        std::printf("Delta: %zu bytes, %.2f%% of the %zu-byte binary dataset; written to '%s'\n", delta_bytes,
+            100.0 * delta_bytes / std::max<size_t>(1, target.size() * sizeof(int)), target.size() * sizeof(int), argv[4]);
+        return 0;
+    }
+    if (mode == "patch" && argc >= 4) {
+        std::vector<int> data;
+        ProjectUtils::DatasetDelta delta;
+        if (!ProjectUtils::loadAndSortDatasetFromFile(data, argv[2]) || !ProjectUtils::readDatasetDeltaFile(delta, argv[3])) return 1;
+        auto start = std::chrono::high_resolution_clock::now();
+        bool applied = ProjectUtils::applyDatasetDelta(delta, data);
+        auto end = std::chrono::high_resolution_clock::now();
+        if (!applied) return 1;
+        bool verified = ProjectUtils::datasetChecksum(data) == delta.target_checksum;
+        std::printf("Applied %zu runs (%zu inserted, %zu deleted) in %.1f us; %zu keys, checksum %s\n", delta.runs.size(), delta.insertedCount(),
+            delta.deletedCount(), std::chrono::duration<double, std::micro>(end - start).count(), data.size(), verified ? "matches" : "MISMATCH");
+        if (argc >= 5 && !ProjectUtils::writeDatasetFile(data, argv[4])) return 1;
+        return verified ? 0 : 1;
+    }
+    if (mode == "range-filter" && argc >= 3) {
+        std::vector<int> data;
+        if (!ProjectUtils::loadAndSortDatasetFromFile(data, argv[2])) return 1;
+        double fpr = 0.01;
+        if (argc >= 4 && !parseNumberArgument(argv[3], "false-positive rate", 0.0, 1.0, fpr)) return 1;
+        if (!(fpr > 0.0 && fpr < 1.0)) {
+            std::cerr << "Error: The false-positive rate must be between 0 and 1.\n";
+            return 1;
+        }
+        double max_bits_per_key = ProjectUtils::RANGE_FILTER_UNCAPPED;
+        if (argc >= 5 && !parseNumberArgument(argv[4], "bits-per-key cap", 0.0, 1e6, max_bits_per_key)) return 1;
+        ProjectUtils::RangeFilterBenchmarkReport report = ProjectUtils::runRangeFilterBenchmark(data, fpr, max_bits_per_key);
+        ProjectUtils::printRangeFilterReport(report, std::cout);
+        for (const ProjectUtils::RangeFilterBenchmarkRow& row : report.rows) {
+            if (!row.correct) return 1;
+        }
+        return 0;
+    }
+    if (mode == "load" && argc >= 3) {
+        std::string algorithm = "interpolation", target = "inproc", hgrm;
+        ProjectUtils::ArrivalPattern arrivals = ProjectUtils::ArrivalPattern::Poisson;
+        std::vector<double> rates;
+        double seconds = 1.0;
+        int workers = 1;
+        for (int i = 3; i < argc; ++i) {
+            std::string arg = argv[i];
+            size_t eq = arg.find('=');
+            if (eq == std::string::npos) {
+                algorithm = arg;
+                continue;
+            }
+            std::string key = arg.substr(0, eq), value = arg.substr(eq + 1);
+            if (key == "target") target = value;
+            else if (key == "arrivals" && (value == "poisson" || value == "constant")) {
+                arrivals = value == "poisson" ? ProjectUtils::ArrivalPattern::Poisson : ProjectUtils::ArrivalPattern::Constant;
+            }
+            else if (key == "workers") {
+                if (!parseNumberArgument(value, "worker count", 1, 1 << 20, workers)) return 1;
+            }
+            else if (key == "seconds") {
+                if (!parseNumberArgument(value, "duration in seconds", 0.01, 1e6, seconds)) return 1;
+            }
+            else if (key == "hgrm") hgrm = value;
+            else if (key == "rates") {
+                std::stringstream list(value);
+                std::string rate;
+                while (std::getline(list, rate, ',')) {
+                    double qps = 0.0;
+                    if (!parseNumberArgument(rate, "rate in qps", 1.0, 1e12, qps)) return 1;
+                    rates.push_back(qps);
+                }
+            }
+            else {
+                std::cerr << "Error: Unknown load setting '" << arg << "'.\n";
+                return 1;
+            }
+        }
+        if (target != "inproc" && target != "server") {
+            std::cerr << "Error: Unknown load target '" << target << "' (use inproc or server).\n";
+            return 1;
+        }
+        std::unique_ptr<ProjectUtils::SearchIndex> index = ProjectUtils::createMeteredSearchIndex(algorithm); // Same path as serve.
+        if (!index) {
+            std::cerr << "Error: Unknown algorithm '" << algorithm << "'.\n";
+            return 1;
+        }
+        std::vector<int> data;
+        if (!ProjectUtils::loadAndSortDatasetFromFile(data, argv[2])) return 1;
+        std::vector<int> queries = ProjectUtils::makeBenchmarkQueries(data, 1 << 20);
+        const size_t max_queries_per_rate = 20000000;
+        std::vector<ProjectUtils::LoadRunResult> runs;
+        double capacity = 0.0;
+        if (target == "inproc") {
+            index->build(data);
+            capacity = ProjectUtils::measureInProcessCapacity(*index, queries, workers);
+            double generator_qps = ProjectUtils::measureLoadGeneratorCeiling(queries, workers);
+            if (rates.empty()) rates = ProjectUtils::defaultLoadSweepRates(capacity);
+            std::printf("Load: in-process %s, %d worker(s), capacity through the load loop about %.0f qps (the loop alone: %.0f qps)\n",
+                algorithm.c_str(), workers, capacity, generator_qps);
+            for (double rate : rates) {
+                size_t count = std::min(max_queries_per_rate, std::max<size_t>(1, static_cast<size_t>(rate * seconds)));
+                std::vector<uint64_t> schedule = ProjectUtils::makeArrivalSchedule(rate, count, arrivals);
+                runs.push_back(ProjectUtils::runInProcessLoad(*index, queries, schedule, rate, workers));
+            }
+            ProjectUtils::markGeneratorBoundRuns(runs, generator_qps);
+        }
+        else {
+#if PROJECT_HAS_LOAD_SERVER_TARGET
+            std::signal(SIGPIPE, SIG_IGN); // A server that exits early must show up as a failed write, not end this process.
+            ProjectUtils::ServeProcess server;
+            if (!server.start(argv[0], argv[2], algorithm)) return 1;
+            std::vector<int> probe(queries.begin(), queries.begin() + std::min<size_t>(queries.size(), 200000));
+            capacity = ProjectUtils::measureServerCapacity(server, probe);
+            if (rates.empty()) rates = ProjectUtils::defaultLoadSweepRates(capacity);
+            std::printf("Load: 'serve %s' child process, pipelined capacity about %.0f qps\n", algorithm.c_str(), capacity);
+            for (double rate : rates) {
+                size_t count = std::min(max_queries_per_rate, std::max<size_t>(1, static_cast<size_t>(rate * seconds)));
+                std::vector<uint64_t> schedule = ProjectUtils::makeArrivalSchedule(rate, count, arrivals);
+                runs.push_back(ProjectUtils::runServerLoad(server, queries, schedule, rate));
+            }
+            server.stop();
+#else
+            std::cerr << "Error: The server target needs POSIX processes and pipes, which this platform does not provide.\n";
+            return 1;
+#endif
+        }
+        ProjectUtils::printLoadSweepTable(runs, std::cout);
+        for (const ProjectUtils::LoadRunResult& run : runs) {
+            if (hgrm.empty()) break;
+            if (hgrm == "-") {
+                std::printf("\n# Target %.0f qps, latency from the intended send time (us)\n", run.target_qps);
+                run.latency.writePercentileDistribution(std::cout);
+                continue;
+            }
+            std::string path = hgrm + "_" + std::to_string(static_cast<long long>(run.target_qps)) + "qps.hgrm";
+            std::ofstream file(path);
+            if (!file) {
+                std::cerr << "Error: Could not write '" << path << "'.\n";
+                return 1;
+            }
+            run.latency.writePercentileDistribution(file);
+            std::printf("Wrote %s\n", path.c_str());
+        }
+        return 0;
+    }
+    if (mode == "points" && argc >= 3) {
+        std::vector<ProjectUtils::Point2D> points;
+        if (!ProjectUtils::loadPointsFromFile(points, argv[2])) return 1;
+        size_t num_queries = 1000;
+        int box_size = 1024;
+        if (argc >= 4 && !parseNumberArgument(argv[3], "query count", size_t(1), std::numeric_limits<size_t>::max(), num_queries)) return 1;
+        if (argc >= 5 && !parseNumberArgument(argv[4], "box size", 1, std::numeric_limits<int>::max(), box_size)) return 1;
+        return ProjectUtils::runSpatialQueryReport(points, num_queries, box_size, std::cout) ? 0 : 1;
+    }
+    if (mode == "adversarial" && argc >= 3) {
+        std::string algorithm = argv[2];
+        std::string objective = argc >= 4 ? argv[3] : "probes";
+        int iterations = 200;
+        int keys = 100000;
+        if (argc >= 5 && !parseNumberArgument(argv[4], "iteration count", 0, std::numeric_limits<int>::max(), iterations)) return 1;
+        if (argc >= 6 && !parseNumberArgument(argv[5], "key count", 2, std::numeric_limits<int>::max(), keys)) return 1;
+        if (objective != "probes" && objective != "latency") {
+            printCommandLineUsage();
+            return 1;
+        }
+        ProjectUtils::AdversarialEvaluator evaluator(algorithm, objective == "latency");
+        if (!evaluator.valid()) return 1;
+        std::cout << "Searching for the worst case of '" << algorithm << "' by " << objective << " (" << iterations << " steps):\n";
+        ProjectUtils::AdversarialCase worst = ProjectUtils::findAdversarialCase(evaluator, keys, iterations, 2025, std::cout);
+        std::string data_file = "data/data_adversarial_" + algorithm + ".txt";
+        std::string queries_file = "data/data_adversarial_" + algorithm + "_queries.txt";
+        if (!ProjectUtils::writeDatasetFile(worst.data, data_file) || !ProjectUtils::writeDatasetFile(worst.queries, queries_file)) return 1;
+        std::cout << "Worst case: " << worst.description << " (" << (objective == "probes" ? "reads/query " : "ns/lookup ")
+            << worst.score << ")\nSaved " << worst.data.size() << " keys to " << data_file << " and " << worst.queries.size()
+            << " queries to " << queries_file << ".\n";
+        return 0;
+    }
+    printCommandLineUsage();
+    return 1;
+}
+
 /**
  * @brief Main function for the Search Algorithm Performance Study program.
  *
@@ -167,8 +668,16 @@ std::vector<int> findClosestValues(const std::vector<int>& dataset, int target)
  * - Display closest values when search target isn't found
  * @return int Returns 0 on successful program termination
  */
-int main() {
+int main(int argc, char* argv[]) {
+    if (argc > 1) {
+        return runCommandLine(argc, argv); // Non-interactive modes such as "budget".
+    }
+
     std::vector<int> dataset; // This vector will hold our active dataset.
+    std::string dataset_name = "none"; // File name (or "generated") of the active dataset, for reports.
+    ProjectUtils::LoadMemoryReport load_memory; // Memory observed while the active dataset was loaded.
+    ProjectUtils::CrackerIndex cracker; // Unsorted column used by cracking mode (options 10 and 11).
+    const int cracking_metric_id = ProjectUtils::MetricsRegistry::global().algorithmId("cracking"); // Cracking searches are recorded under this label.
 
     // Gerson's main UI loop.
     int choice;
@@ -182,6 +691,19 @@ int main() {
         std::cout << "| 3. Search (Jump Search)                       |\n"; // Option to perform Jump Search.
         std::cout << "| 4. Search (Interpolation Search)              |\n"; // Option to perform Interpolation Search.
         std::cout << "| 5. Exit                                       |\n"; // Option to exit the program.
+        std::cout << "| 6. Search (Embedded 100k Random Table)        |\n"; // Option to search the build-time table.
+        std::cout << "| 7. Memory Report and Index Budget             |\n"; // Option to size indexes against a byte budget.
+        std::cout << "| 8. Sharded Search (Worker Processes)          |\n"; // Option to query a range-partitioned copy.
+        std::cout << "| 9. Set Operations with Another Dataset        |\n"; // Option to intersect/union/diff two datasets.
+        std::cout << "| 10. Load Dataset for Cracking (No Sort)       |\n"; // Option to load a file without sorting it.
+        std::cout << "| 11. Search (Cracking Mode)                    |\n"; // Option to search and crack the unsorted column.
+        std::cout << "| 12. Run Benchmark Suite                       |\n"; // Option to time every algorithm on one query set.
+        std::cout << "| 13. Run Update Benchmark (Learned Index)      |\n"; // Option to time inserts/deletes against reloading.
+        std::cout << "| 14. Simulate Cache Misses per Algorithm       |\n"; // Option to replay access traces through a cache model.
+        std::cout << "| 15. Hot-Key Cache Benchmark (Zipf Queries)    |\n"; // Option to time algorithms behind the front cache.
+        std::cout << "| 16. Approximate Queries (Rank/Count/Quantile) |\n"; // Option to answer from the load-time summary.
+        std::cout << "| 17. Show Metrics (Prometheus Text)            |\n"; // Option to print the load and lookup metrics.
+        std::cout << "| 18. Spatial Box Query (Morton Points)         |\n"; // Option to count the points of a file inside a box.
         std::cout << "-------------------------------------------------\n";
         std::cout << "Output:\n"; // Section for program output.
         std::cout << "> Enter choice: ";
@@ -200,6 +722,10 @@ int main() {
                 << "data\\data_100k_sorted_asc.txt\n"
                 << "data\\data_100k_sorted_desc.txt\n"
                 << "data\\data_100k_sparse.txt\n"
+                << "data\\data_adversarial_interpolation.txt\n"
+                << "data\\data_adversarial_jump.txt\n"
+                << "data\\data_adversarial_kary-interpolation.txt\n"
+                << "data\\data_adversarial_linear-model.txt\n"
                 << "data\\data_empty.txt\n"
                 << "data\\data_large_duplicates.txt\n"
                 << "data\\data_negative_numbers.txt\n"
@@ -209,14 +735,21 @@ int main() {
             // Then, prompt the user for input separately.
             std::cout << "> Enter filename: ";
             std::getline(std::cin, filename); // Read the full filename, including spaces if any.
-            ProjectUtils::loadAndSortDatasetFromFile(dataset, filename); // Call Blake's function to load and sort.
+            ProjectUtils::trackLoadPeakRss([&]() { // Record peak RSS while Blake's function loads and sorts.
+                return ProjectUtils::loadAndSortDatasetFromFile(dataset, filename);
+            }, load_memory);
+            dataset_name = filename;
         }
         else if (choice == 2) { // User chose to generate a random dataset.
             // Define default parameters for random dataset generation.
             const int DEFAULT_GEN_SIZE = 1000000;
             const int DEFAULT_MIN_VAL = 1;
             const int DEFAULT_MAX_VAL = 10000000;
-            ProjectUtils::generateAndSortDataset(dataset, DEFAULT_GEN_SIZE, DEFAULT_MIN_VAL, DEFAULT_MAX_VAL);
+            ProjectUtils::trackLoadPeakRss([&]() {
+                ProjectUtils::generateAndSortDataset(dataset, DEFAULT_GEN_SIZE, DEFAULT_MIN_VAL, DEFAULT_MAX_VAL);
+                return true;
+            }, load_memory);
+            dataset_name = "generated";
         }
         else if (choice == 3) { // User chose to perform Jump Search.
             // Check if a dataset is available before attempting to search.
@@ -224,16 +757,7 @@ int main() {
                 std::cout << "No dataset loaded! Please load or generate a dataset first.\n";
                 continue; // Go back to the main menu.
             }
-            int target;
-            std::cout << "> Enter value to search: ";
-            // --- Input validation for target ---
-            while (!(std::cin >> target)) { // Attempt to read integer. If fails...
-                std::cout << "Invalid input. Please enter a valid integer: ";
-                std::cin.clear(); // Clear the error flags on std::cin
-                // Discard invalid input from the buffer until a newline is found
-                std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-            }
-            std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n'); // Clear leftover newline
+            int target = promptForInteger("> Enter value to search: ");
 
             int found_idx; // Variable to store the index if the target is found.
             long long total_duration_us = 0;
@@ -246,6 +770,10 @@ int main() {
                     dataset, target, found_idx
                 );
             }
+            // The answer shown comes from one lookup through the metered index, so it is counted in the metrics like a served one.
+            std::unique_ptr<ProjectUtils::MeteredSearchIndex> index = ProjectUtils::createMeteredSearchIndex("jump");
+            index->build(dataset);
+            found_idx = index->search(target);
 
             long long average_duration_us = total_duration_us / NUM_RUNS;
 
@@ -274,16 +802,7 @@ int main() {
                 std::cout << "No dataset loaded! Please load or generate a dataset first.\n";
                 continue; // Go back to the main menu.
             }
-            int target;
-            std::cout << "> Enter value to search: ";
-            // --- Input validation for target ---
-            while (!(std::cin >> target)) { // Attempt to read integer. If fails...
-                std::cout << "Invalid input. Please enter a valid integer: ";
-                std::cin.clear(); // Clear the error flags on std::cin
-                // Discard invalid input from the buffer until a newline is found
-                std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
-            }
-            std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n'); // Clear leftover newline
+            int target = promptForInteger("> Enter value to search: ");
 
             int found_idx;
             long long total_duration_us = 0;
@@ -296,6 +815,10 @@ int main() {
                     dataset, target, found_idx
                 );
             }
+            // The answer shown comes from one lookup through the metered index, so it is counted in the metrics like a served one.
+            std::unique_ptr<ProjectUtils::MeteredSearchIndex> index = ProjectUtils::createMeteredSearchIndex("interpolation");
+            index->build(dataset);
+            found_idx = index->search(target);
 
             long long average_duration_us = total_duration_us / NUM_RUNS;
 
@@ -319,8 +842,279 @@ int main() {
         else if (choice == 5) { // User chose to exit the program.
             std::cout << "Exiting program. Goodbye!\n";
         }
+        else if (choice == 6) { // User chose to search the table embedded at build time.
+#ifdef HAVE_EMBEDDED_TABLES
+            typedef ProjectUtils::EmbeddedTables::Random100k Table;
+            int target = promptForInteger("> Enter value to search: ");
+
+            int found_idx = -1;
+            long long total_duration_ns = 0;
+            const int NUM_RUNS = 1000;
+
+            // The table is constexpr data, so there is no dataset to load before searching.
+            for (int i = 0; i < NUM_RUNS; ++i) {
+                auto start = std::chrono::high_resolution_clock::now();
+                found_idx = ProjectUtils::embeddedSearch<Table>(target);
+                auto end = std::chrono::high_resolution_clock::now();
+                total_duration_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+            }
+
+            if (found_idx != -1) {
+                std::cout << "Value " << target << " found at sorted index " << found_idx << ".\n";
+            }
+            else {
+                std::cout << "Value " << target << " not found.\n";
+            }
+            std::cout << "Embedded Table (" << ProjectUtils::searchLayoutName(Table::layout) << ", " << Table::size
+                << " keys) Average Time (over " << NUM_RUNS << " runs): " << total_duration_ns / NUM_RUNS << " ns\n";
+#else
+            std::cout << "No embedded tables in this build. Build with CMake to generate them.\n";
+#endif
+        }
+        else if (choice == 7) { // User chose to report memory use and pick indexes within a budget.
+            if (dataset.empty()) {
+                std::cout << "No dataset loaded! Please load or generate a dataset first.\n";
+                continue; // Go back to the main menu.
+            }
+            int budget_kb = promptForInteger("> Enter memory budget in KB (dataset plus indexes): ");
+            size_t budget_bytes = static_cast<size_t>(std::max(0, budget_kb)) * 1024;
+
+            ProjectUtils::MemoryBudgetManager manager;
+            manager.addDataset(dataset_name, dataset, 1.0, load_memory);
+            manager.profile();
+            size_t planned = manager.planPerDataset(budget_bytes);
+            manager.printReport(std::cout, budget_bytes, planned);
+        }
+        else if (choice == 8) { // User chose to query the dataset through range-partitioned worker processes.
+#if PROJECT_HAS_SHARDING
+            if (dataset.empty()) {
+                std::cout << "No dataset loaded! Please load or generate a dataset first.\n";
+                continue; // Go back to the main menu.
+            }
+            int num_shards = promptForInteger("> Enter number of shards: ");
+            ProjectUtils::ShardRouter router;
+            if (!router.start(dataset, num_shards)) {
+                continue;
+            }
+            std::cout << "Started " << router.shardCount() << " worker processes:\n";
+            router.printPartitions(std::cout);
+
+            int target = promptForInteger("> Enter value to search: ");
+            int found_idx = router.search(target);
+            if (found_idx != -1) {
+                std::cout << "Value " << target << " found at index " << found_idx << ".\n";
+            }
+            else {
+                std::cout << "Value " << target << " not found.\n";
+            }
+
+            int range_lo = promptForInteger("> Enter range start: ");
+            int range_hi = promptForInteger("> Enter range end: ");
+            std::vector<int> range_keys;
+            if (router.rangeQuery(range_lo, range_hi, range_keys)) {
+                std::cout << range_keys.size() << " keys in [" << range_lo << ", " << range_hi << "]";
+                if (!range_keys.empty()) {
+                    std::cout << ":";
+                    for (size_t i = 0; i < range_keys.size() && i < 10; ++i) std::cout << " " << range_keys[i];
+                    if (range_keys.size() > 10) std::cout << " ...";
+                }
+                std::cout << "\n";
+            }
+#else
+            std::cout << "Sharded mode needs fork() and Unix-domain sockets, which this platform does not provide.\n";
+#endif
+        }
+        else if (choice == 9) { // User chose to combine the active dataset with a second file.
+            if (dataset.empty()) {
+                std::cout << "No dataset loaded! Please load or generate a dataset first.\n";
+                continue; // Go back to the main menu.
+            }
+            std::string other_filename;
+            std::cout << "> Enter filename of the second dataset: ";
+            std::getline(std::cin, other_filename);
+            std::vector<int> other;
+            if (!ProjectUtils::loadAndSortDatasetFromFile(other, other_filename)) {
+                continue;
+            }
+
+            int op_choice = promptForInteger("> Operation (1 = intersection, 2 = union, 3 = difference active - second): ");
+            if (op_choice < 1 || op_choice > 3) {
+                std::cout << "Invalid operation.\n";
+                continue;
+            }
+            ProjectUtils::SetOperation op = static_cast<ProjectUtils::SetOperation>(op_choice - 1);
+            int threads = std::max(1, promptForInteger("> Number of threads: "));
+            int materialize = promptForInteger("> Replace the active dataset with the result? (1 = yes, 0 = count only): ");
+
+            std::vector<int> result;
+            auto start = std::chrono::high_resolution_clock::now();
+            size_t count = ProjectUtils::computeSetOperation(op, dataset, other, materialize == 1 ? &result : nullptr, threads);
+            auto end = std::chrono::high_resolution_clock::now();
+
+            std::cout << "The " << ProjectUtils::setOperationName(op) << " has " << count << " keys ("
+                << ProjectUtils::setOperationMethod(op, dataset.size(), other.size()) << ", " << threads << " thread(s), "
+                << std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() << " us).\n";
+            if (materialize == 1) {
+                dataset.swap(result);
+                dataset_name = ProjectUtils::setOperationName(op) + " result";
+                std::cout << "The result is now the active dataset.\n";
+            }
+        }
+        else if (choice == 10) { // User chose to load a file for cracking mode.
+            std::string filename;
+            std::cout << "> Enter filename: ";
+            std::getline(std::cin, filename);
+            std::vector<int> column;
+            auto start = std::chrono::high_resolution_clock::now();
+            if (!ProjectUtils::loadDatasetFromFile(column, filename)) {
+                continue;
+            }
+            cracker.load(std::move(column));
+            auto end = std::chrono::high_resolution_clock::now();
+            std::cout << "Loaded " << cracker.size() << " values from '" << filename << "' without sorting in "
+                << std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() << " us.\n";
+        }
+        else if (choice == 11) { // User chose to search the cracking-mode column.
+            if (cracker.size() == 0) {
+                std::cout << "No dataset loaded for cracking! Please use option 10 first.\n";
+                continue; // Go back to the main menu.
+            }
+            int target = promptForInteger("> Enter value to search: ");
+
+            // Time a single query: cracking changes the column, so repeated runs would time a different query.
+            auto start = std::chrono::high_resolution_clock::now();
+            int found_idx = cracker.search(target);
+            auto end = std::chrono::high_resolution_clock::now();
+            ProjectUtils::MetricsRegistry::global().recordQuery(cracking_metric_id, found_idx != -1,
+                static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count()));
+
+            if (found_idx != -1) {
+                std::cout << "Value " << target << " found at position " << found_idx << " of the cracked column.\n";
+            }
+            else {
+                std::cout << "Value " << target << " not found.\n";
+            }
+            std::cout << "Cracking Search Time: " << std::chrono::duration_cast<std::chrono::microseconds>(end - start).count()
+                << " us (column is now in " << cracker.pieceCount() << " pieces)\n";
+        }
+        else if (choice == 12) { // User chose to benchmark every algorithm on the active dataset.
+            if (dataset.empty()) {
+                std::cout << "No dataset loaded! Please load or generate a dataset first.\n";
+                continue; // Go back to the main menu.
+            }
+            ProjectUtils::printMachineProfile(ProjectUtils::machineProfile(), std::cout);
+            std::cout << ProjectUtils::simdKernelSummary() << "\n";
+            std::cout << "Benchmarking '" << dataset_name << "' (" << dataset.size() << " keys):\n";
+            ProjectUtils::printBenchmarkTable(ProjectUtils::runBenchmarkSuite(dataset), std::cout);
+            ProjectUtils::printRangeFilterReport(ProjectUtils::runRangeFilterBenchmark(dataset), std::cout);
+        }
+        else if (choice == 13) { // User chose to benchmark updates on the active dataset.
+            if (dataset.empty()) {
+                std::cout << "No dataset loaded! Please load or generate a dataset first.\n";
+                continue; // Go back to the main menu.
+            }
+            std::cout << "Update benchmark on '" << dataset_name << "' (" << dataset.size() << " keys):\n";
+            ProjectUtils::printUpdateBenchmarkTable(ProjectUtils::runUpdateBenchmark(dataset), std::cout);
+        }
+        else if (choice == 14) { // User chose to simulate the cache behaviour of each algorithm.
+            if (dataset.empty()) {
+                std::cout << "No dataset loaded! Please load or generate a dataset first.\n";
+                continue; // Go back to the main menu.
+            }
+            int num_queries = promptForInteger("> Enter number of queries to trace: ");
+            if (num_queries <= 0) {
+                std::cout << "Error: The number of queries must be positive.\n";
+                continue;
+            }
+            ProjectUtils::CacheModelConfig config; // Default hierarchy; the command-line mode can override it.
+            std::cout << "Cache simulation on '" << dataset_name << "' (" << dataset.size() << " keys):\n";
+            ProjectUtils::printCacheSimulationReport(ProjectUtils::runCacheSimulation(dataset, static_cast<size_t>(num_queries), config),
+                config, std::cout);
+        }
+        else if (choice == 15) { // User chose to benchmark the hot-key cache on skewed queries.
+            if (dataset.empty()) {
+                std::cout << "No dataset loaded! Please load or generate a dataset first.\n";
+                continue; // Go back to the main menu.
+            }
+            int capacity = promptForInteger("> Enter cache capacity (entries): ");
+            if (capacity <= 0) {
+                std::cout << "Error: The cache capacity must be positive.\n";
+                continue;
+            }
+            std::cout << "Hot-key cache on '" << dataset_name << "' (" << dataset.size() << " keys, Zipf skew 1.0):\n";
+            ProjectUtils::printHotCacheBenchmarkTable(ProjectUtils::runHotCacheBenchmark(dataset, 1.0, static_cast<size_t>(capacity)), std::cout);
+        }
+        else if (choice == 16) { // User chose an approximate rank, range-count or quantile query.
+            if (dataset.empty()) {
+                std::cout << "No dataset loaded! Please load or generate a dataset first.\n";
+                continue; // Go back to the main menu.
+            }
+            ProjectUtils::ApproximateSummary summary;
+            summary.build(dataset, 0.001); // Only samples every depth-th key, so rebuilding per query is cheap.
+            std::cout << "Summary of '" << dataset_name << "': " << summary.bucketCount() << " buckets of " << summary.bucketDepth()
+                << " keys (0.1% rank error).\n";
+            int kind = promptForInteger("> Query (1 = rank, 2 = range count, 3 = quantile in per mille): ");
+            if (kind == 1) {
+                int key = promptForInteger("> Enter value: ");
+                ProjectUtils::ApproximateAnswer answer = summary.rank(key);
+                std::cout << "Approximate rank: " << static_cast<long long>(answer.estimate + 0.5) << " (exact is in [" << answer.lower
+                    << ", " << answer.upper << "]); exact: " << summary.exactRank(key) << "\n";
+            }
+            else if (kind == 2) {
+                int lo = promptForInteger("> Enter lower bound: ");
+                int hi = promptForInteger("> Enter upper bound: ");
+                ProjectUtils::ApproximateAnswer answer = summary.rangeCount(lo, hi);
+                std::cout << "Approximate count: " << static_cast<long long>(answer.estimate + 0.5) << " (exact is in [" << answer.lower
+                    << ", " << answer.upper << "]); exact: " << summary.exactRangeCount(lo, hi) << "\n";
+            }
+            else if (kind == 3) {
+                int per_mille = promptForInteger("> Enter quantile (0-1000): ");
+                long long rank_error = 0;
+                int key = summary.quantile(per_mille / 1000.0, rank_error);
+                std::cout << "Approximate quantile: " << key << " (rank within " << rank_error << " of the target); exact: "
+                    << summary.exactQuantile(per_mille / 1000.0) << "\n";
+            }
+            else {
+                std::cout << "Invalid query type.\n";
+            }
+        }
+        else if (choice == 17) { // User chose to print the metrics recorded so far.
+            ProjectUtils::MetricsRegistry::global().writePrometheus(std::cout);
+        }
+        else if (choice == 18) { // User chose a bounding-box query on a point file.
+            std::string filename;
+            std::cout << "> Enter point filename (e.g. data\\data_points_100k.txt): ";
+            std::getline(std::cin, filename);
+            std::vector<ProjectUtils::Point2D> points;
+            if (!ProjectUtils::loadPointsFromFile(points, filename)) {
+                continue;
+            }
+            ProjectUtils::MortonPointIndex index;
+            index.build(points);
+            std::cout << "Loaded " << index.size() << " distinct points from '" << filename << "'.\n";
+            ProjectUtils::MortonBox box;
+            box.xmin = std::max(0, promptForInteger("> Enter min x: "));
+            box.ymin = std::max(0, promptForInteger("> Enter min y: "));
+            box.xmax = std::min(ProjectUtils::MORTON_COORD_MAX, promptForInteger("> Enter max x: "));
+            box.ymax = std::min(ProjectUtils::MORTON_COORD_MAX, promptForInteger("> Enter max y: "));
+            if (box.xmin > box.xmax || box.ymin > box.ymax) {
+                std::cout << "The box is empty.\n";
+                continue;
+            }
+            std::vector<ProjectUtils::Point2D> found;
+            int num_intervals = 0;
+            auto start = std::chrono::high_resolution_clock::now();
+            index.boxQuery(box, found, ProjectUtils::MORTON_MAX_INTERVALS, &num_intervals);
+            auto end = std::chrono::high_resolution_clock::now();
+            std::cout << found.size() << " points in the box (" << num_intervals << " Morton intervals, "
+                << std::chrono::duration_cast<std::chrono::microseconds>(end - start).count() << " us).\n";
+            for (size_t i = 0; i < found.size() && i < 10; ++i) {
+                std::cout << "  (" << found[i].x << ", " << found[i].y << ")\n";
+            }
+            if (found.size() > 10) std::cout << "  ...\n";
+        }
         else { // Invalid menu choice.
-            std::cout << "Invalid choice. Please enter a number between 1 and 5.\n";
+            std::cout << "Invalid choice. Please enter a number between 1 and 18.\n";
         }
     } while (choice != 5); // Continue the loop until the user chooses to exit (option 5).
 
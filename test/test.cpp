@@ -0,0 +1,213 @@
+#define CATCH_CONFIG_MAIN
+#include <catch2/catch.hpp>
+
+#include "SmallSearch.h"
+#include "RangeFilter.h"
+#include "DatasetDelta.h"
+#include "LearnedIndex.h"
+#include "SetOperations.h"
+#include "SearchApi.h"
+#include <vector>
+#include <set>
+#include <random>
+#include <climits>
+#include <cstdint>
+#include <cstdlib>
+#include <iterator>
+#include <algorithm>
+
+/*
+Property tests: each component is checked against a plain reference (std::lower_bound, std::set,
+the std::set_* algorithms or a brute-force scan) on seeded random data, so a failure is
+reproducible. Build with the Tests target and run through ctest.
+*/
+
+namespace {
+
+    // 'count' distinct keys drawn from [lo, hi], sorted.
+    std::vector<int> randomSortedKeys(std::mt19937& rng, size_t count, int lo, int hi) {
+        std::uniform_int_distribution<int> value(lo, hi);
+        std::set<int> keys;
+        while (keys.size() < count) keys.insert(value(rng));
+        return std::vector<int>(keys.begin(), keys.end());
+    }
+
+    // Drops and adds a few keys, so the result shares most of 'base'.
+    std::vector<int> mutateKeys(std::mt19937& rng, const std::vector<int>& base, int lo, int hi) {
+        std::set<int> keys(base.begin(), base.end());
+        std::uniform_int_distribution<size_t> pick(0, base.size() - 1);
+        std::uniform_int_distribution<int> value(lo, hi);
+        for (size_t i = 0; i < base.size() / 20; ++i) keys.erase(base[pick(rng)]);
+        for (size_t i = 0; i < base.size() / 20; ++i) keys.insert(value(rng));
+        return std::vector<int>(keys.begin(), keys.end());
+    }
+
+}
+
+TEST_CASE("smallLowerBound matches std::lower_bound", "[SmallSearch]") {
+    std::mt19937 rng(1);
+    for (int n = 0; n <= 300; ++n) {
+        std::vector<int> keys = randomSortedKeys(rng, static_cast<size_t>(n), -1000, 1000);
+        std::uniform_int_distribution<int> value(-1100, 1100);
+        for (int q = 0; q < 50; ++q) {
+            int target = q == 0 ? INT_MIN : q == 1 ? INT_MAX : value(rng);
+            int expected = static_cast<int>(std::lower_bound(keys.begin(), keys.end(), target) - keys.begin());
+            REQUIRE(ProjectUtils::smallLowerBound(keys.data(), n, target) == expected);
+            REQUIRE(ProjectUtils::smallLowerBoundOver(keys.data(), 0, n, target) == expected);
+            if (n <= ProjectUtils::SMALL_SEARCH_MAX) {
+                int found = (expected < n && keys[expected] == target) ? expected : -1;
+                REQUIRE(ProjectUtils::smallSearch(keys.data(), n, target) == found);
+            }
+        }
+    }
+}
+
+TEST_CASE("RangeFilter has no false negatives", "[RangeFilter]") {
+    std::mt19937 rng(2);
+    struct Shape { size_t keys; int lo; int hi; double max_bits_per_key; };
+    // Dense (exact bitmap), sparse uncapped, sparse with a cap too small for the target, and negative keys.
+    const Shape shapes[] = { { 20000, 1, 200000, ProjectUtils::RANGE_FILTER_UNCAPPED }, { 20000, 0, INT_MAX, ProjectUtils::RANGE_FILTER_UNCAPPED },
+        { 20000, 0, INT_MAX, 12.0 }, { 5000, INT_MIN, INT_MAX, ProjectUtils::RANGE_FILTER_UNCAPPED } };
+    for (const Shape& shape : shapes) {
+        std::vector<int> keys = randomSortedKeys(rng, shape.keys, shape.lo, shape.hi);
+        ProjectUtils::RangeFilter filter;
+        filter.build(keys, 0.01, shape.max_bits_per_key);
+        std::uniform_int_distribution<size_t> pick(0, keys.size() - 1);
+        std::uniform_int_distribution<long long> width(0, 1LL << 20);
+        for (int q = 0; q < 20000; ++q) {
+            // A range around a present key must always pass.
+            int key = keys[pick(rng)];
+            int lo = static_cast<int>(std::max<long long>(INT_MIN, key - width(rng) % 4096));
+            int hi = static_cast<int>(std::min<long long>(INT_MAX, key + width(rng)));
+            REQUIRE(filter.mayContain(lo, hi));
+            REQUIRE(filter.mayContain(key));
+        }
+        // Ranges outside the keys are rejected outright.
+        if (keys.back() < INT_MAX) REQUIRE_FALSE(filter.mayContain(keys.back() + 1, INT_MAX));
+        if (keys.front() > INT_MIN) REQUIRE_FALSE(filter.mayContain(INT_MIN, keys.front() - 1));
+        if (shape.max_bits_per_key == ProjectUtils::RANGE_FILTER_UNCAPPED) REQUIRE(filter.meetsTarget());
+    }
+}
+
+TEST_CASE("Dataset deltas round-trip and apply to the target", "[DatasetDelta]") {
+    std::mt19937 rng(3);
+    for (int round = 0; round < 20; ++round) {
+        std::vector<int> base = randomSortedKeys(rng, 1000 + static_cast<size_t>(round) * 500, -50000, 50000);
+        std::vector<int> target = mutateKeys(rng, base, -50000, 50000);
+        ProjectUtils::DatasetDelta delta = ProjectUtils::diffDatasets(base, target);
+        REQUIRE(delta.insertedCount() + base.size() == delta.deletedCount() + target.size());
+
+        std::vector<uint8_t> bytes = ProjectUtils::encodeDatasetDelta(delta);
+        ProjectUtils::DatasetDelta decoded;
+        REQUIRE(ProjectUtils::decodeDatasetDelta(bytes.data(), bytes.size(), decoded));
+        REQUIRE(decoded.keys == delta.keys);
+        REQUIRE(decoded.runs.size() == delta.runs.size());
+        for (size_t i = 0; i < delta.runs.size(); ++i) {
+            REQUIRE(decoded.runs[i].inserted == delta.runs[i].inserted);
+            REQUIRE(decoded.runs[i].length == delta.runs[i].length);
+        }
+        REQUIRE(decoded.target_checksum == ProjectUtils::datasetChecksum(target));
+
+        std::vector<int> patched = base;
+        REQUIRE(ProjectUtils::applyDatasetDelta(decoded, patched));
+        REQUIRE(patched == target);
+    }
+}
+
+TEST_CASE("Threaded diff equals the single-threaded diff", "[DatasetDelta]") {
+    std::mt19937 rng(4);
+    std::vector<int> base = randomSortedKeys(rng, 200000, 0, 10000000);
+    std::vector<int> target = mutateKeys(rng, base, 0, 10000000);
+    std::vector<uint8_t> single = ProjectUtils::encodeDatasetDelta(ProjectUtils::diffDatasets(base, target, 1));
+    for (int threads : { 2, 3, 4, 8 }) {
+        REQUIRE(ProjectUtils::encodeDatasetDelta(ProjectUtils::diffDatasets(base, target, threads)) == single);
+    }
+}
+
+TEST_CASE("UpdatableLearnedIndex matches std::set under inserts and erases", "[LearnedIndex]") {
+    std::mt19937 rng(5);
+    std::vector<int> initial = randomSortedKeys(rng, 20000, 0, 1000000);
+    std::set<int> reference(initial.begin(), initial.end());
+    ProjectUtils::UpdatableLearnedIndex index;
+    index.bulkLoad(initial);
+    std::uniform_int_distribution<int> value(-1000, 1001000);
+    std::uniform_int_distribution<int> op(0, 2);
+    for (int i = 0; i < 100000; ++i) {
+        int key = value(rng);
+        switch (op(rng)) {
+            case 0: REQUIRE(index.insert(key) == reference.insert(key).second); break;
+            case 1: REQUIRE(index.erase(key) == (reference.erase(key) == 1)); break;
+            default: REQUIRE(index.contains(key) == (reference.count(key) == 1)); break;
+        }
+    }
+    REQUIRE(index.size() == reference.size());
+
+    std::vector<int> all;
+    index.rangeScan(INT_MIN, INT_MAX, all);
+    REQUIRE(all == std::vector<int>(reference.begin(), reference.end()));
+    for (int q = 0; q < 200; ++q) {
+        int lo = value(rng), hi = lo + value(rng) % 5000;
+        std::vector<int> scanned;
+        index.rangeScan(lo, hi, scanned);
+        REQUIRE(scanned == std::vector<int>(reference.lower_bound(lo), reference.upper_bound(hi)));
+    }
+}
+
+TEST_CASE("Set operations match the std::set_* algorithms", "[SetOperations]") {
+    std::mt19937 rng(6);
+    // Similar sizes take the merge paths, very different sizes the galloping ones.
+    const size_t sizes[][2] = { { 50000, 50000 }, { 100000, 300 }, { 7, 80000 }, { 0, 1000 }, { 3000, 3000 } };
+    for (const auto& size : sizes) {
+        std::vector<int> a = randomSortedKeys(rng, size[0], 0, 400000);
+        std::vector<int> b = randomSortedKeys(rng, size[1], 0, 400000);
+        std::vector<int> expected_intersection, expected_union, expected_difference;
+        std::set_intersection(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expected_intersection));
+        std::set_union(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expected_union));
+        std::set_difference(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(expected_difference));
+        for (int threads : { 1, 4 }) {
+            std::vector<int> result;
+            REQUIRE(ProjectUtils::computeSetOperation(ProjectUtils::SetOperation::Intersection, a, b, &result, threads) == expected_intersection.size());
+            REQUIRE(result == expected_intersection);
+            REQUIRE(ProjectUtils::computeSetOperation(ProjectUtils::SetOperation::Union, a, b, &result, threads) == expected_union.size());
+            REQUIRE(result == expected_union);
+            REQUIRE(ProjectUtils::computeSetOperation(ProjectUtils::SetOperation::Difference, a, b, &result, threads) == expected_difference.size());
+            REQUIRE(result == expected_difference);
+        }
+    }
+}
+
+TEST_CASE("edr_index_nearest matches a brute-force scan", "[SearchApi]") {
+    std::mt19937 rng(7);
+    std::vector<int32_t> keys;
+    for (int key : randomSortedKeys(rng, 5000, -100000, 100000)) keys.push_back(key);
+    edr_dataset* dataset = nullptr;
+    REQUIRE(edr_dataset_create(keys.data(), keys.size(), &dataset) == EDR_OK);
+
+    std::vector<int64_t> order(keys.size());
+    std::uniform_int_distribution<int32_t> value(-110000, 110000);
+    for (size_t name = 0; name < edr_index_name_count(); ++name) {
+        INFO("index " << edr_index_name(name));
+        edr_index* index = nullptr;
+        REQUIRE(edr_index_create(dataset, edr_index_name(name), &index) == EDR_OK);
+        for (int q = 0; q < 300; ++q) {
+            int32_t target = q % 10 == 0 ? keys[static_cast<size_t>(q) % keys.size()] : value(rng);
+            size_t k = static_cast<size_t>(q % 12);
+            if (q == 1) k = keys.size() + 5;
+
+            // Nearest first; ties go to the smaller key.
+            for (size_t i = 0; i < order.size(); ++i) order[i] = static_cast<int64_t>(i);
+            std::stable_sort(order.begin(), order.end(), [&](int64_t x, int64_t y) {
+                return std::llabs(static_cast<long long>(keys[x]) - target) < std::llabs(static_cast<long long>(keys[y]) - target);
+            });
+            size_t expected = std::min(k, keys.size());
+
+            std::vector<int64_t> positions(k + 1, -2);
+            size_t written = 0;
+            REQUIRE(edr_index_nearest(index, target, k, positions.data(), &written) == EDR_OK);
+            REQUIRE(written == expected);
+            for (size_t i = 0; i < expected; ++i) REQUIRE(positions[i] == order[i]);
+        }
+        edr_index_destroy(index);
+    }
+    edr_dataset_destroy(dataset);
+}